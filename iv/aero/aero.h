@@ -14,6 +14,10 @@
 #include <iv/aero/code.h>
 #include <iv/aero/compiler.h>
 #include <iv/aero/quick_check.h>
+#include <iv/aero/automaton_check.h>
+#include <iv/aero/literal_check.h>
+#include <iv/aero/required_literal.h>
+#include <iv/aero/pike_vm.h>
 #include <iv/aero/vm.h>
 #include <iv/aero/jit_fwd.h>
 #include <iv/aero/jit.h>
@@ -0,0 +1,446 @@
+// AutomatonCheck
+//
+// decides whether a pattern is executed by PikeVM instead of the
+// backtracking engines. the pattern must not have back references and
+// lookarounds, and bodies of repeated terms must not match the empty string.
+// since PikeVM is slower than the JIT code for usual inputs, the automaton is
+// selected only when backtracking may take exponential time.
+//
+// backtracking takes exponential time when the pattern is exponentially
+// ambiguous, that is, some input is read from a state back to the same state
+// along two different paths. /(a+)+/ reads "aa" in two ways in each
+// iteration, but /(\d{1,3}\.){3}/ and /(?:([a-z]|[a-z][-a-z]*[a-z])\.)*/ read
+// any input in at most one way. to check it, the position automaton
+// (Glushkov automaton) of the pattern is built, which has a state for each
+// character atom, and the pair graph of it is searched. the pattern is
+// exponentially ambiguous if a strongly connected component of the pair graph
+// has a pair of the same states and a pair of different states, or has two
+// pairs of the same states joined by a duplicated transition.
+// assertions are treated as the empty string and characters with cases are
+// treated as overlapping in ignore case patterns. both only make the check
+// conservative.
+#ifndef IV_AERO_AUTOMATON_CHECK_H_
+#define IV_AERO_AUTOMATON_CHECK_H_
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <iv/detail/cstdint.h>
+#include <iv/aero/visitor.h>
+#include <iv/aero/ast.h>
+#include <iv/aero/range.h>
+namespace iv {
+namespace aero {
+
+class AutomatonCheck : private Visitor {
+ public:
+  // counters are expanded in the automaton code, so code size is limited
+  static const uint64_t kMaxExpandedSize = 1024;
+
+  // the pair graph has kMaxPositions^2 states.
+  // larger patterns are left to the backtracking engines
+  static const std::size_t kMaxPositions = 256;
+
+  // pair graph transitions searched at most
+  static const uint64_t kMaxSteps = 1 << 22;
+
+  AutomatonCheck(uint32_t max_captures, bool ignore_case)
+    : max_captures_(max_captures),
+      ignore_case_(ignore_case),
+      executable_(true),
+      size_(0),
+      fragment_(),
+      labels_(),
+      follows_() {
+  }
+
+  bool Check(Disjunction* dis) {
+    Visit(dis);
+    return executable_ &&
+        size_ <= kMaxExpandedSize &&
+        labels_.size() <= kMaxPositions &&
+        IsExponentiallyAmbiguous();
+  }
+
+ private:
+  typedef std::vector<Range> Label;
+  typedef std::vector<uint32_t> Positions;
+
+  // first and last positions of the sub pattern
+  struct Fragment {
+    Fragment() : first(), last(), nullable(true) { }
+    Positions first;
+    Positions last;
+    bool nullable;
+  };
+
+  void Visit(Disjunction* dis) {
+    Fragment result;
+    result.nullable = false;
+    uint64_t size = 0;
+    for (Alternatives::const_iterator it = dis->alternatives().begin(),
+         last = dis->alternatives().end(); it != last; ++it) {
+      Visit(*it);
+      Append(&result.first, fragment_.first);
+      Append(&result.last, fragment_.last);
+      result.nullable = result.nullable || fragment_.nullable;
+      size += size_;
+    }
+    Set(result, size);
+  }
+
+  void Visit(Alternative* alt) {
+    Fragment result;
+    uint64_t size = 0;
+    for (Expressions::const_iterator it = alt->terms().begin(),
+         last = alt->terms().end(); it != last; ++it) {
+      (*it)->Accept(this);
+      result = Concat(result, fragment_);
+      size += size_;
+    }
+    Set(result, size);
+  }
+
+  void Visit(HatAssertion* assertion) {
+    Set(Fragment(), 1);
+  }
+
+  void Visit(DollarAssertion* assertion) {
+    Set(Fragment(), 1);
+  }
+
+  void Visit(EscapedAssertion* assertion) {
+    Set(Fragment(), 1);
+  }
+
+  void Visit(DisjunctionAssertion* assertion) {
+    executable_ = false;
+    Set(Fragment(), 1);
+  }
+
+  void Visit(BackReferenceAtom* atom) {
+    if (atom->reference() < max_captures_) {
+      executable_ = false;
+      Set(Fragment(), 1);
+    } else {
+      // treated as characters
+      Set(NewPosition(Label(1, Range(0, 0xFFFF))), 4);
+    }
+  }
+
+  void Visit(CharacterAtom* atom) {
+    Set(NewPosition(Label(1, Range(atom->character(), atom->character()))),
+        1);
+  }
+
+  void Visit(StringAtom* atom) {
+    Fragment result;
+    for (StringAtom::String::const_iterator it = atom->string().begin(),
+         last = atom->string().end(); it != last; ++it) {
+      result = Concat(result, NewPosition(Label(1, Range(*it, *it))));
+    }
+    Set(result, atom->string().size());
+  }
+
+  void Visit(RangeAtom* atom) {
+    Label label(atom->ranges().begin(), atom->ranges().end());
+    std::sort(label.begin(), label.end());
+    if (atom->inverted()) {
+      Label inverted;
+      uint32_t start = 0;
+      for (Label::const_iterator it = label.begin(),
+           last = label.end(); it != last; ++it) {
+        if (start < it->first) {
+          inverted.push_back(Range(start, it->first - 1));
+        }
+        start = std::max<uint32_t>(start, it->second + 1);
+      }
+      if (start <= 0xFFFF) {
+        inverted.push_back(Range(start, 0xFFFF));
+      }
+      label.swap(inverted);
+    }
+    Set(NewPosition(label), 1);
+  }
+
+  void Visit(DisjunctionAtom* atom) {
+    Visit(atom->disjunction());
+  }
+
+  void Visit(Quantifiered* atom) {
+    atom->expression()->Accept(this);
+    if (atom->max() == 0) {
+      Set(Fragment(), 1);
+      return;
+    }
+    const Fragment body = fragment_;
+    const uint64_t size = size_;
+    const bool repeated = atom->max() > 1;
+    if (repeated && atom->min() != atom->max() && body.nullable) {
+      // loop body matching the empty string needs POSITION_TEST
+      executable_ = false;
+    }
+    const uint64_t count = (atom->max() == kRegExpInfinity) ?
+        atom->min() + 1 : atom->max();
+
+    // positions of the expanded body as the automaton code,
+    // x{2,} is x x x* and x{1,3} is x (?:x (?:x)?)?
+    Fragment result;
+    for (int32_t i = 0; i < atom->min() && !IsTooLarge(); ++i) {
+      result = Concat(result, (i == 0) ? body : Copy(atom));
+    }
+    if (atom->max() == kRegExpInfinity) {
+      Fragment loop = (atom->min() == 0) ? body : Copy(atom);
+      Connect(loop, loop);
+      loop.nullable = true;
+      result = Concat(result, loop);
+    } else {
+      Fragment following;
+      for (int32_t i = atom->min(); i < atom->max() && !IsTooLarge(); ++i) {
+        following = Concat((i == 0) ? body : Copy(atom), following);
+        following.nullable = true;
+      }
+      result = Concat(result, following);
+    }
+    Set(result, std::min(size * count, kMaxExpandedSize + 1));
+  }
+
+  // visits the body again for a new copy of its positions
+  Fragment Copy(Quantifiered* atom) {
+    atom->expression()->Accept(this);
+    return fragment_;
+  }
+
+  Fragment NewPosition(const Label& label) {
+    Fragment result;
+    if (!IsTooLarge()) {
+      result.first.push_back(labels_.size());
+      result.last.push_back(labels_.size());
+      labels_.push_back(label);
+      follows_.push_back(Positions());
+    }
+    result.nullable = false;
+    return result;
+  }
+
+  Fragment Concat(const Fragment& lhs, const Fragment& rhs) {
+    Connect(lhs, rhs);
+    Fragment result;
+    result.first = lhs.first;
+    if (lhs.nullable) {
+      Append(&result.first, rhs.first);
+    }
+    result.last = rhs.last;
+    if (rhs.nullable) {
+      Append(&result.last, lhs.last);
+    }
+    result.nullable = lhs.nullable && rhs.nullable;
+    return result;
+  }
+
+  // transitions are not unified. the same transition added twice means
+  // the pattern has two paths between the positions
+  void Connect(const Fragment& from, const Fragment& to) {
+    for (Positions::const_iterator it = from.last.begin(),
+         last = from.last.end(); it != last; ++it) {
+      Append(&follows_[*it], to.first);
+    }
+  }
+
+  static void Append(Positions* positions, const Positions& rhs) {
+    positions->insert(positions->end(), rhs.begin(), rhs.end());
+  }
+
+  bool IsTooLarge() const {
+    return labels_.size() > kMaxPositions;
+  }
+
+  void Set(const Fragment& fragment, uint64_t size) {
+    fragment_ = fragment;
+    size_ = size;
+  }
+
+  bool Overlap(const Label& lhs, const Label& rhs) const {
+    if (ignore_case_ && HasCase(lhs) && HasCase(rhs)) {
+      return true;
+    }
+    Label::const_iterator l = lhs.begin();
+    Label::const_iterator r = rhs.begin();
+    while (l != lhs.end() && r != rhs.end()) {
+      if (l->second < r->first) {
+        ++l;
+      } else if (r->second < l->first) {
+        ++r;
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool HasCase(const Label& label) {
+    for (Label::const_iterator it = label.begin(),
+         last = label.end(); it != last; ++it) {
+      if (it->second >= 'A') {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // searches strongly connected components of the pair graph reachable from
+  // pairs of the same states by Tarjan's algorithm
+  bool IsExponentiallyAmbiguous() {
+    const std::size_t size = labels_.size();
+    std::vector<bool> overlaps(size * size);
+    for (std::size_t p = 0; p < size; ++p) {
+      for (std::size_t q = p; q < size; ++q) {
+        overlaps[p * size + q] = overlaps[q * size + p] =
+            Overlap(labels_[p], labels_[q]);
+      }
+    }
+    const uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> index(size * size, kUnvisited);
+    std::vector<uint32_t> low(size * size);
+    std::vector<bool> on_stack(size * size);
+    std::vector<uint32_t> stack;
+    std::vector<Frame> frames;
+    uint32_t counter = 0;
+    uint64_t steps = 0;
+    for (std::size_t start = 0; start < size; ++start) {
+      const uint32_t root = start * size + start;
+      if (index[root] != kUnvisited) {
+        continue;
+      }
+      frames.push_back(Frame(root));
+      index[root] = low[root] = counter++;
+      stack.push_back(root);
+      on_stack[root] = true;
+      while (!frames.empty()) {
+        Frame& frame = frames.back();
+        const uint32_t p = frame.node / size;
+        const uint32_t q = frame.node % size;
+        bool pushed = false;
+        if (follows_[q].empty()) {
+          frame.i = follows_[p].size();
+        }
+        while (frame.i < follows_[p].size()) {
+          if (++steps > kMaxSteps) {
+            return false;
+          }
+          const uint32_t np = follows_[p][frame.i];
+          const uint32_t nq = follows_[q][frame.j];
+          if (++frame.j == follows_[q].size()) {
+            frame.j = 0;
+            ++frame.i;
+          }
+          if (!overlaps[np * size + nq]) {
+            continue;
+          }
+          const uint32_t next = np * size + nq;
+          if (index[next] == kUnvisited) {
+            index[next] = low[next] = counter++;
+            stack.push_back(next);
+            on_stack[next] = true;
+            frames.push_back(Frame(next));
+            pushed = true;
+            break;
+          }
+          if (on_stack[next]) {
+            low[frame.node] = std::min(low[frame.node], index[next]);
+          }
+        }
+        if (pushed) {
+          continue;
+        }
+        const uint32_t node = frame.node;
+        frames.pop_back();
+        if (!frames.empty()) {
+          low[frames.back().node] =
+              std::min(low[frames.back().node], low[node]);
+        }
+        if (low[node] != index[node]) {
+          continue;
+        }
+        // pop the component
+        std::vector<uint32_t> component;
+        uint32_t member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          on_stack[member] = false;
+          component.push_back(member);
+        } while (member != node);
+        if (IsAmbiguousComponent(component, size)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool IsAmbiguousComponent(std::vector<uint32_t> component,
+                            std::size_t size) const {
+    if (component.size() == 1 &&
+        !HasDuplicatedLoop(component.front() / size)) {
+      return false;
+    }
+    bool same = false;
+    bool different = false;
+    for (std::vector<uint32_t>::const_iterator it = component.begin(),
+         last = component.end(); it != last; ++it) {
+      if (*it / size == *it % size) {
+        same = true;
+      } else {
+        different = true;
+      }
+    }
+    if (!same) {
+      return false;
+    }
+    if (different) {
+      return true;
+    }
+    // duplicated transitions between the same states pairs
+    std::sort(component.begin(), component.end());
+    for (std::vector<uint32_t>::const_iterator it = component.begin(),
+         last = component.end(); it != last; ++it) {
+      Positions follow = follows_[*it / size];
+      std::sort(follow.begin(), follow.end());
+      for (std::size_t i = 1; i < follow.size(); ++i) {
+        if (follow[i - 1] == follow[i] &&
+            std::binary_search(component.begin(), component.end(),
+                               follow[i] * size + follow[i])) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool HasDuplicatedLoop(uint32_t position) const {
+    return std::count(follows_[position].begin(),
+                      follows_[position].end(), position) > 1;
+  }
+
+  struct Frame {
+    explicit Frame(uint32_t n) : node(n), i(0), j(0) { }
+    uint32_t node;
+    std::size_t i;
+    std::size_t j;
+  };
+
+  uint32_t max_captures_;
+  bool ignore_case_;
+  bool executable_;
+
+  // result of the last visited node
+  uint64_t size_;
+  Fragment fragment_;
+
+  // position automaton
+  std::vector<Label> labels_;
+  std::vector<Positions> follows_;
+};
+
+} }  // namespace iv::aero
+#endif  // IV_AERO_AUTOMATON_CHECK_H_
@@ -1,5 +1,6 @@
 #ifndef IV_AERO_CHARACTER_H_
 #define IV_AERO_CHARACTER_H_
+#include <cstddef>
 #include <iv/character.h>
 namespace iv {
 namespace aero {
@@ -41,5 +42,23 @@ inline bool IsWord(int ch) {
   return core::character::IsASCIIAlphanumeric(ch) || ch == '_';
 }
 
+template<typename Piece>
+inline bool IsWordSeparatorPrev(const Piece& subject,
+                                std::size_t current_position) {
+  if (current_position == 0 || current_position > subject.size()) {
+    return false;
+  }
+  return IsWord(subject[current_position - 1]);
+}
+
+template<typename Piece>
+inline bool IsWordSeparator(const Piece& subject,
+                            std::size_t current_position) {
+  if (current_position >= subject.size()) {
+    return false;
+  }
+  return IsWord(subject[current_position]);
+}
+
 } } }  // namespace iv::aero::character
 #endif  // IV_AERO_CHARACTER_H_
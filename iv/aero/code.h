@@ -11,6 +11,7 @@ namespace aero {
 static const int kUndefined = -1;
 
 class SimpleCase;
+class RequiredLiteral;
 
 class Code {
  public:
@@ -19,14 +20,17 @@ class Code {
   Code(const std::vector<uint8_t>& vec,
        int flags,
        int captures, int counters, uint16_t filter, bool one_char,
-       std::shared_ptr<SimpleCase> simple)
+       std::shared_ptr<SimpleCase> simple, bool automaton = false,
+       std::shared_ptr<RequiredLiteral> literal = nullptr)
     : bytes_(vec),
       flags_(flags),
       captures_(captures),
       counters_(counters),
       filter_(filter),
       one_char_(one_char),
-      simple_(simple)
+      automaton_(automaton),
+      simple_(simple),
+      literal_(literal)
 #if defined(IV_ENABLE_JIT)
       ,
       jit_(new JITCode())
@@ -45,8 +49,13 @@ class Code {
 
   bool IsQuickCheckOneChar() const { return one_char_; }
 
+  // executed by PikeVM
+  bool automaton() const { return automaton_; }
+
   const SimpleCase* simple() const { return simple_.get(); }
 
+  const RequiredLiteral* literal() const { return literal_.get(); }
+
   bool IsIgnoreCase() const { return flags_ & IGNORE_CASE; }
 
   bool IsMultiline() const { return flags_ & MULTILINE; }
@@ -58,7 +67,9 @@ class Code {
   int counters_;
   uint16_t filter_;
   bool one_char_;
+  bool automaton_;
   std::shared_ptr<SimpleCase> simple_;
+  std::shared_ptr<RequiredLiteral> literal_;
 #if defined(IV_ENABLE_JIT)
   std::unique_ptr<JITCode> jit_;
  public:
@@ -12,6 +12,9 @@
 #include <iv/aero/code.h>
 #include <iv/aero/captures.h>
 #include <iv/aero/quick_check_fwd.h>
+#include <iv/aero/automaton_check.h>
+#include <iv/aero/literal_check.h>
+#include <iv/aero/required_literal.h>
 #include <iv/aero/simple_case.h>
 namespace iv {
 namespace aero {
@@ -38,12 +41,17 @@ class Compiler : private Visitor {
       current_captures_num_(),
       jmp_(),
       counters_(),
-      counters_size_(0) {
+      counters_size_(0),
+      automaton_(false) {
   }
 
   Code* Compile(const ParsedData& data) {
     max_captures_ = data.max_captures();
     current_captures_num_ = 0;
+    automaton_ =
+        AutomatonCheck(max_captures_, IsIgnoreCase()).Check(data.pattern());
+    LiteralCheck literal(IsIgnoreCase());
+    literal.Check(data.pattern());
     const std::pair<uint16_t, std::size_t> ret = EmitQuickCheck(data);
     const uint16_t filter = ret.first;
     data.pattern()->Accept(this);
@@ -56,12 +64,15 @@ class Compiler : private Visitor {
         counters_size_,
         filter,
         one_char,
-        SimpleCase::New(data, IsIgnoreCase()));
+        SimpleCase::New(literal),
+        automaton_,
+        RequiredLiteral::New(literal));
   }
 
   uint32_t counters_size() const { return counters_size_; }
   bool IsIgnoreCase() const { return flags_ & IGNORE_CASE; }
   bool IsMultiline() const { return flags_ & MULTILINE; }
+  bool IsAutomaton() const { return automaton_; }
 
  private:
   std::pair<uint16_t, std::size_t> EmitQuickCheck(const ParsedData& data) {
@@ -192,6 +203,13 @@ class Compiler : private Visitor {
   }
 
   void Visit(StringAtom* atom) {
+    if (IsAutomaton()) {
+      // PikeVM consumes one character at a time
+      for (char16_t ch : atom->string()) {
+        EmitCharacter(ch);
+      }
+      return;
+    }
     Emit<OP::CHECK_N_CHARS>();
     Emit4(atom->string().size());
     for (char16_t ch : atom->string()) {
@@ -327,6 +345,14 @@ class Compiler : private Visitor {
   void EmitFixed(Quantifiered* atom, int32_t fixed, uint32_t capture) {
     if (fixed == 1) {
       atom->expression()->Accept(this);
+    } else if (IsAutomaton()) {
+      // counters are not used in automaton. expand the body
+      const uint32_t now = current_captures_num_;
+      for (int32_t i = 0; i < fixed; ++i) {
+        current_captures_num_ = now;
+        EmitClearCaptures(capture);
+        atom->expression()->Accept(this);
+      }
     } else {
       const CounterHolder holder(this);
       // COUNTER_ZERO | COUNTER_TARGET
@@ -385,6 +411,32 @@ class Compiler : private Visitor {
   void EmitFollowingRepeat(Quantifiered* atom, int32_t max, uint32_t capture) {
     if (max == kRegExpInfinity) {
       EmitInfinity(atom, capture);
+    } else if (IsAutomaton()) {
+      // counters are not used in automaton.
+      // x{0,3} is expanded to (?:x(?:x(?:x)?)?)?
+      // body always consumes characters, so POSITION_TEST is not needed
+      const uint32_t now = current_captures_num_;
+      std::vector<std::size_t> exits;
+      for (int32_t i = 0; i < max; ++i) {
+        current_captures_num_ = now;
+        Emit<OP::PUSH_BACKTRACK>();
+        const std::size_t pos1 = Current();
+        Emit4(0u);  // dummy
+        if (atom->greedy()) {
+          exits.push_back(pos1);
+        } else {
+          Emit<OP::JUMP>();
+          exits.push_back(Current());
+          Emit4(0u);  // dummy
+          Emit4At(pos1, Current());
+        }
+        EmitClearCaptures(capture);
+        atom->expression()->Accept(this);
+      }
+      for (std::vector<std::size_t>::const_iterator it = exits.begin(),
+           last = exits.end(); it != last; ++it) {
+        Emit4At(*it, Current());
+      }
     } else {
       const CounterHolder holder(this);
       const CounterHolder pos_holder(this);
@@ -497,6 +549,7 @@ class Compiler : private Visitor {
   std::vector<std::size_t> jmp_;
   std::unordered_set<uint32_t> counters_;
   uint32_t counters_size_;
+  bool automaton_;
 };
 
 inline Code* Compile(core::Space* space,
@@ -0,0 +1,236 @@
+// LiteralCheck
+//
+// extracts the longest literal which every match must contain.
+// for each node, the literal the match starts with (prefix), ends with
+// (suffix) and contains anywhere (best) are computed. if the node always
+// matches the same string, the node is exact and these are that string.
+// zero width assertions are exact with the empty string, so they do not break
+// literals. ignore case patterns have no literal.
+#ifndef IV_AERO_LITERAL_CHECK_H_
+#define IV_AERO_LITERAL_CHECK_H_
+#include <string>
+#include <algorithm>
+#include <iv/detail/cstdint.h>
+#include <iv/aero/visitor.h>
+#include <iv/aero/ast.h>
+namespace iv {
+namespace aero {
+
+class LiteralCheck : private Visitor {
+ public:
+  // literals longer than this are truncated
+  static const std::size_t kMaxLiteralSize = 256;
+
+  explicit LiteralCheck(bool ignore_case)
+    : ignore_case_(ignore_case),
+      pure_(true),
+      info_() {
+  }
+
+  void Check(Disjunction* dis) {
+    if (ignore_case_) {
+      pure_ = false;
+      info_ = Info();
+      return;
+    }
+    Visit(dis);
+    if (info_.prefix.size() >= info_.best.size()) {
+      info_.best = info_.prefix;
+    }
+  }
+
+  // required literal of the pattern
+  const std::u16string& literal() const { return info_.best; }
+
+  // every match starts with the literal
+  bool IsPrefix() const {
+    return !info_.best.empty() && info_.best == info_.prefix;
+  }
+
+  // pattern is the literal itself.
+  // it has no assertions and no captures, so it can be matched by search
+  bool IsPure() const { return pure_ && info_.exact; }
+
+ private:
+  struct Info {
+    Info() : exact(false), prefix(), suffix(), best() { }
+
+    explicit Info(const std::u16string& str)
+      : exact(true), prefix(str), suffix(str), best(str) { }
+
+    bool exact;
+    std::u16string prefix;
+    std::u16string suffix;
+    std::u16string best;
+  };
+
+  void Visit(Disjunction* dis) {
+    Alternatives::const_iterator it = dis->alternatives().begin();
+    const Alternatives::const_iterator last = dis->alternatives().end();
+    assert(it != last);
+    Visit(*it);
+    Info result = info_;
+    for (++it; it != last; ++it) {
+      Visit(*it);
+      if (result.exact && info_.exact && result.prefix == info_.prefix) {
+        continue;
+      }
+      // common prefix and suffix of alternatives are required
+      Info common;
+      common.prefix = CommonPrefix(result.prefix, info_.prefix);
+      common.suffix = CommonSuffix(result.suffix, info_.suffix);
+      common.best = Longer(common.prefix, common.suffix);
+      result = common;
+    }
+    info_ = result;
+  }
+
+  void Visit(Alternative* alt) {
+    Info result((std::u16string()));
+    for (Expressions::const_iterator it = alt->terms().begin(),
+         last = alt->terms().end(); it != last; ++it) {
+      (*it)->Accept(this);
+      result = Concat(result, info_);
+    }
+    info_ = result;
+  }
+
+  void Visit(HatAssertion* assertion) {
+    pure_ = false;
+    info_ = Info(std::u16string());
+  }
+
+  void Visit(DollarAssertion* assertion) {
+    pure_ = false;
+    info_ = Info(std::u16string());
+  }
+
+  void Visit(EscapedAssertion* assertion) {
+    pure_ = false;
+    info_ = Info(std::u16string());
+  }
+
+  void Visit(DisjunctionAssertion* assertion) {
+    // lookahead is not a part of the match
+    pure_ = false;
+    info_ = Info(std::u16string());
+  }
+
+  void Visit(BackReferenceAtom* atom) {
+    pure_ = false;
+    info_ = Info();
+  }
+
+  void Visit(CharacterAtom* atom) {
+    info_ = Info(std::u16string(1, atom->character()));
+  }
+
+  void Visit(StringAtom* atom) {
+    info_ = Info(std::u16string(atom->string().begin(),
+                                atom->string().end()));
+  }
+
+  void Visit(RangeAtom* atom) {
+    info_ = Info();
+  }
+
+  void Visit(DisjunctionAtom* atom) {
+    if (atom->captured()) {
+      pure_ = false;
+    }
+    Visit(atom->disjunction());
+  }
+
+  void Visit(Quantifiered* atom) {
+    atom->expression()->Accept(this);
+    if (atom->max() == 0) {
+      info_ = Info(std::u16string());
+      return;
+    }
+    if (atom->min() == 0) {
+      info_ = Info();
+      return;
+    }
+    if (!info_.exact) {
+      // prefix, suffix and best of the body are still required
+      return;
+    }
+    const std::u16string body = info_.best;
+    if (body.empty()) {
+      return;
+    }
+    std::u16string repeated;
+    int32_t count = 0;
+    for (; count < atom->min() && repeated.size() < kMaxLiteralSize; ++count) {
+      repeated.append(body);
+    }
+    info_ = Info(repeated);
+    if (atom->min() != atom->max() || count != atom->min()) {
+      info_.exact = false;
+      Truncate(&info_);
+    }
+  }
+
+  static Info Concat(const Info& lhs, const Info& rhs) {
+    if (lhs.exact && rhs.exact) {
+      Info result(lhs.prefix + rhs.prefix);
+      if (result.prefix.size() > kMaxLiteralSize) {
+        result.exact = false;
+        Truncate(&result);
+      }
+      return result;
+    }
+    Info result;
+    result.prefix = (lhs.exact) ? lhs.prefix + rhs.prefix : lhs.prefix;
+    result.suffix = (rhs.exact) ? lhs.suffix + rhs.suffix : rhs.suffix;
+    result.best = Longer(Longer(lhs.best, rhs.best),
+                         Longer(lhs.suffix + rhs.prefix,
+                                Longer(result.prefix, result.suffix)));
+    Truncate(&result);
+    return result;
+  }
+
+  static void Truncate(Info* info) {
+    if (info->prefix.size() > kMaxLiteralSize) {
+      info->prefix.resize(kMaxLiteralSize);
+    }
+    if (info->suffix.size() > kMaxLiteralSize) {
+      info->suffix.erase(0, info->suffix.size() - kMaxLiteralSize);
+    }
+    if (info->best.size() > kMaxLiteralSize) {
+      info->best.resize(kMaxLiteralSize);
+    }
+  }
+
+  static const std::u16string& Longer(const std::u16string& lhs,
+                                      const std::u16string& rhs) {
+    return (lhs.size() >= rhs.size()) ? lhs : rhs;
+  }
+
+  static std::u16string CommonPrefix(const std::u16string& lhs,
+                                     const std::u16string& rhs) {
+    const std::size_t size = std::min(lhs.size(), rhs.size());
+    const std::size_t len =
+        std::mismatch(lhs.begin(), lhs.begin() + size, rhs.begin()).first -
+        lhs.begin();
+    return lhs.substr(0, len);
+  }
+
+  static std::u16string CommonSuffix(const std::u16string& lhs,
+                                     const std::u16string& rhs) {
+    const std::size_t size = std::min(lhs.size(), rhs.size());
+    const std::size_t len =
+        std::mismatch(lhs.rbegin(), lhs.rbegin() + size, rhs.rbegin()).first -
+        lhs.rbegin();
+    return lhs.substr(lhs.size() - len);
+  }
+
+  bool ignore_case_;
+  bool pure_;
+
+  // result of the last visited node
+  Info info_;
+};
+
+} }  // namespace iv::aero
+#endif  // IV_AERO_LITERAL_CHECK_H_
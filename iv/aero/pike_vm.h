@@ -0,0 +1,351 @@
+// PikeVM
+//
+// Thompson NFA simulation of aero bytecode with submatch tracking.
+// all threads advance in lockstep over the subject, and threads are kept in
+// priority order, so the result is the same to the backtracking engines.
+// each subject position is visited once per thread, so execution time is
+// O(subject size * code size).
+//
+// code compiled for automaton by Compiler does not have counters,
+// back references, lookarounds and multi characters check,
+// and loop bodies always consume characters (POSITION_TEST never fails).
+#ifndef IV_AERO_PIKE_VM_H_
+#define IV_AERO_PIKE_VM_H_
+#include <vector>
+#include <algorithm>
+#include <iv/detail/cstdint.h>
+#include <iv/utils.h>
+#include <iv/noncopyable.h>
+#include <iv/string_view.h>
+#include <iv/aero/flags.h>
+#include <iv/aero/op.h>
+#include <iv/aero/code.h>
+#include <iv/aero/required_literal.h>
+#include <iv/aero/character.h>
+#include <iv/aero/utility.h>
+namespace iv {
+namespace aero {
+
+class PikeVM : private core::Noncopyable<PikeVM> {
+ public:
+  PikeVM()
+    : captures_size_(0),
+      generation_(0),
+      visited_(),
+      current_(),
+      next_(),
+      work_(),
+      jobs_() {
+  }
+
+  template<typename Piece>
+  int Execute(const Code* code, const Piece& subject,
+              int* captures, int offset);
+
+ private:
+  // threads in priority order
+  struct ThreadList {
+    std::vector<uint32_t> pcs;
+    std::vector<int> captures;
+
+    void clear() {
+      pcs.clear();
+      captures.clear();
+    }
+
+    bool empty() const { return pcs.empty(); }
+  };
+
+  // job for following epsilon transitions.
+  // if slot is kPC, value is a program counter to visit.
+  // otherwise, it restores captures slot to value.
+  struct Job {
+    static const uint32_t kPC = UINT32_MAX;
+    uint32_t slot;
+    int value;
+  };
+
+  template<typename Piece>
+  void AddThread(const Code* code, const Piece& subject,
+                 ThreadList* list, uint32_t pc, std::size_t position);
+
+  template<typename Piece>
+  static bool Consume(const Code* code, const uint8_t* instr,
+                      const Piece& subject, std::size_t position);
+
+  void SetCapture(uint32_t slot, int value) {
+    const Job job = { slot, work_[slot] };
+    jobs_.push_back(job);
+    work_[slot] = value;
+  }
+
+  void NewGeneration() {
+    if (++generation_ == 0) {
+      std::fill(visited_.begin(), visited_.end(), 0);
+      generation_ = 1;
+    }
+  }
+
+  std::size_t captures_size_;
+  uint32_t generation_;
+  std::vector<uint32_t> visited_;
+  ThreadList current_;
+  ThreadList next_;
+  std::vector<int> work_;
+  std::vector<Job> jobs_;
+};
+
+template<typename Piece>
+inline int PikeVM::Execute(const Code* code, const Piece& subject,
+                           int* captures, int offset) {
+  assert(code->automaton());
+  assert(code->captures() >= 1);
+  const std::size_t size = subject.size();
+  if (static_cast<std::size_t>(offset) > size) {
+    return AERO_FAILURE;
+  }
+  captures_size_ = code->captures() * 2;
+  visited_.assign(code->bytes().size(), 0);
+  generation_ = 0;
+  current_.clear();
+  next_.clear();
+  work_.resize(captures_size_);
+
+  const uint16_t filter = code->filter();
+  const RequiredLiteral* literal = code->literal();
+  if (literal && !literal->IsPrefix()) {
+    // only prefix literal tells where threads start
+    literal = nullptr;
+  }
+  bool matched = false;
+  std::size_t position = offset;
+  NewGeneration();
+  for (;;) {
+    if (!matched) {
+      if (current_.empty() && (literal || filter)) {
+        // no thread is alive. skip to the next candidate position
+        if (literal) {
+          position = literal->Find(subject, position);
+          if (position == Piece::npos) {
+            return AERO_FAILURE;
+          }
+        } else if (code->IsQuickCheckOneChar()) {
+          while (position < size && subject[position] != filter) {
+            ++position;
+          }
+        } else {
+          while (position < size &&
+                 (filter & subject[position]) != subject[position]) {
+            ++position;
+          }
+        }
+        if (position >= size) {
+          return AERO_FAILURE;
+        }
+        NewGeneration();
+      }
+      // new thread starting at this position has the lowest priority
+      std::fill(work_.begin(), work_.end(), kUndefined);
+      work_[0] = static_cast<int>(position);
+      AddThread(code, subject, &current_, 0, position);
+    }
+
+    if (matched && current_.empty()) {
+      break;
+    }
+
+    NewGeneration();
+    for (std::size_t i = 0, len = current_.pcs.size(); i < len; ++i) {
+      const uint32_t pc = current_.pcs[i];
+      const int* thread = current_.captures.data() + i * captures_size_;
+      const uint8_t* instr = code->data() + pc;
+      if (*instr == OP::SUCCESS) {
+        // threads after this have lower priority, so they are cut off
+        std::copy(thread, thread + captures_size_, captures);
+        captures[1] = static_cast<int>(position);
+        matched = true;
+        break;
+      }
+      if (Consume(code, instr, subject, position)) {
+        std::copy(thread, thread + captures_size_, work_.begin());
+        AddThread(code, subject, &next_,
+                  pc + OP::GetLength(instr), position + 1);
+      }
+    }
+    std::swap(current_, next_);
+    next_.clear();
+    if (position == size) {
+      break;
+    }
+    ++position;
+  }
+  return (matched) ? AERO_SUCCESS : AERO_FAILURE;
+}
+
+// follow epsilon transitions from pc in priority order and add threads
+// which stop at SUCCESS or character check to the list.
+// captures of the thread are passed by work_.
+template<typename Piece>
+inline void PikeVM::AddThread(const Code* code, const Piece& subject,
+                              ThreadList* list,
+                              uint32_t start, std::size_t position) {
+  const uint8_t* const first_instr = code->data();
+  const Job first = { Job::kPC, static_cast<int>(start) };
+  jobs_.push_back(first);
+  while (!jobs_.empty()) {
+    const Job job = jobs_.back();
+    jobs_.pop_back();
+    if (job.slot != Job::kPC) {
+      work_[job.slot] = job.value;
+      continue;
+    }
+    uint32_t pc = static_cast<uint32_t>(job.value);
+    for (;;) {
+      if (visited_[pc] == generation_) {
+        break;
+      }
+      visited_[pc] = generation_;
+      const uint8_t* instr = first_instr + pc;
+      bool follow = true;
+      switch (instr[0]) {
+        case OP::PUSH_BACKTRACK: {
+          // alternative has lower priority than the next instruction
+          const Job alternative = {
+            Job::kPC, static_cast<int>(Load4Bytes(instr + 1))
+          };
+          jobs_.push_back(alternative);
+          break;
+        }
+        case OP::JUMP: {
+          pc = Load4Bytes(instr + 1);
+          continue;
+        }
+        case OP::START_CAPTURE: {
+          const uint32_t target = Load4Bytes(instr + 1);
+          SetCapture(target * 2, static_cast<int>(position));
+          SetCapture(target * 2 + 1, kUndefined);
+          break;
+        }
+        case OP::END_CAPTURE: {
+          const uint32_t target = Load4Bytes(instr + 1);
+          SetCapture(target * 2 + 1, static_cast<int>(position));
+          break;
+        }
+        case OP::CLEAR_CAPTURES: {
+          const uint32_t from = Load4Bytes(instr + 1);
+          const uint32_t to = Load4Bytes(instr + 5);
+          for (uint32_t slot = from * 2; slot < to * 2; ++slot) {
+            SetCapture(slot, kUndefined);
+          }
+          break;
+        }
+        case OP::STORE_POSITION:
+        case OP::POSITION_TEST: {
+          // loop body always consumes characters
+          break;
+        }
+        case OP::ASSERTION_BOB: {
+          follow = position == 0;
+          break;
+        }
+        case OP::ASSERTION_EOB: {
+          follow = position == subject.size();
+          break;
+        }
+        case OP::ASSERTION_BOL: {
+          follow = position == 0 ||
+              core::character::IsLineTerminator(subject[position - 1]);
+          break;
+        }
+        case OP::ASSERTION_EOL: {
+          follow = position == subject.size() ||
+              core::character::IsLineTerminator(subject[position]);
+          break;
+        }
+        case OP::ASSERTION_WORD_BOUNDARY: {
+          follow = character::IsWordSeparatorPrev(subject, position) !=
+              character::IsWordSeparator(subject, position);
+          break;
+        }
+        case OP::ASSERTION_WORD_BOUNDARY_INVERTED: {
+          follow = character::IsWordSeparatorPrev(subject, position) ==
+              character::IsWordSeparator(subject, position);
+          break;
+        }
+        case OP::FAILURE: {
+          follow = false;
+          break;
+        }
+        default: {
+          // SUCCESS or character check
+          assert(instr[0] == OP::SUCCESS ||
+                 (instr[0] >= OP::CHECK_1BYTE_CHAR &&
+                  instr[0] <= OP::CHECK_RANGE_INVERTED));
+          list->pcs.push_back(pc);
+          list->captures.insert(list->captures.end(),
+                                work_.begin(), work_.end());
+          follow = false;
+          break;
+        }
+      }
+      if (!follow) {
+        break;
+      }
+      pc += OP::GetLength(instr);
+    }
+  }
+}
+
+template<typename Piece>
+inline bool PikeVM::Consume(const Code* code, const uint8_t* instr,
+                            const Piece& subject, std::size_t position) {
+  if (position >= subject.size()) {
+    return false;
+  }
+  const char16_t ch = subject[position];
+  switch (instr[0]) {
+    case OP::CHECK_1BYTE_CHAR:
+      return ch == Load1Bytes(instr + 1);
+
+    case OP::CHECK_2BYTE_CHAR:
+      return ch == Load2Bytes(instr + 1);
+
+    case OP::CHECK_2CHAR_OR:
+      return ch == Load2Bytes(instr + 1) || ch == Load2Bytes(instr + 3);
+
+    case OP::CHECK_3CHAR_OR:
+      return
+          ch == Load2Bytes(instr + 1) ||
+          ch == Load2Bytes(instr + 3) ||
+          ch == Load2Bytes(instr + 5);
+
+    case OP::CHECK_4CHAR_OR:
+      return
+          ch == Load2Bytes(instr + 1) ||
+          ch == Load2Bytes(instr + 3) ||
+          ch == Load2Bytes(instr + 5) ||
+          ch == Load2Bytes(instr + 7);
+
+    case OP::CHECK_RANGE:
+    case OP::CHECK_RANGE_INVERTED: {
+      const bool inverted = instr[0] == OP::CHECK_RANGE_INVERTED;
+      const uint32_t length = Load4Bytes(instr + 1);
+      for (std::size_t i = 0; i < length; i += 4) {
+        const char16_t start = Load2Bytes(instr + 5 + 4 + i);
+        if (ch < start) {
+          break;
+        }
+        const char16_t finish = Load2Bytes(instr + 5 + 4 + i + 2);
+        if (ch <= finish) {
+          return !inverted;
+        }
+      }
+      return inverted;
+    }
+  }
+  UNREACHABLE();
+  return false;
+}
+
+} }  // namespace iv::aero
+#endif  // IV_AERO_PIKE_VM_H_
@@ -0,0 +1,70 @@
+// RequiredLiteral
+//
+// literal which every match contains. computed by LiteralCheck at compile
+// time and scanned with the SIMD substring search before entering the
+// matcher. if no occurrence is found, the pattern cannot match.
+// if the literal is a prefix, no match starts before the occurrence.
+#ifndef IV_AERO_REQUIRED_LITERAL_H_
+#define IV_AERO_REQUIRED_LITERAL_H_
+#include <memory>
+#include <string>
+#include <iv/string_view.h>
+#include <iv/aero/literal_check.h>
+namespace iv {
+namespace aero {
+
+class RequiredLiteral {
+ public:
+  // 1 char prefix is already handled by quick check filter
+  static const std::size_t kMinLiteralSize = 2;
+
+  RequiredLiteral(const std::u16string& str, bool prefix)
+    : u8_(),
+      u16_(str),
+      has_u8_(true),
+      prefix_(prefix) {
+    for (char16_t ch : u16_) {
+      if (ch > 0xFF) {
+        // never appears in 8bit strings
+        has_u8_ = false;
+        return;
+      }
+    }
+    u8_.assign(u16_.begin(), u16_.end());
+  }
+
+  static std::shared_ptr<RequiredLiteral> New(const LiteralCheck& check) {
+    if (check.literal().size() < kMinLiteralSize) {
+      return nullptr;
+    }
+    return std::make_shared<RequiredLiteral>(check.literal(), check.IsPrefix());
+  }
+
+  std::size_t Find(const core::u16string_view& subject,
+                   std::size_t offset) const {
+    return subject.find(core::u16string_view(u16_), offset);
+  }
+
+  std::size_t Find(const core::string_view& subject,
+                   std::size_t offset) const {
+    if (!has_u8_) {
+      return core::string_view::npos;
+    }
+    return subject.find(core::string_view(u8_), offset);
+  }
+
+  bool IsPrefix() const { return prefix_; }
+
+  std::size_t size() const { return u16_.size(); }
+
+  const std::string& u8() const { return u8_; }
+  const std::u16string& u16() const { return u16_; }
+ private:
+  std::string u8_;
+  std::u16string u16_;
+  bool has_u8_;
+  bool prefix_;
+};
+
+} }  // namespace iv::aero
+#endif  // IV_AERO_REQUIRED_LITERAL_H_
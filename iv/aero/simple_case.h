@@ -3,80 +3,53 @@
 #include <memory>
 #include <string>
 #include <iv/platform.h>
-#include <iv/character.h>
 #include <iv/string_view.h>
-#include <iv/aero/parser.h>
 #include <iv/aero/flags.h>
+#include <iv/aero/literal_check.h>
+#include <iv/aero/required_literal.h>
 namespace iv {
 namespace aero {
 
+// pattern which is a pure literal, like /keyword/.
+// matched by substring search without entering the VM.
 class SimpleCase {
  public:
-  SimpleCase(const StringAtom* str)
-      : u8_()
-      , u16_(str->string().begin(), str->string().end()) {
-    for (char16_t ch : u16_) {
-      if (!core::character::IsASCII(ch)) {
-        return;
-      }
-    }
-    u8_.assign(u16_.begin(), u16_.end());
+  explicit SimpleCase(const std::u16string& str)
+      : literal_(str, true) {
   }
 
-  static std::shared_ptr<SimpleCase> New(const ParsedData& data, bool ignore) {
-    // Currently disabled.
-    return nullptr;
-
-    if (ignore) {
+  static std::shared_ptr<SimpleCase> New(const LiteralCheck& check) {
+    if (!check.IsPure() || check.literal().empty()) {
       return nullptr;
     }
-
-    if (const Disjunction* dis = data.pattern()->AsDisjunction()) {
-      if (dis->alternatives().size() != 1) {
-        return nullptr;
-      }
-      const Alternative* alt = dis->alternatives().front();
-      if (alt->terms().size() != 1) {
-        return nullptr;
-      }
-      const Expression* exp = alt->terms().front();
-      if (const StringAtom* str = exp->AsStringAtom()) {
-        return std::shared_ptr<SimpleCase>(new SimpleCase(str));
-      }
-    }
-    return nullptr;
+    return std::make_shared<SimpleCase>(check.literal());
   }
 
   int Execute(
       const core::u16string_view& subject, int* captures, int offset) const {
-    const std::size_t pos = subject.find(u16_, offset);
-    if (core::u16string_view::npos == pos) {
-      return AERO_FAILURE;
-    }
-    captures[0] = pos;
-    captures[1] = pos + u16_.size();
-    return AERO_SUCCESS;
+    return ExecuteImpl(subject, captures, offset);
   }
 
   int Execute(
       const core::string_view& subject, int* captures, int offset) const {
-    if (u8_.empty()) {
-      return AERO_FAILURE;
-    }
-    const std::size_t pos = subject.find(u8_, offset);
-    if (core::string_view::npos == pos) {
+    return ExecuteImpl(subject, captures, offset);
+  }
+
+  const std::string& u8() const { return literal_.u8(); }
+  const std::u16string& u16() const { return literal_.u16(); }
+ private:
+  template<typename Piece>
+  int ExecuteImpl(const Piece& subject, int* captures, int offset) const {
+    const std::size_t pos = literal_.Find(subject, offset);
+    if (Piece::npos == pos) {
       return AERO_FAILURE;
     }
     captures[0] = pos;
-    captures[1] = pos + u8_.size();
+    captures[1] = pos + literal_.size();
     return AERO_SUCCESS;
   }
 
-  const std::string& u8() const { return u8_; }
-  const std::u16string& u16() const { return u16_; }
- private:
-  std::string u8_;
-  std::u16string u16_;
+  RequiredLiteral literal_;
 };
 
 } }  // namespace iv::aero
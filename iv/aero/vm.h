@@ -10,27 +10,12 @@
 #include <iv/aero/code.h>
 #include <iv/aero/character.h>
 #include <iv/aero/utility.h>
+#include <iv/aero/pike_vm.h>
+#include <iv/aero/required_literal.h>
+#include <iv/aero/simple_case.h>
 namespace iv {
 namespace aero {
 
-template<typename Piece>
-inline bool IsWordSeparatorPrev(const Piece& subject,
-                                std::size_t current_position) {
-  if (current_position == 0 || current_position > subject.size()) {
-    return false;
-  }
-  return character::IsWord(subject[current_position - 1]);
-}
-
-template<typename Piece>
-inline bool IsWordSeparator(const Piece& subject,
-                            std::size_t current_position) {
-  if (current_position >= subject.size()) {
-    return false;
-  }
-  return character::IsWord(subject[current_position]);
-}
-
 class VM : private core::Noncopyable<VM> {
  public:
   static const uint32_t kInitialStackSize = 8096;
@@ -43,6 +28,7 @@ class VM : private core::Noncopyable<VM> {
     , stack_size_(kInitialStackSize)
     , state_size_(kInitialStateSize)
     , stack_(kInitialStackSize)
+    , pike_()
 #if !defined(IV_ENABLE_JIT)
     , state_()
 #endif
@@ -62,37 +48,57 @@ class VM : private core::Noncopyable<VM> {
 #if defined(IV_ENABLE_JIT)
   int Execute(Code* code, const core::u16string_view& subject,
               int* captures, int offset) {
-    // Currently disabled.
-    // if (code->simple()) {
-    //   return code->simple()->Execute(subject, captures, offset);
-    // }
+    if (code->simple()) {
+      return code->simple()->Execute(subject, captures, offset);
+    }
+    if (!Prefilter(code, subject, &offset)) {
+      return AERO_FAILURE;
+    }
+    if (code->automaton()) {
+      return pike_.Execute(code, subject, captures, offset);
+    }
     return code->jit()->Execute(this, code, subject, captures, offset);
   }
 
   int Execute(Code* code, const core::string_view& subject,
               int* captures, int offset) {
-    // Currently disabled.
-    // if (code->simple()) {
-    //   return code->simple()->Execute(subject, captures, offset);
-    // }
+    if (code->simple()) {
+      return code->simple()->Execute(subject, captures, offset);
+    }
+    if (!Prefilter(code, subject, &offset)) {
+      return AERO_FAILURE;
+    }
+    if (code->automaton()) {
+      return pike_.Execute(code, subject, captures, offset);
+    }
     return code->jit()->Execute(this, code, subject, captures, offset);
   }
 #else
   int Execute(Code* code, const core::u16string_view& subject,
               int* captures, int offset) {
-    // Currently disabled.
-    // if (code->simple()) {
-    //   return code->simple()->Execute(subject, captures, offset);
-    // }
+    if (code->simple()) {
+      return code->simple()->Execute(subject, captures, offset);
+    }
+    if (!Prefilter(code, subject, &offset)) {
+      return AERO_FAILURE;
+    }
+    if (code->automaton()) {
+      return pike_.Execute(code, subject, captures, offset);
+    }
     return ExecuteImpl(code, subject, captures, offset);
   }
 
   int Execute(Code* code, const core::string_view& subject,
               int* captures, int offset) {
-    // Currently disabled.
-    // if (code->simple()) {
-    //   return code->simple()->Execute(subject, captures, offset);
-    // }
+    if (code->simple()) {
+      return code->simple()->Execute(subject, captures, offset);
+    }
+    if (!Prefilter(code, subject, &offset)) {
+      return AERO_FAILURE;
+    }
+    if (code->automaton()) {
+      return pike_.Execute(code, subject, captures, offset);
+    }
     return ExecuteImpl(code, subject, captures, offset);
   }
 
@@ -101,7 +107,18 @@ class VM : private core::Noncopyable<VM> {
   int ExecuteImpl(Code* code, const Piece& subject, int* captures, int offset) {
     const int size = subject.size();
     const uint16_t filter = code->filter();
-    if (!filter) {
+    const RequiredLiteral* literal = code->literal();
+    if (literal && literal->IsPrefix()) {
+      // literal prefix path
+      std::size_t pos = offset;
+      while ((pos = literal->Find(subject, pos)) != Piece::npos) {
+        const int res = Main(code, subject, captures, pos);
+        if (res == AERO_SUCCESS || res == AERO_ERROR) {
+          return res;
+        }
+        ++pos;
+      }
+    } else if (!filter) {
       // normal path
       do {
         const int res = Main(code, subject, captures, offset);
@@ -149,6 +166,25 @@ class VM : private core::Noncopyable<VM> {
   uint64_t state_size() const { return state_size_; }
 
  private:
+  // scan the required literal before entering the matcher.
+  // returns false if the pattern cannot match. if the literal is a prefix,
+  // offset is moved to its first occurrence.
+  template<typename Piece>
+  static bool Prefilter(const Code* code, const Piece& subject, int* offset) {
+    const RequiredLiteral* literal = code->literal();
+    if (!literal) {
+      return true;
+    }
+    const std::size_t pos = literal->Find(subject, *offset);
+    if (pos == Piece::npos) {
+      return false;
+    }
+    if (literal->IsPrefix()) {
+      *offset = static_cast<int>(pos);
+    }
+    return true;
+  }
+
   int* NewState(std::size_t offset) {
     do {
       if (offset <= stack_.size()) {
@@ -167,6 +203,7 @@ class VM : private core::Noncopyable<VM> {
   uint64_t stack_size_;
   uint64_t state_size_;
   std::vector<int> stack_;
+  PikeVM pike_;
 #if !defined(IV_ENABLE_JIT)
   std::vector<int> state_;
 
@@ -432,16 +469,16 @@ inline int VM::Main(Code* code, const Piece& subject,
       }
 
       DEFINE_OPCODE(ASSERTION_WORD_BOUNDARY) {
-        if (IsWordSeparatorPrev(subject, current_position) !=
-            IsWordSeparator(subject, current_position)) {
+        if (character::IsWordSeparatorPrev(subject, current_position) !=
+            character::IsWordSeparator(subject, current_position)) {
           DISPATCH_NEXT();
         }
         BACKTRACK();
       }
 
       DEFINE_OPCODE(ASSERTION_WORD_BOUNDARY_INVERTED) {
-        if (IsWordSeparatorPrev(subject, current_position) ==
-            IsWordSeparator(subject, current_position)) {
+        if (character::IsWordSeparatorPrev(subject, current_position) ==
+            character::IsWordSeparator(subject, current_position)) {
           DISPATCH_NEXT();
         }
         BACKTRACK();
@@ -35,6 +35,38 @@ class Malloced {
   }
 };
 
+// STL allocator allocating memory from std::malloc
+// used for containers which may be grown in threads
+// that are not known to GC, such as radio heap threads
+template<typename T>
+class MallocAllocator {
+ public:
+  typedef T value_type;
+
+  MallocAllocator() { }
+
+  template<typename U>
+  MallocAllocator(const MallocAllocator<U>&) { }  // NOLINT
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(Malloced::New(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) {
+    Malloced::Delete(p);
+  }
+};
+
+template<typename T, typename U>
+inline bool operator==(const MallocAllocator<T>&, const MallocAllocator<U>&) {
+  return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const MallocAllocator<T>&, const MallocAllocator<U>&) {
+  return false;
+}
+
 class Space;
 
 class Arena : private Noncopyable<Arena> {
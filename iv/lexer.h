@@ -75,6 +75,17 @@ class Lexer: private Noncopyable<> {
     Advance();
   }
 
+  // restart lexing from the position, which is the begin position of
+  // some token lexed before. used for reparsing a part of the source
+  void Seek(std::size_t position, std::size_t line_number) {
+    assert(position <= end_);
+    pos_ = position;
+    has_line_terminator_before_next_ = false;
+    previous_line_number_ = line_number;
+    line_number_ = line_number;
+    Advance();
+  }
+
   // for label lookahead
   bool NextIsColon() const {
     for (std::size_t pos = pos_ - 1; pos < end_; ++pos) {
@@ -7,9 +7,11 @@ namespace breaker {
 
 inline void ExecuteInGlobal(Context* ctx,
                             std::shared_ptr<core::FileSource> src, Error* e) {
-  railgun::Code* code =
-      railgun::CompileInGlobal(ctx, src, true, IV_LV5_ERROR_VOID(e));
-  Compile(ctx, code);
+  railgun::Code* code = railgun::CompileInGlobal(
+      ctx, src, !ctx->IsTiered(), IV_LV5_ERROR_VOID(e));
+  if (!ctx->IsTiered()) {
+    Compile(ctx, code);
+  }
   Run(ctx, code, e);
 }
 
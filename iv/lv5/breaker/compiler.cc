@@ -38,8 +38,10 @@ Compiler::Compiler(Context* ctx, railgun::Code* top)
     previous_instr_(nullptr),
     last_used_(kInvalidUsedOffset),
     last_used_candidate_(),
+    last_double_(kInvalidUsedOffset),
+    last_double_candidate_(),
     type_record_() {
-  top_->core_data()->set_native_code(native_code_);
+  top_->core_data()->AddNativeCode(native_code_);
 }
 
 Compiler::~Compiler() {
@@ -85,6 +87,7 @@ Compiler::~Compiler() {
 
 void Compiler::Initialize(railgun::Code* code) {
   code_ = code;
+  code_->set_native_code(native_code_);
   codes_.push_back(code);
   jump_map_.clear();
   entry_points_.insert(std::make_pair(code, asm_->size()));
@@ -119,7 +122,11 @@ void Compiler::ScanJumps() {
     if (r::OP::IsJump(opcode)) {
       const int32_t jump = instr[1].jump.to;
       const uint32_t to = index + jump;
-      jump_map_.insert(std::make_pair(to, JumpInfo(false)));
+      JumpInfo& info =
+          jump_map_.insert(std::make_pair(to, JumpInfo(false))).first->second;
+      if (jump < 0) {
+        info.loop_header = true;
+      }
     }
     std::advance(instr, length);
   }
@@ -171,11 +178,13 @@ void Compiler::Main() {
     const uint32_t opcode = instr->GetOP();
     const uint32_t length = r::kOPLength[opcode];
     set_last_used_candidate(kInvalidUsedOffset);
+    set_last_double_candidate(kInvalidUsedOffset);
 
     const bool in_basic_block = SplitBasicBlock(previous, instr);
     if (!in_basic_block) {
       set_previous_instr(nullptr);
       kill_last_used();
+      kill_last_double();
       type_record_.Clear();
     } else {
       set_previous_instr(previous);
@@ -191,7 +200,10 @@ void Compiler::Main() {
       case r::OP::ENTER:
         EmitENTER(instr);
         break;
+      // superinstruction is compiled as its first opcode because
+      // its second opcode is left in instruction stream
       case r::OP::MV:
+      case r::OP::MV_RETURN:
         EmitMV(instr);
         break;
       case r::OP::UNARY_POSITIVE:
@@ -207,6 +219,7 @@ void Compiler::Main() {
         EmitUNARY_BIT_NOT(instr);
         break;
       case r::OP::BINARY_ADD:
+      case r::OP::BINARY_ADD_RETURN:
         EmitBINARY_ADD(instr);
         break;
       case r::OP::BINARY_SUBTRACT:
@@ -341,20 +354,20 @@ void Compiler::Main() {
       case r::OP::STORE_OBJECT_SET:
         EmitSTORE_OBJECT_SET(instr);
         break;
+      // in tiered execution, code is interpreted before compiling,
+      // so LOAD_PROP / STORE_PROP may be already rewritten by railgun VM
       case r::OP::LOAD_PROP:
-        EmitLOAD_PROP(instr);
-        break;
       case r::OP::LOAD_PROP_GENERIC:
       case r::OP::LOAD_PROP_OWN:
       case r::OP::LOAD_PROP_PROTO:
       case r::OP::LOAD_PROP_CHAIN:
-        UNREACHABLE();
+      case r::OP::LOAD_PROP_POLY:
+      case r::OP::LOAD_PROP_MEGAMORPHIC:
+        EmitLOAD_PROP(instr);
         break;
       case r::OP::STORE_PROP:
-        EmitSTORE_PROP(instr);
-        break;
       case r::OP::STORE_PROP_GENERIC:
-        UNREACHABLE();
+        EmitSTORE_PROP(instr);
         break;
       case r::OP::DELETE_PROP:
         EmitDELETE_PROP(instr);
@@ -372,6 +385,9 @@ void Compiler::Main() {
         EmitPOSTFIX_DECREMENT_PROP(instr);
         break;
       case r::OP::LOAD_CONST:
+      case r::OP::LOAD_CONST_BINARY_ADD:
+      case r::OP::LOAD_CONST_BINARY_SUBTRACT:
+      case r::OP::LOAD_CONST_IF_FALSE_BINARY_LT:
         EmitLOAD_CONST(instr);
         break;
       case r::OP::JUMP_BY:
@@ -591,9 +607,29 @@ void Compiler::Main() {
     previous = instr;
     std::advance(instr, length);
     set_last_used(last_used_candidate());
+    set_last_double(last_double_candidate());
   }
   // because handler makes range label to end.
   SplitBasicBlock(instr, code_->end());
+
+  // emit entries of on-stack replacement.
+  // railgun VM transfers interpreted frame to native code at loop header,
+  // so entry emits prologue and jumps to loop header. frame layout is shared
+  // and compile time caches are cleared at jump target, so registers need
+  // no materialization. code having exception handlers is not supported.
+  if (ctx_->IsTiered() && code_->exception_table().empty()) {
+    for (JumpMap::iterator it = jump_map_.begin(),
+         last = jump_map_.end(); it != last; ++it) {
+      if (!it->second.loop_header) {
+        continue;
+      }
+      native_code()->AttachOSREntry(it->first, asm_->size());
+      code_->set_has_osr_entry(true);
+      asm_->push(r12);
+      asm_->sub(qword[r14 + offsetof(Frame, ret)], k64Size * kStackPayload);
+      asm_->jmp(it->second.label, Xbyak::CodeGenerator::T_NEAR);
+    }
+  }
 }
 
 // Load virtual register
@@ -1056,12 +1092,7 @@ void Compiler::EmitSTORE_OBJECT_DATA(const Instruction* instr) {
   const register_t item = Reg(instr[1].i16[1]);
   const uint32_t offset = instr[2].u32[0];
   LoadVRs(rdi, obj, rax, item);
-  const std::ptrdiff_t data_offset =
-      IV_CAST_OFFSET(radio::Cell*, JSObject*) +
-      JSObject::SlotsOffset() +
-      JSObject::Slots::DataOffset();
-  asm_->mov(rdi, qword[rdi + data_offset]);
-  asm_->mov(qword[rdi + kJSValSize * offset], rax);
+  asm_->mov(IC::SlotAddress(asm_, rdi, rdi, offset), rax);
 }
 
 // opcode | (obj | item) | (offset | merged)
@@ -1072,12 +1103,7 @@ void Compiler::EmitSTORE_OBJECT_GET(const Instruction* instr) {
   const uint32_t merged = instr[2].u32[1];
   if (merged) {
     LoadVRs(rdi, obj, rax, item);
-    const std::ptrdiff_t data_offset =
-        IV_CAST_OFFSET(radio::Cell*, JSObject*) +
-        JSObject::SlotsOffset() +
-        JSObject::Slots::DataOffset();
-    asm_->mov(rdi, qword[rdi + data_offset]);
-    asm_->mov(rdi, qword[rdi + kJSValSize * offset]);
+    asm_->mov(rdi, IC::SlotAddress(asm_, rdi, rdi, offset));
     // rdi is Accessor Cell
     const std::ptrdiff_t getter_offset =
         IV_CAST_OFFSET(radio::Cell*, Accessor*) +
@@ -1104,12 +1130,7 @@ void Compiler::EmitSTORE_OBJECT_SET(const Instruction* instr) {
   const uint32_t merged = instr[2].u32[1];
   if (merged) {
     LoadVRs(rdi, obj, rax, item);
-    const std::ptrdiff_t data_offset =
-        IV_CAST_OFFSET(radio::Cell*, JSObject*) +
-        JSObject::SlotsOffset() +
-        JSObject::Slots::DataOffset();
-    asm_->mov(rdi, qword[rdi + data_offset]);
-    asm_->mov(rdi, qword[rdi + kJSValSize * offset]);
+    asm_->mov(rdi, IC::SlotAddress(asm_, rdi, rdi, offset));
     // rdi is Accessor Cell
     const std::ptrdiff_t getter_offset =
         IV_CAST_OFFSET(radio::Cell*, Accessor*) +
@@ -2695,7 +2716,12 @@ void Compiler::LoadDouble(
     Xbyak::CodeGenerator::LabelType near) {
   const TypeEntry type = type_record_.Get(reg);
   const Xbyak::Reg32 scratch32(scratch.getIdx());
-  if (type.IsConstantDouble()) {
+  if (reg == last_double()) {
+    // unboxed number is carried from the previous instruction
+    if (xmm.getIdx() != xmm7.getIdx()) {
+      asm_->movapd(xmm, xmm7);
+    }
+  } else if (type.IsConstantDouble()) {
     const double value = type.constant().number();
     asm_->mov(scratch, core::BitCast<uint64_t>(value));
     asm_->movq(xmm, scratch);
@@ -2754,6 +2780,44 @@ void Compiler::BoxDouble(
   }
 }
 
+bool Compiler::IsDoubleCarried(const Instruction* instr,
+                               register_t dst) const {
+  const Instruction* next = instr + railgun::kOPLength[instr->GetOP()];
+  if (next == code_->end()) {
+    return false;
+  }
+  switch (next->GetOP()) {
+    case OP::BINARY_ADD:
+    case OP::BINARY_ADD_RETURN:
+    case OP::BINARY_SUBTRACT:
+    case OP::BINARY_MULTIPLY:
+    case OP::BINARY_DIVIDE:
+    case OP::BINARY_LT:
+    case OP::BINARY_LTE:
+    case OP::BINARY_GT:
+    case OP::BINARY_GTE:
+      // opcode | (dst | lhs | rhs)
+      return Reg(next[1].i16[1]) == dst || Reg(next[1].i16[2]) == dst;
+    default:
+      return false;
+  }
+}
+
+void Compiler::UnboxNumber(
+    const Xbyak::Reg64& src,
+    const Xbyak::Reg64& scratch,
+    const Xbyak::Xmm& xmm) {
+  const Assembler::LocalLabelScope scope(asm_);
+  asm_->cmp(src, r15);
+  asm_->jb(".IS_DOUBLE");
+  asm_->cvtsi2sd(xmm, Xbyak::Reg32(src.getIdx()));
+  asm_->jmp(".DONE");
+  asm_->L(".IS_DOUBLE");
+  asm_->lea(scratch, ptr[src + r15]);
+  asm_->movq(xmm, scratch);
+  asm_->L(".DONE");
+}
+
 static void CompileInternal(Compiler* compiler, railgun::Code* code) {
   compiler->Compile(code);
   for (railgun::Code* sub : code->codes()) {
@@ -2766,12 +2830,27 @@ void Compile(Context* ctx, railgun::Code* code) {
   CompileInternal(&compiler, code);
 }
 
+void CompileHotCode(Context* ctx, railgun::Code* code) {
+  // global and eval code are executed only once,
+  // so only function code is compiled
+  if (code->executable() || code->code_type() != railgun::Code::FUNCTION) {
+    return;
+  }
+  Compiler compiler(ctx, code);
+  compiler.Compile(code);
+}
+
 // external interfaces
+//
+// in tiered execution, code is interpreted by railgun VM at first,
+// so registers are not folded and native code is generated lazily
+// by CompileHotCode
 railgun::Code* CompileGlobal(
     Context* ctx,
     const FunctionLiteral& global, railgun::JSScript* script) {
-  railgun::Code* code = railgun::CompileGlobal(ctx, global, script, true);
-  if (code) {
+  railgun::Code* code =
+      railgun::CompileGlobal(ctx, global, script, !ctx->IsTiered());
+  if (code && !ctx->IsTiered()) {
     Compile(ctx, code);
   }
   return code;
@@ -2780,8 +2859,9 @@ railgun::Code* CompileGlobal(
 railgun::Code* CompileFunction(
     Context* ctx,
     const FunctionLiteral& func, railgun::JSScript* script) {
-  railgun::Code* code = railgun::CompileFunction(ctx, func, script, true);
-  if (code) {
+  railgun::Code* code =
+      railgun::CompileFunction(ctx, func, script, !ctx->IsTiered());
+  if (code && !ctx->IsTiered()) {
     Compile(ctx, code);
   }
   return code;
@@ -2790,8 +2870,9 @@ railgun::Code* CompileFunction(
 railgun::Code* CompileEval(
     Context* ctx,
     const FunctionLiteral& eval, railgun::JSScript* script) {
-  railgun::Code* code = railgun::CompileEval(ctx, eval, script, true);
-  if (code) {
+  railgun::Code* code =
+      railgun::CompileEval(ctx, eval, script, !ctx->IsTiered());
+  if (code && !ctx->IsTiered()) {
     Compile(ctx, code);
   }
   return code;
@@ -2801,8 +2882,9 @@ railgun::Code* CompileIndirectEval(
     Context* ctx,
     const FunctionLiteral& eval,
     railgun::JSScript* script) {
-  railgun::Code* code = railgun::CompileIndirectEval(ctx, eval, script, true);
-  if (code) {
+  railgun::Code* code =
+      railgun::CompileIndirectEval(ctx, eval, script, !ctx->IsTiered());
+  if (code && !ctx->IsTiered()) {
     Compile(ctx, code);
   }
   return code;
@@ -37,15 +37,18 @@ class Compiler {
   struct JumpInfo {
     JumpInfo()
       : exception_handled(false),
+        loop_header(false),
         label() {
     }
 
     JumpInfo(bool handled)
       : exception_handled(handled),
+        loop_header(false),
         label() {
     }
 
     bool exception_handled;
+    bool loop_header;  // target of backward jump
     Xbyak::Label label;
   };
 
@@ -364,9 +367,21 @@ class Compiler {
   // opcode | (dst | imm | name) | (offset | nest)
   void EmitTYPEOF_HEAP(const Instruction* instr);
 
-  // opcode | (callee | offset | argc_with_this)
+  // opcode | (callee | offset | argc_with_this) | callee
   void EmitCALL(const Instruction* instr);
 
+  // inlining of CALL site (compiler_inline.cc)
+  class InlineFrame;
+
+  // returns recorded callee if it is a single user function
+  // and its body can be inlined
+  JSFunction* InlineTarget(const Instruction* instr) const;
+
+  // emits callee body, which leaves result in rax and jumps to .CALL_EXIT.
+  // guard failures jump to generic label
+  void EmitInlineCALL(const Instruction* instr,
+                      JSFunction* func, const Xbyak::Label& generic);
+
   // opcode | (callee | offset | argc_with_this)
   void EmitCONSTRUCT(const Instruction* instr);
 
@@ -531,6 +546,30 @@ class Compiler {
     set_last_used(kInvalidUsedOffset);
   }
 
+  // unboxed number of last_double() register is carried in xmm7
+  // to the next instruction, as last_used() register is carried in rax.
+  // this is partial unboxing: the carry is dropped after one instruction,
+  // because slow paths of arithmetic ops call stubs which clobber xmm
+  // registers. values are never kept unboxed across loop back edges,
+  // frame registers stay boxed for stubs, handlers and OSR entries
+  inline int32_t last_double() const { return last_double_; }
+
+  inline void set_last_double(int32_t reg) {
+    last_double_ = reg;
+  }
+
+  inline int32_t last_double_candidate() const {
+    return last_double_candidate_;
+  }
+
+  inline void set_last_double_candidate(int32_t reg) {
+    last_double_candidate_ = reg;
+  }
+
+  inline void kill_last_double() {
+    set_last_double(kInvalidUsedOffset);
+  }
+
   inline Context* ctx() const { return ctx_; }
 
   inline NativeCode* native_code() const { return native_code_; }
@@ -549,6 +588,14 @@ class Compiler {
                  const Xbyak::Reg64& dst64,
                  const Xbyak::Label* exit);
 
+  // returns true if the next instruction of instr loads dst as double
+  bool IsDoubleCarried(const Instruction* instr, register_t dst) const;
+
+  // src is number jsval
+  void UnboxNumber(const Xbyak::Reg64& src,
+                   const Xbyak::Reg64& scratch,
+                   const Xbyak::Xmm& xmm);
+
   Context* ctx_;
   railgun::Code* top_;
   railgun::Code* code_;
@@ -562,12 +609,17 @@ class Compiler {
   const Instruction* previous_instr_;
   int32_t last_used_;
   int32_t last_used_candidate_;
+  int32_t last_double_;
+  int32_t last_double_candidate_;
   TypeRecord type_record_;
 };
 
 // external interfaces
 void Compile(Context* ctx, railgun::Code* code);
 
+// compile function code which becomes hot in tiered execution
+void CompileHotCode(Context* ctx, railgun::Code* code);
+
 railgun::Code* CompileGlobal(
     Context* ctx,
     const FunctionLiteral& global, railgun::JSScript* script);
@@ -36,6 +36,10 @@ void Compiler::EmitBINARY_MULTIPLY(const Instruction* instr) {
     return;
   }
 
+  // result is always number,
+  // so it is carried to the next instruction as unboxed double
+  const bool carry = dst_type.IsNumber() && IsDoubleCarried(instr, dst);
+
   const Assembler::LocalLabelScope scope(asm_);
   Xbyak::Label exit;
 
@@ -59,6 +63,9 @@ void Compiler::EmitBINARY_MULTIPLY(const Instruction* instr) {
       asm_->imul(eax, edx);
       asm_->jo(".OVERFLOW");
     }
+    if (carry) {
+      asm_->cvtsi2sd(xmm7, eax);
+    }
     // boxing
     asm_->or(rax, r15);
     asm_->jmp(exit, Xbyak::CodeGenerator::T_NEAR);
@@ -72,6 +79,9 @@ void Compiler::EmitBINARY_MULTIPLY(const Instruction* instr) {
     asm_->cvtsi2sd(xmm1, edx);
     asm_->mulsd(xmm0, xmm1);
     asm_->movq(rax, xmm0);
+    if (carry) {
+      asm_->movapd(xmm7, xmm0);
+    }
     ConvertDoubleToJSVal(rax);
     asm_->jmp(exit, Xbyak::CodeGenerator::T_NEAR);
   }
@@ -82,6 +92,9 @@ void Compiler::EmitBINARY_MULTIPLY(const Instruction* instr) {
   LoadDouble(rhs, xmm1, rsi, &generic);
 
   asm_->mulsd(xmm0, xmm1);
+  if (carry) {
+    asm_->movapd(xmm7, xmm0);
+  }
   BoxDouble(xmm0, xmm1, rax, &exit);
 
   kill_last_used();
@@ -90,10 +103,16 @@ void Compiler::EmitBINARY_MULTIPLY(const Instruction* instr) {
   LoadVRs(rsi, lhs, rdx, rhs);
   asm_->mov(rdi, r14);
   asm_->Call(&stub::BINARY_MULTIPLY);
+  if (carry) {
+    UnboxNumber(rax, rcx, xmm7);
+  }
 
   asm_->L(exit);
   asm_->mov(qword[r13 + dst * kJSValSize], rax);
   set_last_used_candidate(dst);
+  if (carry) {
+    set_last_double_candidate(dst);
+  }
   type_record_.Put(dst, dst_type);
 }
 
@@ -114,6 +133,10 @@ void Compiler::EmitBINARY_DIVIDE(const Instruction* instr) {
     return;
   }
 
+  // result is always number,
+  // so it is carried to the next instruction as unboxed double
+  const bool carry = dst_type.IsNumber() && IsDoubleCarried(instr, dst);
+
   const Assembler::LocalLabelScope scope(asm_);
   Xbyak::Label exit;
 
@@ -122,6 +145,9 @@ void Compiler::EmitBINARY_DIVIDE(const Instruction* instr) {
   LoadDouble(rhs, xmm1, rsi, &generic);
 
   asm_->divsd(xmm0, xmm1);
+  if (carry) {
+    asm_->movapd(xmm7, xmm0);
+  }
   BoxDouble(xmm0, xmm1, rax, &exit);
 
   kill_last_used();
@@ -130,10 +156,16 @@ void Compiler::EmitBINARY_DIVIDE(const Instruction* instr) {
   LoadVRs(rsi, lhs, rdx, rhs);
   asm_->mov(rdi, r14);
   asm_->Call(&stub::BINARY_DIVIDE);
+  if (carry) {
+    UnboxNumber(rax, rcx, xmm7);
+  }
 
   asm_->L(exit);
   asm_->mov(qword[r13 + dst * kJSValSize], rax);
   set_last_used_candidate(dst);
+  if (carry) {
+    set_last_double_candidate(dst);
+  }
   type_record_.Put(dst, dst_type);
 }
 
@@ -154,6 +186,12 @@ void Compiler::EmitBINARY_ADD(const Instruction* instr) {
     return;
   }
 
+  // result is always number when both operands are number,
+  // so it is carried to the next instruction as unboxed double
+  const bool carry =
+      lhs_type.IsNumber() && rhs_type.IsNumber() &&
+      IsDoubleCarried(instr, dst);
+
   const Assembler::LocalLabelScope scope(asm_);
   Xbyak::Label exit;
 
@@ -177,6 +215,9 @@ void Compiler::EmitBINARY_ADD(const Instruction* instr) {
       asm_->add(eax, edx);
       asm_->jo(".OVERFLOW");
     }
+    if (carry) {
+      asm_->cvtsi2sd(xmm7, eax);
+    }
     // boxing
     asm_->or(rax, r15);
     asm_->jmp(exit, Xbyak::CodeGenerator::T_NEAR);
@@ -191,6 +232,9 @@ void Compiler::EmitBINARY_ADD(const Instruction* instr) {
     asm_->add(rax, rdx);
     asm_->cvtsi2sd(xmm0, rax);
     asm_->movq(rax, xmm0);
+    if (carry) {
+      asm_->movapd(xmm7, xmm0);
+    }
     ConvertDoubleToJSVal(rax);
     asm_->jmp(exit, Xbyak::CodeGenerator::T_NEAR);
   }
@@ -201,6 +245,9 @@ void Compiler::EmitBINARY_ADD(const Instruction* instr) {
   LoadDouble(rhs, xmm1, rsi, &generic);
 
   asm_->addsd(xmm0, xmm1);
+  if (carry) {
+    asm_->movapd(xmm7, xmm0);
+  }
   BoxDouble(xmm0, xmm1, rax, &exit);
 
   kill_last_used();
@@ -209,10 +256,16 @@ void Compiler::EmitBINARY_ADD(const Instruction* instr) {
   LoadVRs(rsi, lhs, rdx, rhs);
   asm_->mov(rdi, r14);
   asm_->Call(&stub::BINARY_ADD);
+  if (carry) {
+    UnboxNumber(rax, rcx, xmm7);
+  }
 
   asm_->L(exit);
   asm_->mov(qword[r13 + dst * kJSValSize], rax);
   set_last_used_candidate(dst);
+  if (carry) {
+    set_last_double_candidate(dst);
+  }
   type_record_.Put(dst, dst_type);
 }
 
@@ -323,6 +376,10 @@ void Compiler::EmitBINARY_SUBTRACT(const Instruction* instr) {
     return;
   }
 
+  // result is always number,
+  // so it is carried to the next instruction as unboxed double
+  const bool carry = dst_type.IsNumber() && IsDoubleCarried(instr, dst);
+
   const Assembler::LocalLabelScope scope(asm_);
   Xbyak::Label exit;
 
@@ -340,6 +397,9 @@ void Compiler::EmitBINARY_SUBTRACT(const Instruction* instr) {
       asm_->sub(eax, edx);
       asm_->jo(".OVERFLOW");
     }
+    if (carry) {
+      asm_->cvtsi2sd(xmm7, eax);
+    }
     // boxing
     asm_->or(rax, r15);
     asm_->jmp(exit, Xbyak::CodeGenerator::T_NEAR);
@@ -357,6 +417,9 @@ void Compiler::EmitBINARY_SUBTRACT(const Instruction* instr) {
     asm_->sub(rax, rdx);
     asm_->cvtsi2sd(xmm0, rax);
     asm_->movq(rax, xmm0);
+    if (carry) {
+      asm_->movapd(xmm7, xmm0);
+    }
     ConvertDoubleToJSVal(rax);
     asm_->jmp(exit, Xbyak::CodeGenerator::T_NEAR);
   }
@@ -367,6 +430,9 @@ void Compiler::EmitBINARY_SUBTRACT(const Instruction* instr) {
   LoadDouble(rhs, xmm1, rsi, &generic);
 
   asm_->subsd(xmm0, xmm1);
+  if (carry) {
+    asm_->movapd(xmm7, xmm0);
+  }
   BoxDouble(xmm0, xmm1, rax, &exit);
 
   kill_last_used();
@@ -375,10 +441,16 @@ void Compiler::EmitBINARY_SUBTRACT(const Instruction* instr) {
   LoadVRs(rsi, lhs, rdx, rhs);
   asm_->mov(rdi, r14);
   asm_->Call(&stub::BINARY_SUBTRACT);
+  if (carry) {
+    UnboxNumber(rax, rcx, xmm7);
+  }
 
   asm_->L(exit);
   asm_->mov(qword[r13 + dst * kJSValSize], rax);
   set_last_used_candidate(dst);
+  if (carry) {
+    set_last_double_candidate(dst);
+  }
   type_record_.Put(dst, dst_type);
 }
 
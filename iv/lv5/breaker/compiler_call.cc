@@ -20,13 +20,18 @@ namespace iv {
 namespace lv5 {
 namespace breaker {
 
-// opcode | (callee | offset | argc_with_this)
+// opcode | (callee | offset | argc_with_this) | callee
 void Compiler::EmitCALL(const Instruction* instr) {
   const register_t callee = Reg(instr[1].ssw.i16[0]);
   const register_t offset = Reg(instr[1].ssw.i16[1]);
   const uint32_t argc_with_this = instr[1].ssw.u32;
   {
     const Assembler::LocalLabelScope scope(asm_);
+    if (JSFunction* func = InlineTarget(instr)) {
+      Xbyak::Label generic;
+      EmitInlineCALL(instr, func, generic);
+      asm_->L(generic);
+    }
     asm_->mov(rdi, r14);
     LoadVR(rsi, callee);
     assert(!IsConstantID(offset));
@@ -80,6 +85,11 @@ void Compiler::EmitCONSTRUCT(const Instruction* instr) {
     // call function
     asm_->call(rax);
 
+    // record slots size of this object to function
+    asm_->mov(rdi, r13);
+    asm_->mov(rsi, rax);
+    asm_->Call(&stub::CONSTRUCT_RETURN);
+
     // unwind Frame
     asm_->mov(rdx, ptr[r13 + kJSValSize * Reg(railgun::FrameConstant<>::kThisOffset)]);  // NOLINT
     asm_->mov(r13, ptr[r13 + offsetof(railgun::Frame, prev_)]);  // current frame
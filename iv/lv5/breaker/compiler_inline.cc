@@ -0,0 +1,452 @@
+// inlining of small user functions at CALL sites
+//
+// railgun records the callee of each CALL site in its instruction stream
+// (see railgun::VM::RecordCallee). when breaker compiles hot code in tiered
+// execution and the site has seen only one user function whose body is short
+// straight-line code built from the opcodes accepted by IsInlinableCode,
+// the callee body is emitted at the call site, guarded by callee identity.
+//
+// inlined code never calls stubs and never writes caller registers.
+// every guard failure (callee mismatch, non int32 operand, overflow, map
+// mismatch, stack shortage) jumps to the generic CALL sequence before any
+// visible side effect, and the generic call executes the callee from its
+// start again.
+#include <iv/platform.h>
+#if !defined(IV_ENABLE_JIT)
+#include <iv/dummy_cc.h>
+IV_DUMMY_CC()
+#else
+
+#include <iv/debug.h>
+#include <iv/lv5/jsval.h>
+#include <iv/lv5/jsobject.h>
+#include <iv/lv5/railgun/railgun.h>
+#include <iv/lv5/railgun/instruction.h>
+#include <iv/lv5/breaker/fwd.h>
+#include <iv/lv5/breaker/helper.h>
+#include <iv/lv5/breaker/assembler.h>
+#include <iv/lv5/breaker/ic.h>
+#include <iv/lv5/breaker/mono_ic.h>
+#include <iv/lv5/breaker/compiler.h>
+namespace iv {
+namespace lv5 {
+namespace breaker {
+namespace {
+
+static const std::size_t kMaxInlineInstructions = 8;
+
+// callee registers readable from inlined code
+bool IsInlinableOperand(register_t reg) {
+  if (Compiler::IsConstantID(Compiler::Reg(reg))) {
+    return true;
+  }
+  // temporaries, this and parameters.
+  // frame header registers are not materialized in inlined code
+  return reg >= 0 || reg <= railgun::FrameConstant<>::kThisOffset;
+}
+
+bool IsInlinableInt32Operand(const railgun::Code* code, register_t reg) {
+  if (!IsInlinableOperand(reg)) {
+    return false;
+  }
+  const register_t r = Compiler::Reg(reg);
+  if (!Compiler::IsConstantID(r)) {
+    return true;
+  }
+  return code->constants()[Compiler::ExtractConstantOffset(r)].IsInt32();
+}
+
+// constant operand which strict equality can compare by its bits
+bool IsIdentityConstant(const railgun::Code* code, register_t reg) {
+  const register_t r = Compiler::Reg(reg);
+  if (!Compiler::IsConstantID(r)) {
+    return false;
+  }
+  const JSVal val = code->constants()[Compiler::ExtractConstantOffset(r)];
+  return val.IsUndefined() || val.IsNull() || val.IsBoolean();
+}
+
+bool IsInlinableCode(const railgun::Code* code) {
+  typedef railgun::Instruction Instruction;
+  typedef railgun::OP OP;
+  if (code->lazy()) {
+    // bytecode is not emitted yet
+    return false;
+  }
+  if (code->empty()) {
+    return true;
+  }
+  if (code->heap_size() != 0 || code->needs_declarative_environment()) {
+    return false;
+  }
+  std::size_t count = 0;
+  for (const Instruction* instr = code->begin(),
+       *last = code->end(); instr != last && count < kMaxInlineInstructions;
+       instr += railgun::kOPLength[instr->GetOP()], ++count) {
+    switch (instr->GetOP()) {
+      case OP::NOP:
+      case OP::ENTER:
+        break;
+
+      case OP::MV:
+      case OP::MV_RETURN:
+        if (instr[1].i16[0] < 0 || !IsInlinableOperand(instr[1].i16[1])) {
+          return false;
+        }
+        break;
+
+      case OP::LOAD_CONST:
+      case OP::LOAD_CONST_BINARY_ADD:
+      case OP::LOAD_CONST_BINARY_SUBTRACT:
+        if (instr[1].ssw.i16[0] < 0) {
+          return false;
+        }
+        break;
+
+      case OP::BINARY_ADD:
+      case OP::BINARY_ADD_RETURN:
+      case OP::BINARY_SUBTRACT:
+      case OP::BINARY_MULTIPLY:
+      case OP::BINARY_LT:
+      case OP::BINARY_LTE:
+      case OP::BINARY_GT:
+      case OP::BINARY_GTE:
+        if (instr[1].i16[0] < 0 ||
+            !IsInlinableInt32Operand(code, instr[1].i16[1]) ||
+            !IsInlinableInt32Operand(code, instr[1].i16[2])) {
+          return false;
+        }
+        break;
+
+      case OP::BINARY_STRICT_EQ:
+      case OP::BINARY_STRICT_NE: {
+        const register_t lhs = instr[1].i16[1];
+        const register_t rhs = instr[1].i16[2];
+        if (instr[1].i16[0] < 0 ||
+            !IsInlinableOperand(lhs) || !IsInlinableOperand(rhs)) {
+          return false;
+        }
+        if (!IsIdentityConstant(code, lhs) &&
+            !IsIdentityConstant(code, rhs) &&
+            (!IsInlinableInt32Operand(code, lhs) ||
+             !IsInlinableInt32Operand(code, rhs))) {
+          return false;
+        }
+        break;
+      }
+
+      case OP::LOAD_PROP_OWN:
+        // LOAD_PROP_PROTO is not inlined since a unique map
+        // changes its prototype in place
+        if (instr[1].ssw.i16[0] < 0 ||
+            !IsInlinableOperand(instr[1].ssw.i16[1]) ||
+            !instr[2].map) {
+          return false;
+        }
+        break;
+
+      case OP::RETURN:
+        return IsInlinableOperand(instr[1].i32[0]);
+
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+}  // namespace anonymous
+
+// maps callee registers of the inlined body to caller frame slots.
+// arguments and this are read from the caller's argument area,
+// temporaries are placed where the callee frame would be built
+class Compiler::InlineFrame {
+ public:
+  static const register_t kNone = INT16_MIN;
+
+  InlineFrame(Assembler* as,
+              railgun::Code* code,
+              register_t offset, uint32_t argc_with_this)
+    : asm_(as),
+      code_(code),
+      offset_(offset),
+      argc_with_this_(argc_with_this),
+      written_(code->FrameSize(), false),
+      cached_(kNone) {
+  }
+
+  // slot of the caller frame, which is addressed from r13
+  register_t Slot(register_t reg) const {
+    return offset_ + argc_with_this_ + Reg(reg);
+  }
+
+  void Load(const Xbyak::Reg64& out, register_t reg) {
+    const register_t r = Reg(reg);
+    if (IsConstantID(r)) {
+      asm_->mov(out, Extract(code_->constants()[ExtractConstantOffset(r)]));
+    } else if (reg >= 0) {
+      if (reg == cached_) {
+        if (out.getIdx() != rax.getIdx()) {
+          asm_->mov(out, rax);
+        }
+        return;
+      }
+      if (written_[reg]) {
+        asm_->mov(out, qword[r13 + Slot(reg) * kJSValSize]);
+      } else {
+        asm_->mov(out, Extract(JSUndefined));
+      }
+    } else if (reg == railgun::FrameConstant<>::kThisOffset) {
+      asm_->mov(out, qword[r13 + ThisSlot() * kJSValSize]);
+    } else {
+      const uint32_t arg =
+          railgun::FrameConstant<>::ConvertRegisterToArg(reg);
+      if (arg + 1 < argc_with_this_) {
+        const register_t slot = offset_ + argc_with_this_ - 2 - arg;
+        asm_->mov(out, qword[r13 + slot * kJSValSize]);
+      } else {
+        // missing argument
+        asm_->mov(out, Extract(JSUndefined));
+      }
+    }
+    if (out.getIdx() == rax.getIdx()) {
+      cached_ = kNone;
+    }
+  }
+
+  // result is in rax
+  void Store(register_t reg) {
+    assert(reg >= 0);
+    written_[reg] = true;
+    asm_->mov(qword[r13 + Slot(reg) * kJSValSize], rax);
+    cached_ = reg;
+  }
+
+  register_t ThisSlot() const {
+    return offset_ + argc_with_this_ - 1;
+  }
+
+  bool IsInt32Constant(register_t reg) const {
+    const register_t r = Reg(reg);
+    return IsConstantID(r) &&
+        code_->constants()[ExtractConstantOffset(r)].IsInt32();
+  }
+
+  void Int32Guard(register_t reg,
+                  const Xbyak::Reg64& target, const Xbyak::Label& generic) {
+    if (!IsInt32Constant(reg)) {
+      asm_->cmp(target, r15);
+      asm_->jb(generic, Xbyak::CodeGenerator::T_NEAR);
+    }
+  }
+
+ private:
+  Assembler* asm_;
+  railgun::Code* code_;
+  register_t offset_;
+  uint32_t argc_with_this_;
+  std::vector<bool> written_;
+  register_t cached_;
+};
+
+JSFunction* Compiler::InlineTarget(const Instruction* instr) const {
+  JSFunction* callee = instr[2].callee;
+  if (!callee || callee == Instruction::PolymorphicCallee()) {
+    return nullptr;
+  }
+  if (callee->function_type() != JSFunction::FUNCTION_USER) {
+    return nullptr;
+  }
+  if (!IsInlinableCode(static_cast<JSJITFunction*>(callee)->code())) {
+    return nullptr;
+  }
+  return callee;
+}
+
+// opcode | (callee | offset | argc_with_this) | callee
+void Compiler::EmitInlineCALL(const Instruction* instr,
+                              JSFunction* func,
+                              const Xbyak::Label& generic) {
+  const register_t callee = Reg(instr[1].ssw.i16[0]);
+  const register_t offset = Reg(instr[1].ssw.i16[1]);
+  const uint32_t argc_with_this = instr[1].ssw.u32;
+  railgun::Code* code = static_cast<JSJITFunction*>(func)->code();
+  InlinedCallIC* ic = new InlinedCallIC(func);
+  native_code()->BindIC(ic);
+
+  kill_last_used();
+
+  // callee identity guard
+  helper::CmpConstant(asm_, qword[r13 + callee * kJSValSize],
+                      Extract(JSVal(func)), rax);
+  asm_->jne(generic, Xbyak::CodeGenerator::T_NEAR);
+
+  if (code->empty()) {
+    asm_->mov(rax, Extract(JSUndefined));
+    asm_->jmp(".CALL_EXIT", Xbyak::CodeGenerator::T_NEAR);
+    return;
+  }
+
+  InlineFrame frame(asm_, code, offset, argc_with_this);
+
+  // temporaries are placed on the callee frame area,
+  // so check stack space as NewCodeFrame does
+  asm_->mov(rax, qword[r12 + (railgun::Context::VMOffset() + railgun::VM::StackOffset() + railgun::Stack::StackBaseOffset())]);  // NOLINT
+  asm_->add(rax, static_cast<uint32_t>(railgun::Stack::kStackBytes));
+  asm_->lea(rcx, ptr[r13 + frame.Slot(code->FrameSize()) * kJSValSize]);
+  asm_->cmp(rcx, rax);
+  asm_->ja(generic, Xbyak::CodeGenerator::T_NEAR);
+
+  // this binding is converted by ENTER in sloppy code.
+  // only object this, which is not converted, is accepted
+  if (code->IsThisMaterialized() && !code->strict()) {
+    asm_->mov(rsi, qword[r13 + frame.ThisSlot() * kJSValSize]);
+    helper::TestConstant(asm_, rsi, detail::jsval64::kValueMask, rdi);
+    asm_->jnz(generic, Xbyak::CodeGenerator::T_NEAR);
+    const std::ptrdiff_t class_offset =
+        IV_CAST_OFFSET(radio::Cell*, JSObject*) + JSObject::ClassOffset();
+    asm_->cmp(qword[rsi + class_offset], 0);
+    asm_->je(generic, Xbyak::CodeGenerator::T_NEAR);
+  }
+
+  for (const Instruction* it = code->begin(); ;
+       it += railgun::kOPLength[it->GetOP()]) {
+    switch (it->GetOP()) {
+      case OP::NOP:
+      case OP::ENTER:
+        break;
+
+      case OP::MV:
+      case OP::MV_RETURN: {
+        frame.Load(rax, it[1].i16[1]);
+        frame.Store(it[1].i16[0]);
+        break;
+      }
+
+      case OP::LOAD_CONST:
+      case OP::LOAD_CONST_BINARY_ADD:
+      case OP::LOAD_CONST_BINARY_SUBTRACT: {
+        // opcode | (dst | offset)
+        asm_->mov(rax, Extract(code->constants()[it[1].ssw.u32]));
+        frame.Store(it[1].ssw.i16[0]);
+        break;
+      }
+
+      case OP::BINARY_ADD:
+      case OP::BINARY_ADD_RETURN:
+      case OP::BINARY_SUBTRACT: {
+        const register_t lhs = it[1].i16[1];
+        const register_t rhs = it[1].i16[2];
+        frame.Load(rax, lhs);
+        frame.Load(rdx, rhs);
+        frame.Int32Guard(lhs, rax, generic);
+        frame.Int32Guard(rhs, rdx, generic);
+        if (it->GetOP() == OP::BINARY_SUBTRACT) {
+          asm_->sub(eax, edx);
+        } else {
+          asm_->add(eax, edx);
+        }
+        asm_->jo(generic, Xbyak::CodeGenerator::T_NEAR);
+        asm_->or(rax, r15);
+        frame.Store(it[1].i16[0]);
+        break;
+      }
+
+      case OP::BINARY_MULTIPLY: {
+        const register_t lhs = it[1].i16[1];
+        const register_t rhs = it[1].i16[2];
+        frame.Load(rax, lhs);
+        frame.Load(rdx, rhs);
+        frame.Int32Guard(lhs, rax, generic);
+        frame.Int32Guard(rhs, rdx, generic);
+        Xbyak::Label non_zero;
+        asm_->mov(ecx, eax);
+        asm_->or(ecx, edx);
+        asm_->imul(eax, edx);
+        asm_->jo(generic, Xbyak::CodeGenerator::T_NEAR);
+        asm_->test(eax, eax);
+        asm_->jnz(non_zero);
+        // 0 * negative is -0, which is not int32
+        asm_->test(ecx, ecx);
+        asm_->js(generic, Xbyak::CodeGenerator::T_NEAR);
+        asm_->L(non_zero);
+        asm_->or(rax, r15);
+        frame.Store(it[1].i16[0]);
+        break;
+      }
+
+      case OP::BINARY_LT:
+      case OP::BINARY_LTE:
+      case OP::BINARY_GT:
+      case OP::BINARY_GTE: {
+        const register_t lhs = it[1].i16[1];
+        const register_t rhs = it[1].i16[2];
+        frame.Load(rax, lhs);
+        frame.Load(rdx, rhs);
+        frame.Int32Guard(lhs, rax, generic);
+        frame.Int32Guard(rhs, rdx, generic);
+        asm_->cmp(eax, edx);
+        switch (it->GetOP()) {
+          case OP::BINARY_LT: asm_->setl(cl); break;
+          case OP::BINARY_LTE: asm_->setle(cl); break;
+          case OP::BINARY_GT: asm_->setg(cl); break;
+          default: asm_->setge(cl); break;
+        }
+        ConvertBooleanToJSVal(cl, rax);
+        frame.Store(it[1].i16[0]);
+        break;
+      }
+
+      case OP::BINARY_STRICT_EQ:
+      case OP::BINARY_STRICT_NE: {
+        const register_t lhs = it[1].i16[1];
+        const register_t rhs = it[1].i16[2];
+        frame.Load(rax, lhs);
+        frame.Load(rdx, rhs);
+        if (!IsIdentityConstant(code, lhs) && !IsIdentityConstant(code, rhs)) {
+          // double values are not compared by their bits
+          frame.Int32Guard(lhs, rax, generic);
+          frame.Int32Guard(rhs, rdx, generic);
+        }
+        asm_->cmp(rax, rdx);
+        if (it->GetOP() == OP::BINARY_STRICT_EQ) {
+          asm_->sete(cl);
+        } else {
+          asm_->setne(cl);
+        }
+        ConvertBooleanToJSVal(cl, rax);
+        frame.Store(it[1].i16[0]);
+        break;
+      }
+
+      case OP::LOAD_PROP_OWN: {
+        // opcode | (dst | base | name) | map | offset | nop
+        Map* map = it[2].map;
+        ic->AddMap(map);
+        frame.Load(rsi, it[1].ssw.i16[1]);
+        helper::TestConstant(asm_, rsi, detail::jsval64::kValueMask, r10);
+        asm_->jnz(generic, Xbyak::CodeGenerator::T_NEAR);
+        const std::size_t map_offset =
+            IV_CAST_OFFSET(radio::Cell*, JSCell*) + JSCell::MapOffset();
+        helper::CmpConstant(asm_, qword[rsi + map_offset],
+                            core::BitCast<uintptr_t>(map), r10);
+        asm_->jne(generic, Xbyak::CodeGenerator::T_NEAR);
+        asm_->mov(rax, IC::SlotAddress(asm_, rsi, rax, it[3].u32[0]));
+        frame.Store(it[1].ssw.i16[0]);
+        break;
+      }
+
+      case OP::RETURN: {
+        frame.Load(rax, it[1].i32[0]);
+        asm_->jmp(".CALL_EXIT", Xbyak::CodeGenerator::T_NEAR);
+        return;
+      }
+
+      default:
+        UNREACHABLE();
+    }
+  }
+}
+
+} } }  // namespace iv::lv5::breaker
+#endif
@@ -4,6 +4,7 @@
 #include <iv/lv5/railgun/railgun.h>
 #include <iv/lv5/breaker/context_fwd.h>
 #include <iv/lv5/breaker/jsfunction.h>
+#include <iv/lv5/breaker/compiler.h>
 namespace iv {
 namespace lv5 {
 namespace breaker {
@@ -12,5 +13,28 @@ inline JSFunction* Context::NewFunction(railgun::Code* code, JSEnv* env) {
   return breaker::JSJITFunction::New(this, code, env);
 }
 
+inline void Context::TierUp(railgun::Code* code) {
+  CompileHotCode(this, code);
+}
+
+inline bool Context::OnStackReplace(railgun::Frame* frame,
+                                    const railgun::Instruction* target,
+                                    JSVal* result, Error* e) {
+  railgun::Code* code = frame->code();
+  void* entry =
+      code->native_code()->OSREntry(target - code->begin());
+  if (!entry) {
+    return false;
+  }
+  // native code unwinds frames until the frame invoked by native function
+  // when exception is not handled, so this frame behaves as it while
+  // executing native code
+  railgun::Instruction* prev_pc = frame->prev_pc_;
+  frame->prev_pc_ = nullptr;
+  *result = breaker_prologue(this, frame, entry, e);
+  frame->prev_pc_ = prev_pc;
+  return true;
+}
+
 } } }  // namespace iv::lv5::breaker
 #endif  // IV_LV5_BREAKER_CONTEXT_H_
@@ -8,11 +8,20 @@ namespace breaker {
 
 class Context : public railgun::Context {
  public:
+  // hot code counter threshold used by lv5 --tiered
+  static const uint32_t kDefaultTierUpThreshold = 1000;
+
   Context()
     : railgun::Context(FunctionConstructor, GlobalEval) {
   }
 
   virtual JSFunction* NewFunction(railgun::Code* code, JSEnv* env);
+
+  virtual void TierUp(railgun::Code* code);
+
+  virtual bool OnStackReplace(railgun::Frame* frame,
+                              const railgun::Instruction* target,
+                              JSVal* result, Error* e);
 };
 
 } } }  // namespace iv::lv5::breaker
@@ -12,6 +12,10 @@ inline JSVal RunEval(Context* ctx,
                      JSEnv* lexical_env,
                      JSVal this_binding,
                      Error* e) {
+  if (!code->executable()) {
+    // in tiered execution, global and eval code are interpreted
+    return ctx->vm()->RunEval(code, variable_env, lexical_env, this_binding, e);
+  }
   ScopedArguments args(ctx, 0, IV_LV5_ERROR(e));
   args.set_this_binding(this_binding);
   railgun::Frame* frame = ctx->vm()->stack()->NewEvalFrame(
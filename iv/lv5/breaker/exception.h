@@ -18,7 +18,7 @@ inline void* SearchExceptionHandler(void* pc, void** rsp,
   assert(*e);
   railgun::Code* raised_code = frame->code();
   const std::size_t bytecode_offset =
-      raised_code->core_data()->native_code()->PCToBytecodeOffset(pc);
+      raised_code->native_code()->PCToBytecodeOffset(pc);
   frame->MaterializeErrorStack(
       ctx, e, raised_code->core_data()->data()->data() + bytecode_offset);
   while (true) {
@@ -3,6 +3,7 @@
 #include <iv/lv5/breaker/fwd.h>
 #include <iv/lv5/breaker/helper.h>
 #include <iv/lv5/radio/core.h>
+#include <iv/lv5/jsobject_fwd.h>
 namespace iv {
 namespace lv5 {
 namespace breaker {
@@ -72,6 +73,30 @@ class IC {
     return packed;
   }
 
+  // address of named property slot of the object in obj register.
+  // inline slot is addressed from obj directly, out-of-line slot is
+  // addressed from tmp register, which is loaded with Slots data pointer
+  static Xbyak::Address SlotAddress(
+      Xbyak::CodeGenerator* as,
+      const Xbyak::Reg64& obj,
+      const Xbyak::Reg64& tmp,
+      uint32_t offset) {
+    const std::ptrdiff_t cell_to_jsobject =
+        IV_CAST_OFFSET(radio::Cell*, JSObject*);
+    if (JSObject::IsInlineSlot(offset)) {
+      return qword[obj +
+                   cell_to_jsobject +
+                   JSObject::InlineSlotsOffset() +
+                   kJSValSize * offset];
+    }
+    const std::ptrdiff_t data_offset =
+        cell_to_jsobject +
+        JSObject::SlotsOffset() +
+        JSObject::Slots::DataOffset();
+    as->mov(tmp, qword[obj + data_offset]);
+    return qword[tmp + kJSValSize * JSObject::OutOfLineSlot(offset)];
+  }
+
   Type type() const { return type_; }
 
  private:
@@ -16,16 +16,24 @@ namespace breaker {
 class JSJITFunction : public railgun::JSVMFunction {
  public:
   virtual JSVal Call(Arguments* args, JSVal this_binding, Error* e) {
+    Context* const ctx = static_cast<Context*>(args->ctx());
     args->set_this_binding(this_binding);
-    return breaker::Execute(static_cast<Context*>(args->ctx()), args, this, e);
+    if (code()->lazy()) {
+      railgun::CompileLazyCode(ctx, code());
+    }
+    if (!code()->executable() && !ctx->vm()->CountHotCode(code())) {
+      // in tiered execution, code is interpreted until it becomes hot
+      return ctx->vm()->Execute(args, this, e);
+    }
+    return breaker::Execute(ctx, args, this, e);
   }
 
   virtual JSVal Construct(Arguments* args, Error* e) {
     Context* const ctx = static_cast<Context*>(args->ctx());
-    Map* map = construct_map(ctx, IV_LV5_ERROR(e));
-    JSObject* const obj = JSObject::New(ctx, map);
+    JSObject* const obj = NewConstructObject(ctx, IV_LV5_ERROR(e));
     assert(args->IsConstructorCalled());
     const JSVal val = JSJITFunction::Call(args, obj, IV_LV5_ERROR(e));
+    RecordConstructSlots(obj);
     if (!val.IsObject()) {
       return obj;
     }
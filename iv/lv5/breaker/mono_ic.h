@@ -21,8 +21,10 @@ class GlobalIC : public MonoIC {
   GlobalIC(bool strict)
     : MonoIC(),
       map_position_(),
+      base_position_(),
       offset_position_(),
       map_(nullptr),
+      inline_slots_(nullptr),
       strict_(strict) {
   }
 
@@ -33,10 +35,8 @@ class GlobalIC : public MonoIC {
     map_position_ = IC::TestMap(as, nullptr, rax, rdx, ".SLOW");
 
     const uint32_t dummy32 = 0x7FFF0000;
-    const std::ptrdiff_t data_offset =
-        JSObject::SlotsOffset() +
-        JSObject::Slots::DataOffset();
-    as->mov(rax, qword[rax + data_offset]);
+    base_position_ = helper::Generate64Mov(as, rax);
+    as->mov(rax, qword[rax]);
     offset_position_ = as->size() + kMovAddressImmOffset;
     as->mov(rax, qword[rax + dummy32]);
     as->jmp(".EXIT");
@@ -59,10 +59,8 @@ class GlobalIC : public MonoIC {
     map_position_ = IC::TestMap(as, nullptr, rcx, rdx, ".SLOW");
 
     const uint32_t dummy32 = 0x7FFF0000;
-    const std::ptrdiff_t data_offset =
-        JSObject::SlotsOffset() +
-        JSObject::Slots::DataOffset();
-    as->mov(rcx, qword[rcx + data_offset]);
+    base_position_ = helper::Generate64Mov(as, rcx);
+    as->mov(rcx, qword[rcx]);
     offset_position_ = as->size() + kMovAddressImmOffset;
     as->mov(qword[rcx + dummy32], rax);
     as->jmp(".EXIT");
@@ -78,15 +76,33 @@ class GlobalIC : public MonoIC {
     as->L(".EXIT");
   }
 
-  void Repatch(Assembler* as, Map* map, uint32_t offset) {
-    if (offset <= GlobalIC::kMaxOffset) {
+  // cached code loads the slots base pointer from the patched address and
+  // accesses the slot with the patched displacement. the base pointer is
+  // held in the global object for out-of-line slots and in this IC for
+  // inline slots
+  void Repatch(Assembler* as, JSObject* global, uint32_t offset) {
+    uintptr_t base;
+    std::size_t displacement;
+    if (JSObject::IsInlineSlot(offset)) {
+      inline_slots_ = &global->Direct(0);
+      base = core::BitCast<uintptr_t>(&inline_slots_);
+      displacement = offset * sizeof(JSVal);
+    } else {
+      base = core::BitCast<uintptr_t>(global) +
+          JSObject::SlotsOffset() + JSObject::Slots::DataOffset();
+      displacement = JSObject::OutOfLineSlot(offset) * sizeof(JSVal);
+    }
+    if (displacement <= GlobalIC::kMaxOffset) {
+      Map* map = global->map();
       as->rewrite(map_position(), core::BitCast<uint64_t>(map), k64Size);
-      as->rewrite(offset_position(), offset, k32Size);
+      as->rewrite(base_position(), base, k64Size);
+      as->rewrite(offset_position(), displacement, k32Size);
       map_ = map;
     }
   }
 
   std::size_t map_position() const { return map_position_; }
+  std::size_t base_position() const { return base_position_; }
   std::size_t offset_position() const { return offset_position_; }
   bool strict() const { return strict_; }
 
@@ -104,10 +120,54 @@ class GlobalIC : public MonoIC {
 
  private:
   std::size_t map_position_;
+  std::size_t base_position_;
   std::size_t offset_position_;
   Map* map_;
+  JSVal* inline_slots_;
   bool strict_;
 };
 
+// guards of inlined CALL site.
+// inlined native code embeds the callee function and the maps of
+// LOAD_PROP_OWN in the callee body, so this IC keeps them alive
+class InlinedCallIC : public MonoIC {
+ public:
+  explicit InlinedCallIC(JSFunction* callee)
+    : MonoIC(),
+      callee_(callee),
+      maps_() {
+  }
+
+  void AddMap(Map* map) { maps_.push_back(map); }
+
+  virtual void MarkChildren(radio::Core* core) {
+    core->MarkCell(callee_);
+    for (Maps::const_iterator it = maps_.begin(),
+         last = maps_.end(); it != last; ++it) {
+      core->MarkCell(*it);
+    }
+  }
+
+  virtual GC_ms_entry* MarkChildren(GC_word* top,
+                                    GC_ms_entry* entry,
+                                    GC_ms_entry* mark_sp_limit,
+                                    GC_word env) {
+    entry = GC_MARK_AND_PUSH(
+        callee_, entry, mark_sp_limit, reinterpret_cast<void**>(this));
+    for (Maps::const_iterator it = maps_.begin(),
+         last = maps_.end(); it != last; ++it) {
+      entry = GC_MARK_AND_PUSH(
+          *it, entry, mark_sp_limit, reinterpret_cast<void**>(this));
+    }
+    return entry;
+  }
+
+ private:
+  typedef std::vector<Map*> Maps;
+
+  JSFunction* callee_;
+  Maps maps_;
+};
+
 } } }  // namespace iv::lv5::breaker
 #endif  // IV_BREAKER_MONO_IC_H_
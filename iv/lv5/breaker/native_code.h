@@ -1,5 +1,6 @@
 #ifndef IV_LV5_BREAKER_NATIVE_CODE_H_
 #define IV_LV5_BREAKER_NATIVE_CODE_H_
+#include <unordered_map>
 #include <iv/functor.h>
 #include <iv/lv5/breaker/assembler.h>
 
@@ -13,9 +14,11 @@ class NativeCode {
   typedef core::SortedVector<PCOffsetAndBytecodeOffset> BytecodeOffsets;
   typedef std::vector<IC*> ICVector;
   typedef ExecutablePages<> Pages;
+  typedef std::unordered_map<std::size_t, std::size_t> OSREntries;
 
   NativeCode(Assembler* as)
     : bytecode_offsets_(),
+      osr_entries_(),
       ics_(),
       pages_(),
       asm_() {
@@ -70,6 +73,20 @@ class NativeCode {
     }
   }
 
+  // entries of on-stack replacement
+  // maps bytecode offset of loop header to pc offset of its entry
+  void AttachOSREntry(std::size_t bytecode_offset, std::size_t pc_offset) {
+    osr_entries_[bytecode_offset] = pc_offset;
+  }
+
+  void* OSREntry(std::size_t bytecode_offset) const {
+    const OSREntries::const_iterator it = osr_entries_.find(bytecode_offset);
+    if (it == osr_entries_.end()) {
+      return nullptr;
+    }
+    return asm_->GainExecutableByOffset(it->second);
+  }
+
   void BindIC(IC* ic) {
     ics_.push_back(ic);
   }
@@ -100,6 +117,7 @@ class NativeCode {
 
  private:
   BytecodeOffsets bytecode_offsets_;
+  OSREntries osr_entries_;
   ICVector ics_;
   Pages pages_;
   std::unique_ptr<Assembler> asm_;
@@ -206,12 +206,7 @@ class LoadPropertyIC : public PropertyIC<LoadPropertyIC> {
   // load to rax
   static void GenerateFastLoad(Xbyak::CodeGenerator* as,
                                const Xbyak::Reg64& reg, uint32_t offset) {
-    const std::ptrdiff_t data_offset =
-        IV_CAST_OFFSET(radio::Cell*, JSObject*) +
-        JSObject::SlotsOffset() +
-        JSObject::Slots::DataOffset();
-    as->mov(rax, qword[reg + data_offset]);
-    as->mov(rax, qword[rax + kJSValSize * offset]);
+    as->mov(rax, IC::SlotAddress(as, reg, rax, offset));
     as->ret();
   }
 
@@ -405,11 +400,7 @@ class StorePropertyIC : public PropertyIC<StorePropertyIC> {
   }
 
   static void GenerateFastStore(Xbyak::CodeGenerator* as, const Xbyak::Reg64& reg, uint32_t offset) {
-    const std::ptrdiff_t data_offset =
-        JSObject::SlotsOffset() +
-        JSObject::Slots::DataOffset();
-    as->mov(rax, qword[reg + data_offset]);
-    as->mov(qword[rax + kJSValSize * offset], rdx);
+    as->mov(IC::SlotAddress(as, reg, rax, offset), rdx);
     as->ret();
   }
 
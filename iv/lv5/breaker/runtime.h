@@ -29,8 +29,7 @@ inline JSVal FunctionConstructor(const Arguments& args, Error* e) {
       internal::IsOneFunctionExpression(*eval, IV_LV5_ERROR(e));
   railgun::JSScript* script =
       railgun::JSSourceScript<EvalSource>::New(ctx, src);
-  railgun::Code* code = railgun::CompileFunction(ctx, *func, script, true);
-  Compile(ctx, code);
+  railgun::Code* code = CompileFunction(ctx, *func, script);
   return JSJITFunction::New(ctx, code, ctx->global_env());
 }
 
@@ -71,8 +70,7 @@ inline JSVal GlobalEval(const Arguments& args, Error* e) {
   }
   railgun::JSScript* script =
       railgun::JSSourceScript<EvalSource>::New(ctx, src);
-  railgun::Code* code = railgun::CompileIndirectEval(ctx, *eval, script, true);
-  Compile(ctx, code);
+  railgun::Code* code = CompileIndirectEval(ctx, *eval, script);
   return breaker::RunEval(
       ctx,
       code,
@@ -122,8 +120,7 @@ inline JSVal DirectCallToEval(const Arguments& args, railgun::Frame* frame, Erro
     }
     railgun::JSScript* script =
         railgun::JSSourceScript<EvalSource>::New(ctx, src);
-    code = railgun::CompileEval(ctx, *eval, script, true);
-    breaker::Compile(ctx, code);
+    code = CompileEval(ctx, *eval, script);
     if (!code->strict()) {
       ctx->direct_eval_map()->Insert(str, code);
     }
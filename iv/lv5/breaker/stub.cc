@@ -312,7 +312,7 @@ Rep LOAD_GLOBAL(Frame* stack, Symbol name, GlobalIC* ic, Assembler* as) {
   if (global->GetOwnPropertySlot(ctx, name, &slot)) {
     // now Own Property Pattern only implemented
     if (slot.IsLoadCacheable()) {
-      ic->Repatch(as, global->map(), slot.offset() * sizeof(JSVal));
+      ic->Repatch(as, global, slot.offset());
       return Extract(slot.value());
     }
     const JSVal ret = slot.Get(ctx, global, IV_LV5_BREAKER_ERR);
@@ -337,7 +337,7 @@ Rep STORE_GLOBAL(Frame* stack, Symbol name,
   Slot slot;
   if (global->GetOwnPropertySlot(ctx, name, &slot)) {
     if (slot.IsStoreCacheable()) {
-      ic->Repatch(as, global->map(), slot.offset() * sizeof(JSVal));
+      ic->Repatch(as, global, slot.offset());
       global->Direct(slot.offset()) = src;
     } else {
       global->Put(ctx, name, src, ic->strict(), IV_LV5_BREAKER_ERR);
@@ -382,7 +382,10 @@ RepPair CALL(Frame* stack,
   }
   JSFunction* func =
       static_cast<JSFunction*>(callee.object());
-  if (func->function_type() == JSFunction::FUNCTION_USER) {
+  // in tiered execution, code which is not compiled yet is called through
+  // JSJITFunction::Call, and interpreted until it becomes hot
+  if (func->function_type() == JSFunction::FUNCTION_USER &&
+      static_cast<JSJITFunction*>(func)->code()->executable()) {
     // call
     JSJITFunction* vm_func = static_cast<JSJITFunction*>(func);
     railgun::Code* code = vm_func->code();
@@ -428,7 +431,10 @@ RepPair EVAL(Frame* stack,
   }
   JSFunction* func =
       static_cast<JSFunction*>(callee.object());
-  if (func->function_type() == JSFunction::FUNCTION_USER) {
+  // in tiered execution, code which is not compiled yet is called through
+  // JSJITFunction::Call, and interpreted until it becomes hot
+  if (func->function_type() == JSFunction::FUNCTION_USER &&
+      static_cast<JSJITFunction*>(func)->code()->executable()) {
     // call
     JSJITFunction* vm_func = static_cast<JSJITFunction*>(func);
     railgun::Code* code = vm_func->code();
@@ -480,7 +486,10 @@ RepPair CONSTRUCT(Frame* stack,
   }
   JSFunction* func =
       static_cast<JSFunction*>(callee.object());
-  if (func->function_type() == JSFunction::FUNCTION_USER) {
+  // in tiered execution, code which is not compiled yet is called through
+  // JSJITFunction::Call, and interpreted until it becomes hot
+  if (func->function_type() == JSFunction::FUNCTION_USER &&
+      static_cast<JSJITFunction*>(func)->code()->executable()) {
     // call
     JSJITFunction* vm_func = static_cast<JSJITFunction*>(func);
     railgun::Code* code = vm_func->code();
@@ -497,8 +506,8 @@ RepPair CONSTRUCT(Frame* stack,
       stack->error->Report(Error::Range, "maximum call stack size exceeded");
       IV_LV5_BREAKER_RAISE_PAIR();
     }
-    Map* map = func->construct_map(ctx, IV_LV5_BREAKER_ERR_PAIR);
-    JSObject* const obj = JSObject::New(ctx, map);
+    JSObject* const obj =
+        func->NewConstructObject(ctx, IV_LV5_BREAKER_ERR_PAIR);
     new_frame->set_this_binding(obj);
     return Extract(code->executable(), new_frame);
   }
@@ -514,6 +523,13 @@ RepPair CONSTRUCT(Frame* stack,
   }
 }
 
+// constructor frame returned to native code. result is passed through
+Rep CONSTRUCT_RETURN(railgun::Frame* frame, JSVal result) {
+  static_cast<JSFunction*>(frame->callee().object())
+      ->RecordConstructSlots(frame->GetThis().object());
+  return Extract(result);
+}
+
 Rep CONCAT(Frame* stack, JSVal* src, uint32_t count) {
   JSString* result =
       JSString::NewCons(stack->ctx, src, count, IV_LV5_BREAKER_ERR);
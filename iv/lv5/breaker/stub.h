@@ -216,6 +216,8 @@ RepPair CONSTRUCT(Frame* stack,
                   uint64_t argc_with_this,
                   railgun::Instruction* instr);
 
+Rep CONSTRUCT_RETURN(railgun::Frame* frame, JSVal result);
+
 Rep CONCAT(Frame* stack, JSVal* src, uint32_t count);
 
 Rep RAISE(Frame* stack, Error::Code code, JSString* str);
@@ -8,10 +8,16 @@ extern "C" {
 #include <iv/conversions.h>
 #include <iv/unicode.h>
 #include <iv/date_utils.h>
+#include <iv/platform_io.h>
 #include <iv/lv5/error_check.h>
 #include <iv/lv5/jsval.h>
 #include <iv/lv5/error.h>
 #include <iv/lv5/arguments.h>
+#include <iv/lv5/jsobject.h>
+#include <iv/lv5/jsvector.h>
+#include <iv/lv5/bind.h>
+#include <iv/lv5/gc_statistics.h>
+#include <iv/lv5/heap_snapshot.h>
 namespace iv {
 namespace lv5 {
 
@@ -56,9 +62,64 @@ inline JSVal HiResTime(const Arguments& args, Error* e) {
 }
 
 inline JSVal CollectGarbage(const Arguments& args, Error* e) {
-  GC_gcollect();
+  GCCollect();
   return JSUndefined;
 }
 
+// gc.stats()
+// returns heap statistics and pause histogram of explicit collections.
+// pauses.histogram[i] counts pauses shorter than 2^i ms
+inline JSVal CollectGarbageStatistics(const Arguments& args, Error* e) {
+  Context* const ctx = args.ctx();
+  GCStatistics stats;
+  GetGCStatistics(&stats);
+  const int attr = ATTR::W | ATTR::E | ATTR::C;
+
+  JSVector* histogram = JSVector::New(ctx);
+  for (radio::PauseHistogram::Buckets::const_iterator
+       it = stats.pauses.buckets().begin(),
+       last = stats.pauses.buckets().end(); it != last; ++it) {
+    histogram->push_back(static_cast<double>(*it));
+  }
+  JSObject* const pauses = JSObject::New(ctx);
+  bind::Object(ctx, pauses)
+      .def("count", static_cast<double>(stats.pauses.count()), attr)
+      .def("total", stats.pauses.total(), attr)
+      .def("max", stats.pauses.max(), attr)
+      .def("last", stats.pauses.last(), attr)
+      .def("histogram", histogram->ToJSArray(), attr);
+
+  JSObject* const obj = JSObject::New(ctx);
+  bind::Object(ctx, obj)
+      .def("heapSize", static_cast<double>(stats.heap_size), attr)
+      .def("freeBytes", static_cast<double>(stats.free_bytes), attr)
+      .def("unmappedBytes", static_cast<double>(stats.unmapped_bytes), attr)
+      .def("bytesAllocatedSinceGC",
+           static_cast<double>(stats.bytes_allocated_since_gc), attr)
+      .def("totalBytes", static_cast<double>(stats.total_bytes), attr)
+      .def("collections", static_cast<double>(stats.collections), attr)
+      .def("fragmentation", stats.fragmentation(), attr)
+      .def("pauses", pauses, attr);
+  return obj;
+}
+
+// gc.snapshot(file)
+// writes heap snapshot reachable from global object to file,
+// see heap_snapshot.h for the format. returns the number of nodes
+inline JSVal CollectGarbageSnapshot(const Arguments& args, Error* e) {
+  Context* const ctx = args.ctx();
+  JSString* const file = args.At(0).ToString(ctx, IV_LV5_ERROR(e));
+  const std::string filename(file->GetUTF8());
+  std::FILE* out = core::io::OpenFile(filename, "wb");
+  if (!out) {
+    e->Report(Error::Type, "gc.snapshot can't open file");
+    return JSUndefined;
+  }
+  HeapSnapshot snapshot(ctx, out);
+  snapshot.WriteContextRoots();
+  std::fclose(out);
+  return static_cast<double>(snapshot.nodes());
+}
+
 } }  // namespace iv::lv5
 #endif  // IV_LV5_COMMAND_H_
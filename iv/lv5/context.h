@@ -109,6 +109,9 @@ class Context : public radio::HeapObject<radio::POINTER_CLEANUP> {
   core::i18n::I18N* i18n() { return &i18n_; }
 
   JSObject* intl() const { return intl_; }
+
+  // eval function of this context, used to detect direct call to eval
+  JSAPI global_eval() const { return global_eval_; }
  private:
   void InitGlobal(const ClassSlot& func_cls,
                   JSObject* obj_proto, JSFunction* eval_function,
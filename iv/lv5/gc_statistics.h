@@ -0,0 +1,65 @@
+// heap statistics of Boehm GC heap
+#ifndef IV_LV5_GC_STATISTICS_H_
+#define IV_LV5_GC_STATISTICS_H_
+#include <gc/gc.h>
+#include <iv/date_utils.h>
+#include <iv/lv5/radio/statistics.h>
+namespace iv {
+namespace lv5 {
+
+struct GCStatistics {
+  GCStatistics()
+    : heap_size(0),
+      free_bytes(0),
+      unmapped_bytes(0),
+      bytes_allocated_since_gc(0),
+      total_bytes(0),
+      collections(0),
+      pauses() { }
+
+  // ratio of free bytes in heap which is mapped
+  double fragmentation() const {
+    const std::size_t mapped = heap_size - unmapped_bytes;
+    if (!mapped) {
+      return 0;
+    }
+    return static_cast<double>(free_bytes - unmapped_bytes) / mapped;
+  }
+
+  std::size_t heap_size;  // including unmapped area
+  std::size_t free_bytes;  // including unmapped area
+  std::size_t unmapped_bytes;
+  std::size_t bytes_allocated_since_gc;
+  std::size_t total_bytes;
+  std::size_t collections;
+  radio::PauseHistogram pauses;
+};
+
+// Boehm GC in this tree doesn't have collection event callbacks,
+// so only explicit collections are timed
+inline radio::PauseHistogram* GCPauses() {
+  static radio::PauseHistogram pauses;
+  return &pauses;
+}
+
+inline void GCCollect() {
+  const double start = core::date::HighResTime();
+  GC_gcollect();
+  GCPauses()->Record(core::date::HighResTime() - start);
+}
+
+inline void GetGCStatistics(GCStatistics* stats) {
+  struct GC_prof_stats_s prof;
+  GC_get_prof_stats(&prof, sizeof(prof));
+  stats->heap_size = prof.heapsize_full;
+  stats->free_bytes = prof.free_bytes_full;
+  stats->unmapped_bytes = prof.unmapped_bytes;
+  stats->bytes_allocated_since_gc = prof.bytes_allocd_since_gc;
+  stats->total_bytes =
+      prof.allocd_bytes_before_gc + prof.bytes_allocd_since_gc;
+  stats->collections = prof.gc_no;
+  stats->pauses = *GCPauses();
+}
+
+} }  // namespace iv::lv5
+#endif  // IV_LV5_GC_STATISTICS_H_
@@ -27,6 +27,7 @@ GlobalData::GlobalData(Context* ctx)
   : ctx_(ctx),
     random_generator_(0, 1, static_cast<int>(std::time(nullptr))),
     regs_(),
+    regexp_code_cache_(),
     symbol_table_(),
     classes_(),
     string_cache_(),
@@ -13,6 +13,7 @@
 #include <iv/lv5/gc_hook.h>
 #include <iv/lv5/binary_blocks.h>
 #include <iv/lv5/global_symbols.h>
+#include <iv/lv5/regexp_code_cache.h>
 namespace iv {
 namespace lv5 {
 
@@ -147,6 +148,8 @@ class GlobalData : public GlobalSymbols {
 
   void RegExpClear() { regs_.clear(); }
 
+  RegExpCodeCache* regexp_code_cache() { return &regexp_code_cache_; }
+
   core::SymbolTable* symbol_table() { return &symbol_table_; }
 
   // prototypes getter
@@ -216,6 +219,7 @@ class GlobalData : public GlobalSymbols {
 
   RandomGenerator random_generator_;
   trace::Vector<RegExp*>::type regs_;
+  RegExpCodeCache regexp_code_cache_;
   core::SymbolTable symbol_table_;
   std::array<ClassSlot, Class::NUM_OF_CLASS> classes_;
   std::array<JSString*, 0x80> string_cache_;
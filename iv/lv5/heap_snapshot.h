@@ -0,0 +1,292 @@
+// heap snapshot writer
+//
+// HeapSnapshot walks object graph from roots and writes nodes and edges
+// to stream while walking, so object graph is not materialized.
+// only visited cell set and work stack are held.
+//
+// format is line based text and fields are separated by ' '
+//
+//   lv5-heap-snapshot <version>
+//   R <kind> <id>                           root
+//   N <id> <type> <class> <size> <map id>   node (map id is 0 if no map)
+//   S <id> <json string>                    string contents
+//   E <from id> <kind> <name> <to id>       edge
+//
+// ids are hex cell addresses. name is json string for property edge,
+// index for element and internal edges, and '-' for others.
+// shell writes snapshot of its global object by gc.snapshot(file)
+#ifndef IV_LV5_HEAP_SNAPSHOT_H_
+#define IV_LV5_HEAP_SNAPSHOT_H_
+#include <cstdio>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <gc/gc.h>
+#include <iv/noncopyable.h>
+#include <iv/lv5/symbol.h>
+#include <iv/lv5/jsval.h>
+#include <iv/lv5/jsobject.h>
+#include <iv/lv5/jsstring.h>
+#include <iv/lv5/json_quote.h>
+#include <iv/lv5/jsenv.h>
+#include <iv/lv5/jsglobal.h>
+#include <iv/lv5/map.h>
+#include <iv/lv5/context.h>
+#include <iv/lv5/property_names_collector.h>
+#include <iv/lv5/radio/core.h>
+namespace iv {
+namespace lv5 {
+
+class HeapSnapshot : private core::Noncopyable<HeapSnapshot> {
+ public:
+  static const int kVersion = 1;
+  // string contents longer than this are truncated
+  static const std::size_t kMaxStringLength = 256;
+
+  typedef std::unordered_set<const radio::Cell*> CellSet;
+  typedef std::vector<radio::Cell*> Cells;
+
+  HeapSnapshot(Context* ctx, std::FILE* out)
+    : ctx_(ctx),
+      out_(out),
+      heap_(nullptr),
+      tracer_(),
+      visited_(),
+      stack_(),
+      reported_(),
+      nodes_(0),
+      edges_(0) {
+    std::fprintf(out_, "lv5-heap-snapshot %d\n", kVersion);
+  }
+
+  // global object and global environment of context
+  void WriteContextRoots() {
+    assert(ctx_);
+    WriteRoot("global", ctx_->global_obj());
+    WriteRoot("global_env", ctx_->global_env());
+  }
+
+  // handles and persistent handles of radio::Core
+  void WriteCoreRoots(radio::Core* core) {
+    heap_ = core;
+    Collector collector;
+    core->VisitRoots(&collector);
+    for (Cells::const_iterator it = collector.cells().begin(),
+         last = collector.cells().end(); it != last; ++it) {
+      WriteRoot("handle", *it);
+    }
+  }
+
+  // write root record and walk cells reachable from it
+  void WriteRoot(const char* kind, radio::Cell* cell) {
+    if (!cell) {
+      return;
+    }
+    std::fprintf(out_, "R %s %llx\n", kind, Id(cell));
+    Push(cell);
+    while (!stack_.empty()) {
+      radio::Cell* target = stack_.back();
+      stack_.pop_back();
+      WriteNode(target);
+      WriteEdges(target);
+    }
+    std::fflush(out_);
+  }
+
+  std::size_t nodes() const { return nodes_; }
+
+  std::size_t edges() const { return edges_; }
+
+ private:
+  class Collector : public radio::CellVisitor {
+   public:
+    Collector() : cells_() { }
+
+    void Visit(radio::Cell* cell) { cells_.push_back(cell); }
+
+    const Cells& cells() const { return cells_; }
+
+   private:
+    Cells cells_;
+  };
+
+  static unsigned long long Id(const void* ptr) {  // NOLINT
+    return static_cast<unsigned long long>(  // NOLINT
+        reinterpret_cast<uintptr_t>(ptr));
+  }
+
+  static const char* TypeName(uint32_t tag) {
+    switch (tag) {
+      case radio::STRING: return "string";
+      case radio::OBJECT: return "object";
+      case radio::SYMBOL: return "symbol";
+      case radio::REFERENCE: return "reference";
+      case radio::ENVIRONMENT: return "environment";
+      case radio::NATIVE_ITERATOR: return "iterator";
+      case radio::ACCESSOR: return "accessor";
+      default: return "internal";
+    }
+  }
+
+  static bool IsJSCell(const radio::Cell* cell) {
+    return cell->tag() == radio::OBJECT ||
+        cell->tag() == radio::STRING ||
+        cell->tag() == radio::SYMBOL;
+  }
+
+  void Push(radio::Cell* cell) {
+    if (visited_.insert(cell).second) {
+      stack_.push_back(cell);
+    }
+  }
+
+  std::size_t SizeOf(radio::Cell* cell) const {
+    if (heap_ && heap_->Contains(cell)) {
+      return cell->block()->cell_size();
+    }
+    if (void* base = GC_base(cell)) {
+      return GC_size(base);
+    }
+    return 0;
+  }
+
+  void WriteNode(radio::Cell* cell) {
+    const char* cls = "-";
+    const Map* map = nullptr;
+    if (IsJSCell(cell)) {
+      const JSCell* js = static_cast<JSCell*>(static_cast<radio::CellObject*>(cell));
+      map = js->map();
+      if (js->cls()) {
+        cls = js->cls()->name;
+      }
+    }
+    std::fprintf(out_, "N %llx %s %s %lu %llx\n",
+                 Id(cell), TypeName(cell->tag()), cls,
+                 static_cast<unsigned long>(SizeOf(cell)), Id(map));  // NOLINT
+    ++nodes_;
+    if (cell->tag() == radio::STRING) {
+      // fibers are walked, so taking snapshot does not flatten cons strings
+      const JSString* str =
+          static_cast<JSString*>(static_cast<radio::CellObject*>(cell));
+      std::size_t rest =
+          (std::min)(static_cast<std::size_t>(str->size()), kMaxStringLength);
+      std::u16string contents;
+      for (JSStringFiberIterator it(str); rest && !it.Done();) {
+        const std::size_t n =
+            (std::min)(rest, static_cast<std::size_t>(it.remaining()));
+        if (it.fiber()->Is8Bit()) {
+          const char* data = it.data<char>();
+          contents.append(data, data + n);
+        } else {
+          const char16_t* data = it.data<char16_t>();
+          contents.append(data, data + n);
+        }
+        rest -= n;
+        it.Advance(n);
+      }
+      std::fprintf(out_, "S %llx %s\n",
+                   Id(cell), JSONQuoteToUTF8(contents).c_str());
+    }
+  }
+
+  void WriteEdges(radio::Cell* cell) {
+    reported_.clear();
+    if (IsJSCell(cell)) {
+      JSCell* js = static_cast<JSCell*>(static_cast<radio::CellObject*>(cell));
+      WriteEdge(cell, "map", "-", js->map());
+      if (cell->tag() == radio::OBJECT) {
+        WriteObjectEdges(static_cast<JSObject*>(js));
+      }
+    }
+    // other children reported by MarkChildren,
+    // such as closure environment of function
+    Collector collector;
+    (heap_ ? heap_ : &tracer_)->VisitChildren(cell, &collector);
+    const bool env = cell->tag() == radio::ENVIRONMENT;
+    std::size_t index = 0;
+    for (Cells::const_iterator it = collector.cells().begin(),
+         last = collector.cells().end(); it != last; ++it, ++index) {
+      radio::Cell* target = *it;
+      if (reported_.find(target) != reported_.end()) {
+        continue;
+      }
+      const char* kind = "internal";
+      if (target->tag() == radio::ENVIRONMENT) {
+        kind = (env) ? "outer" : "context";
+      } else if (env) {
+        kind = "binding";
+      }
+      WriteEdge(cell, kind, std::to_string(index).c_str(), target);
+    }
+  }
+
+  void WriteObjectEdges(JSObject* obj) {
+    Map* map = obj->map();
+    WriteEdge(obj, "prototype", "-", map->prototype());
+    PropertyNamesCollector collector;
+    map->GetOwnPropertyNames(&collector, true);
+    for (PropertyNamesCollector::Names::const_iterator
+         it = collector.names().begin(),
+         last = collector.names().end(); it != last; ++it) {
+      const Symbol name = *it;
+      const Map::Entry entry = map->Get(ctx_, name);
+      if (entry.IsNotFound()) {
+        continue;
+      }
+      const JSVal value = obj->Direct(entry.offset);
+      if (value.IsCell()) {
+        WriteEdge(obj, "property",
+                  JSONQuoteToUTF8(symbol::GetSymbolString(name)).c_str(),
+                  value.cell());
+      }
+    }
+    const IndexedElements& elements = obj->elements();
+    if (elements.dense()) {
+      uint32_t index = 0;
+      for (IndexedElements::DenseArrayVector::const_iterator
+           it = elements.vector.begin(),
+           last = elements.vector.end(); it != last; ++it, ++index) {
+        if (it->IsCell()) {
+          WriteEdge(obj, "element",
+                    std::to_string(index).c_str(), it->cell());
+        }
+      }
+    }
+    if (elements.map) {
+      for (IndexedElements::SparseArrayMap::const_iterator
+           it = elements.map->begin(),
+           last = elements.map->end(); it != last; ++it) {
+        const JSVal value = it->second.value();
+        if (value.IsCell()) {
+          WriteEdge(obj, "element",
+                    std::to_string(it->first).c_str(), value.cell());
+        }
+      }
+    }
+  }
+
+  void WriteEdge(radio::Cell* from,
+                 const char* kind, const char* name, radio::Cell* to) {
+    if (!to) {
+      return;
+    }
+    std::fprintf(out_, "E %llx %s %s %llx\n", Id(from), kind, name, Id(to));
+    ++edges_;
+    reported_.insert(to);
+    Push(to);
+  }
+
+  Context* ctx_;
+  std::FILE* out_;
+  radio::Core* heap_;  // radio heap which cells are allocated in
+  radio::Core tracer_;  // only used to call MarkChildren of Boehm cells
+  CellSet visited_;
+  Cells stack_;  // cells visited but not written yet
+  CellSet reported_;  // children of current cell already written
+  std::size_t nodes_;
+  std::size_t edges_;
+};
+
+} }  // namespace iv::lv5
+#endif  // IV_LV5_HEAP_SNAPSHOT_H_
@@ -1,5 +1,6 @@
 #ifndef IV_LV5_JSFUNCTION_H_
 #define IV_LV5_JSFUNCTION_H_
+#include <algorithm>
 #include <iv/lv5/slot.h>
 #include <iv/lv5/context.h>
 #include <iv/lv5/jsfunction_fwd.h>
@@ -9,7 +10,9 @@ namespace lv5 {
 inline JSFunction::JSFunction(Context* ctx, Type type, bool strict)
   : JSObject(ctx->global_data()->function_map()),
     type_(type),
-    strict_(strict) {
+    strict_(strict),
+    construct_map_(nullptr),
+    construct_slots_(0) {
   set_callable(true);
   set_cls(JSFunction::GetClass());
 }
@@ -17,7 +20,9 @@ inline JSFunction::JSFunction(Context* ctx, Type type, bool strict)
 inline JSFunction::JSFunction(Context* ctx, Map* map, Type type, bool strict)
   : JSObject(map),
     type_(type),
-    strict_(strict) {
+    strict_(strict),
+    construct_map_(nullptr),
+    construct_slots_(0) {
   set_callable(true);
   set_cls(JSFunction::GetClass());
 }
@@ -80,6 +85,21 @@ inline Map* JSFunction::construct_map(Context* ctx, Error* e) {
   return map;
 }
 
+inline JSObject* JSFunction::NewConstructObject(Context* ctx, Error* e) {
+  Map* map = construct_map(ctx, IV_LV5_ERROR(e));
+  JSObject* const obj = JSObject::New(ctx, map);
+  if (construct_slots_ > map->GetSlotsSize()) {
+    obj->ReserveSlots(construct_slots_);
+  }
+  return obj;
+}
+
+inline void JSFunction::RecordConstructSlots(JSObject* obj) {
+  // object has been initialized by constructor body
+  construct_slots_ = std::min<uint32_t>(obj->map()->GetSlotsSize(),
+                                        kMaxConstructSlots);
+}
+
 inline bool JSFunction::DefineOwnNonIndexedPropertySlotMethod(JSObject* obj,
                                                               Context* ctx,
                                                               Symbol name,
@@ -75,13 +75,27 @@ class JSFunction : public JSObject {
   IV_LV5_INTERNAL_METHOD JSVal GetNonIndexedSlotMethod(JSObject* obj, Context* ctx, Symbol name, Slot* slot, Error* e);
 
   Map* construct_map(Context* ctx, Error* e);
+
+  // allocate this object of constructor call. its slots are presized with
+  // the slots size recorded by RecordConstructSlots,
+  // so properties added in constructor body do not reallocate slots
+  JSObject* NewConstructObject(Context* ctx, Error* e);
+
+  // record the slots size of this object when constructor call returns.
+  // only the size is held, so the object is not kept alive by function
+  void RecordConstructSlots(JSObject* obj);
+
+  uint32_t construct_slots() const { return construct_slots_; }
  protected:
+  static const uint32_t kMaxConstructSlots = 64;
+
   explicit JSFunction(Context* ctx, Type type, bool strict);
   JSFunction(Context* ctx, Map* map, Type type, bool strict);
 
   Type type_;
   bool strict_;
   Map* construct_map_;
+  uint32_t construct_slots_;  // allocation site feedback
 };
 
 class JSNativeFunction : public JSFunction {
@@ -40,13 +40,15 @@ inline bool IsAbsentDescriptor(const PropertyDescriptor& desc) {
 
 inline JSObject::JSObject(Map* map)
   : JSCell(radio::OBJECT, map, nullptr),
-    slots_(map->GetSlotsSize()),
+    inline_slots_(),
+    slots_(OutOfLineSlotsSize(map->GetSlotsSize())),
     elements_(),
     flags_(kFlagExtensible) {
 }
 
 inline JSObject::JSObject(const JSObject& obj)
   : JSCell(obj),
+    inline_slots_(obj.inline_slots_),
     slots_(obj.slots_),
     elements_(obj.elements_),
     flags_(obj.flags_) {
@@ -54,7 +56,8 @@ inline JSObject::JSObject(const JSObject& obj)
 
 inline JSObject::JSObject(Map* map, const Class* cls)
   : JSCell(radio::OBJECT, map, cls),
-    slots_(map->GetSlotsSize()),
+    inline_slots_(),
+    slots_(OutOfLineSlotsSize(map->GetSlotsSize())),
     elements_(),
     flags_(kFlagExtensible) {
 }
@@ -225,7 +228,7 @@ inline bool JSObject::DefineOwnNonIndexedPropertySlotMethod(JSObject* obj,
         uint32_t offset;
         slot->Merge(ctx, desc);
         obj->set_map(obj->map()->AddPropertyTransition(ctx, name, slot->attributes(), &offset));
-        obj->slots_.resize(obj->map()->GetSlotsSize(), JSEmpty);
+        obj->ResizeSlots(obj->map()->GetSlotsSize());
         // set newly created property
         obj->Direct(offset) = slot->value();
         slot->MarkPutResult(Slot::PUT_NEW, offset);
@@ -248,7 +251,7 @@ inline bool JSObject::DefineOwnNonIndexedPropertySlotMethod(JSObject* obj,
   uint32_t offset;
   const StoredSlot stored(ctx, desc);
   obj->set_map(obj->map()->AddPropertyTransition(ctx, name, stored.attributes(), &offset));
-  obj->slots_.resize(obj->map()->GetSlotsSize(), JSEmpty);
+  obj->ResizeSlots(obj->map()->GetSlotsSize());
   obj->Direct(offset) = stored.value();
   slot->MarkPutResult(Slot::PUT_NEW, offset);
   return true;
@@ -318,6 +321,36 @@ inline void JSObject::PutNonIndexedSlotMethod(JSObject* obj, Context* ctx, Symbo
       DataDescriptor(val, ATTR::W | ATTR::E | ATTR::C), slot, throwable, e);
 }
 
+inline bool JSObject::GetDenseIndexed(uint32_t index, JSVal* res) const {
+  if (method()->GetOwnIndexedPropertySlot != JSObject::GetOwnIndexedPropertySlotMethod ||
+      !elements_.dense() ||
+      index >= elements_.vector.size()) {
+    return false;
+  }
+  const JSVal value = elements_.vector[index];
+  if (value.IsEmpty()) {
+    // hole, lookup prototype chain
+    return false;
+  }
+  *res = value;
+  return true;
+}
+
+inline bool JSObject::PutDenseIndexed(uint32_t index, JSVal val) {
+  if (method()->GetOwnIndexedPropertySlot != JSObject::GetOwnIndexedPropertySlotMethod ||
+      method()->DefineOwnIndexedPropertySlot != JSObject::DefineOwnIndexedPropertySlotMethod ||
+      !elements_.dense() ||
+      index >= elements_.vector.size() ||
+      elements_.vector[index].IsEmpty()) {
+    // new element may be appended, so length and extensible flag
+    // should be checked in generic path
+    return false;
+  }
+  // existing dense element is always writable data property
+  elements_.vector[index] = val;
+  return true;
+}
+
 inline void JSObject::PutIndexedSlotMethod(JSObject* obj, Context* ctx, uint32_t index, JSVal val, Slot* slot, bool throwable, Error* e) {
   if (index < IndexedElements::kMaxVectorSize &&
       obj->elements_.dense() &&
@@ -657,7 +690,7 @@ inline JSObject* JSObject::NewPlain(Context* ctx, Map* map) {
 inline void JSObject::MapTransitionWithReallocation(
     JSObject* base, JSVal src, Map* transit, uint32_t offset) {
   base->set_map(transit);
-  base->slots_.resize(transit->GetSlotsSize(), JSEmpty);
+  base->ResizeSlots(transit->GetSlotsSize());
   base->Direct(offset) = src;
 }
 
@@ -667,6 +700,8 @@ inline void JSCell::MarkChildren(radio::Core* core) {
 
 inline void JSObject::MarkChildren(radio::Core* core) {
   JSCell::MarkChildren(core);
+  std::for_each(inline_slots_.begin(), inline_slots_.end(),
+                radio::Core::Marker(core));
   std::for_each(slots_.begin(), slots_.end(), radio::Core::Marker(core));
   if (elements_.dense()) {
     std::for_each(elements_.vector.begin(), elements_.vector.end(), radio::Core::Marker(core));
@@ -1,5 +1,6 @@
 #ifndef IV_LV5_JSOBJECT_FWD_H_
 #define IV_LV5_JSOBJECT_FWD_H_
+#include <iv/detail/array.h>
 #include <iv/lv5/gc_template.h>
 #include <iv/lv5/jsval_fwd.h>
 #include <iv/lv5/error_check.h>
@@ -28,6 +29,10 @@ class JSObject : public JSCell {
   IV_LV5_DEFINE_JSCLASS(JSObject, Object)
 
   // structure for normal property (hash map is defined in Map)
+  // first kInlineSlotsSize properties are stored in the object itself,
+  // and the rest are stored in out-of-line Slots
+  static const std::size_t kInlineSlotsSize = 4;
+  typedef std::array<JSVal, kInlineSlotsSize> InlineSlots;
   typedef FixedStorage<JSVal> Slots;
 
   // structures for indexed elements
@@ -73,6 +78,11 @@ class JSObject : public JSCell {
   void PutNonIndexedSlot(Context* ctx, Symbol name, JSVal val, Slot* slot, bool throwable, Error* e);
   void PutIndexedSlot(Context* ctx, uint32_t index, JSVal val, Slot* slot, bool throwable, Error* e);
 
+  // element fast paths. succeed only if the element is held in
+  // dense vector, so these never call user code
+  bool GetDenseIndexed(uint32_t index, JSVal* res) const;
+  bool PutDenseIndexed(uint32_t index, JSVal val);
+
   bool Delete(Context* ctx, Symbol name, bool throwable, Error* e);
   bool DeleteNonIndexed(Context* ctx, Symbol name, bool throwable, Error* e);
   bool DeleteIndexed(Context* ctx, uint32_t index, bool throwable, Error* e);
@@ -170,27 +180,55 @@ class JSObject : public JSCell {
   static JSObject* NewPlain(Context* ctx, Map* map);
 
   inline const JSVal& Direct(std::size_t n) const {
-    assert(slots_.size() > n);
-    return slots_[n];
+    if (IsInlineSlot(n)) {
+      return inline_slots_[n];
+    }
+    assert(slots_.size() > OutOfLineSlot(n));
+    return slots_[OutOfLineSlot(n)];
   }
 
   inline JSVal& Direct(std::size_t n) {
-    assert(slots_.size() > n);
-    return slots_[n];
+    if (IsInlineSlot(n)) {
+      return inline_slots_[n];
+    }
+    assert(slots_.size() > OutOfLineSlot(n));
+    return slots_[OutOfLineSlot(n)];
+  }
+
+  static bool IsInlineSlot(std::size_t n) { return n < kInlineSlotsSize; }
+
+  // index of slot n in out-of-line Slots
+  static std::size_t OutOfLineSlot(std::size_t n) {
+    assert(!IsInlineSlot(n));
+    return n - kInlineSlotsSize;
+  }
+
+  // out-of-line Slots size required by the object having n slots
+  static std::size_t OutOfLineSlotsSize(std::size_t n) {
+    return IsInlineSlot(n) ? 0 : OutOfLineSlot(n);
   }
 
   virtual void MarkChildren(radio::Core* core);
 
+  const IndexedElements& elements() const { return elements_; }
+
   const MethodTable* method() const { return &cls()->method; }
 
   void ChangePrototype(Context* ctx, JSObject* proto);
 
+  static std::size_t InlineSlotsOffset() {
+    return IV_OFFSETOF(JSObject, inline_slots_);
+  }
   static std::size_t SlotsOffset() { return IV_OFFSETOF(JSObject, slots_); }
   static std::size_t ElementsOffset() { return IV_OFFSETOF(JSObject, elements_); }
 
   static void MapTransitionWithReallocation(
       JSObject* base, JSVal src, Map* transit, uint32_t offset);
 
+  // grow out-of-line slots for the object having n slots in advance.
+  // slots beyond map's slots size are unused until map transits to them
+  void ReserveSlots(std::size_t n) { ResizeSlots(n); }
+
   void MakeTuple() { flags_ |= kFlagTuple; }
   bool IsTuple() const { return flags_ & kFlagTuple; }
 
@@ -199,6 +237,11 @@ class JSObject : public JSCell {
   explicit JSObject(const JSObject& obj);
   JSObject(Map* map, const Class* cls);
 
+  void ResizeSlots(std::size_t n) {
+    slots_.resize(OutOfLineSlotsSize(n), JSEmpty);
+  }
+
+  InlineSlots inline_slots_;
   Slots slots_;
   IndexedElements elements_;
   uint32_t flags_;
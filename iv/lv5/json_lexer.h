@@ -2,12 +2,14 @@
 #define IV_LV5_JSON_LEXER_H_
 #include <cassert>
 #include <cstdlib>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <iv/token.h>
 #include <iv/character.h>
 #include <iv/noncopyable.h>
 #include <iv/conversions.h>
+#include <iv/string_utils.h>
 namespace iv {
 namespace lv5 {
 namespace detail {
@@ -26,6 +28,18 @@ inline bool IsAcceptedChar<false>(char16_t c) {
   return c > 0x001F && !core::character::IsLineTerminator(c);
 }
 
+// find '"' or '\\' in string literal
+inline const char* FindStringStop(const char* it, const char* last) {
+  return std::find_if(it, last, [](char ch) {
+    return ch == '"' || ch == '\\';
+  });
+}
+
+inline const char16_t* FindStringStop(const char16_t* it,
+                                      const char16_t* last) {
+  static const char16_t kStops[] = { u'"', u'\\' };
+  return core::FindCharAny(it, last, kStops, 2);
+}
 
 }  // namespace detail
 
@@ -182,7 +196,7 @@ class JSONLexer : private core::Noncopyable<> {
           return core::Token::TK_ILLEGAL;
         }
       } else if (detail::IsAcceptedChar<AcceptLineTerminator>(c_)) {
-        Record16Advance();
+        ScanStringChunk();
       } else {
         return core::Token::TK_ILLEGAL;
       }
@@ -195,6 +209,19 @@ class JSONLexer : private core::Noncopyable<> {
     return core::Token::TK_STRING;
   }
 
+  // record accepted characters until next quote or backslash at once
+  void ScanStringChunk() {
+    const auto begin = source_.data() + pos_ - 1;
+    const auto stop =
+        detail::FindStringStop(begin + 1, source_.data() + end_);
+    const auto accepted = std::find_if(begin + 1, stop, [](char16_t ch) {
+      return !detail::IsAcceptedChar<AcceptLineTerminator>(ch);
+    });
+    buffer16_.insert(buffer16_.end(), begin, accepted);
+    pos_ = accepted - source_.data();
+    Advance();
+  }
+
   template<bool find_sign>
   typename core::Token::Type ScanNumber() {
     buffer8_.clear();
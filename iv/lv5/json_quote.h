@@ -0,0 +1,26 @@
+// JSON quoted UTF-8 strings for the diagnostic outputs,
+// such as heap snapshot and profiler dump
+#ifndef IV_LV5_JSON_QUOTE_H_
+#define IV_LV5_JSON_QUOTE_H_
+#include <string>
+#include <iterator>
+#include <iv/conversions.h>
+#include <iv/unicode.h>
+#include <iv/string_view.h>
+namespace iv {
+namespace lv5 {
+
+// "..." quoted and escaped string encoded in UTF-8
+inline std::string JSONQuoteToUTF8(const core::u16string_view& str) {
+  std::u16string quoted;
+  quoted.reserve(str.size() + 2);
+  quoted.push_back('"');
+  core::JSONQuote(str.begin(), str.end(), std::back_inserter(quoted));
+  quoted.push_back('"');
+  std::string result;
+  core::unicode::UTF16ToUTF8(quoted, std::back_inserter(result));
+  return result;
+}
+
+} }  // namespace iv::lv5
+#endif  // IV_LV5_JSON_QUOTE_H_
@@ -134,14 +134,14 @@ class JSRegExp : public JSObject {
       const JSUTF16FlatString* flat = flags->Flatten16();
       f = RegExp::ComputeFlags(flat->begin(), flat->end());
     }
-    impl_ = CompileImpl(ctx->regexp_allocator(), pattern, f);
+    impl_ = CompileImpl(ctx, pattern, f);
     JSString* escaped = Escape(ctx, pattern, IV_LV5_ERROR_VOID(e));
     InitializeProperty(ctx, escaped);
   }
 
   JSRegExp(Context* ctx, JSString* pattern, Error* e)
     : JSObject(ctx->global_data()->regexp_map()),
-      impl_(CompileImpl(ctx->regexp_allocator(), pattern)) {
+      impl_(CompileImpl(ctx, pattern)) {
     JSString* escaped = Escape(ctx, pattern, IV_LV5_ERROR_VOID(e));
     InitializeProperty(ctx, escaped);
   }
@@ -166,13 +166,13 @@ class JSRegExp : public JSObject {
 
   explicit JSRegExp(Context* ctx)
     : JSObject(ctx->global_data()->regexp_map()),
-      impl_(new RegExp(ctx->regexp_allocator())) {
+      impl_(new RegExp(ctx)) {
     InitializeProperty(ctx, ctx->global_data()->string_empty_regexp());
   }
 
   explicit JSRegExp(Context* ctx, Map* map)
     : JSObject(map),
-      impl_(new RegExp(ctx->regexp_allocator())) {
+      impl_(new RegExp(ctx)) {
     Direct(FIELD_SOURCE) = ctx->global_data()->string_empty_regexp();
     Direct(FIELD_GLOBAL) = JSVal::Bool(impl_->global());
     Direct(FIELD_IGNORE_CASE) = JSVal::Bool(impl_->ignore());
@@ -310,12 +310,12 @@ class JSRegExp : public JSObject {
     return ary;
   }
 
-  static RegExp* CompileImpl(core::Space* space,
-                                   JSString* pattern, int flags = 0) {
+  static RegExp* CompileImpl(Context* ctx,
+                             JSString* pattern, int flags = 0) {
     if (pattern->Is8Bit()) {
-      return new RegExp(space, *pattern->Flatten8(), flags);
+      return new RegExp(ctx, *pattern->Flatten8(), flags);
     } else {
-      return new RegExp(space, *pattern->Flatten16(), flags);
+      return new RegExp(ctx, *pattern->Flatten16(), flags);
     }
   }
 
@@ -1,3 +1,4 @@
+#include <iv/detail/array.h>
 #include <iv/unicode.h>
 #include <iv/lv5/jsval.h>
 #include <iv/lv5/jsstring.h>
@@ -44,16 +45,40 @@ JSString* JSString::NewEmpty(Context* ctx) {
   return ctx->global_data()->string_empty();
 }
 
+// If this is JSConsString and the range is in one of its fibers,
+// the fiber is sliced and this is not flattened.
 // TODO(Yusuke Suzuki):
-// If it is JSConsString, we should attempt to extract string as cons.
-// And we should remove this const_cast.
+// We should remove this const_cast.
 JSString* JSString::Substring(Context* ctx,
                               size_type from,
                               size_type to) const {
-  return JSSlicedString::New(
-      ctx,
-      const_cast<JSString*>(this),
-      from, to == npos ? size() : to);
+  if (to == npos) {
+    to = size();
+  }
+  const JSString* current = this;
+  size_type start = from;
+  size_type end = to;
+  for (int depth = 0; !current->IsFlat(); ++depth) {
+    if (depth == kMaxRopeWalkDepth) {
+      // deep rope. flatten whole string
+      current = this;
+      start = from;
+      end = to;
+      break;
+    }
+    const JSConsString* cons = static_cast<const JSConsString*>(current);
+    const size_type lhs_size = cons->lhs()->size();
+    if (end <= lhs_size) {
+      current = cons->lhs();
+    } else if (start >= lhs_size) {
+      start -= lhs_size;
+      end -= lhs_size;
+      current = cons->rhs();
+    } else {
+      break;
+    }
+  }
+  return JSSlicedString::New(ctx, const_cast<JSString*>(current), start, end);
 }
 
 JSString::size_type JSString::find(const JSString& target,
@@ -70,11 +95,112 @@ JSString::size_type JSString::find(const JSString& target,
     const core::u16string_view rhs = target.view16();
     return view8().find(rhs.begin(), rhs.end(), index);
   } else {
+    // 8bit needle is widened in the UTF-16 search kernel without copy
     const core::string_view rhs = target.view8();
     return view16().find(rhs.begin(), rhs.end(), index);
   }
 }
 
+namespace {
+
+// compare n characters of current fibers
+int CompareFiberChars(const JSStringFiberIterator& lhs,
+                      const JSStringFiberIterator& rhs,
+                      JSString::size_type n) {
+  if (lhs.fiber()->Is8Bit()) {
+    const char* left = lhs.data<char>();
+    if (rhs.fiber()->Is8Bit()) {
+      return std::char_traits<char>::compare(left, rhs.data<char>(), n);
+    }
+    const char16_t* right = rhs.data<char16_t>();
+    return core::CompareIterators(left, left + n, right, right + n);
+  }
+  const char16_t* left = lhs.data<char16_t>();
+  if (rhs.fiber()->Is8Bit()) {
+    const char* right = rhs.data<char>();
+    return core::CompareIterators(left, left + n, right, right + n);
+  }
+  return std::char_traits<char16_t>::compare(left, rhs.data<char16_t>(), n);
+}
+
+int CompareFibers(JSStringFiberIterator* lhs,
+                  JSStringFiberIterator* rhs,
+                  JSString::size_type length) {
+  while (length) {
+    const JSString::size_type n =
+        std::min(length, std::min(lhs->remaining(), rhs->remaining()));
+    if (const int r = CompareFiberChars(*lhs, *rhs, n)) {
+      return r;
+    }
+    lhs->Advance(n);
+    rhs->Advance(n);
+    length -= n;
+  }
+  return 0;
+}
+
+}  // namespace anonymous
+
+int JSString::compare(const JSString& x) const {
+  if (IsFlat() && x.IsFlat()) {
+    return static_cast<const JSFlatString*>(this)->compare(
+        static_cast<const JSFlatString&>(x));
+  }
+  JSStringFiberIterator lhs(this);
+  JSStringFiberIterator rhs(&x);
+  if (const int r = CompareFibers(&lhs, &rhs, std::min(size(), x.size()))) {
+    return r;
+  }
+  if (size() < x.size()) {
+    return -1;
+  } else if (size() > x.size()) {
+    return 1;
+  }
+  return 0;
+}
+
+bool JSString::StartsWith(const JSString& target, size_type index) const {
+  assert(index >= 0);
+  if (static_cast<int64_t>(index) + target.size() > size()) {
+    return false;
+  }
+  JSStringFiberIterator lhs(this, index);
+  JSStringFiberIterator rhs(&target);
+  return CompareFibers(&lhs, &rhs, target.size()) == 0;
+}
+
+std::size_t JSString::Hasher::RopeToHash(this_type* str) {
+  static_assert(std::is_same<core::Hash, core::LuaHash>::value,
+                "sampling should be the same to core::Hash");
+  const size_type len = str->size();
+  const size_type step = (len >> 5) + 1;
+  const size_type count = len / step;
+  if (count == 0) {
+    return 0;
+  }
+  // core::Hash samples characters from the tail,
+  // so they are collected in ascending order and folded reversely
+  std::array<char16_t, 32> samples;
+  JSStringFiberIterator it(str);
+  size_type current = 0;  // position of it.offset()
+  size_type position = len - (count - 1) * step - 1;
+  for (size_type i = 0; i < count; ++i, position += step) {
+    while (position - current >= it.remaining()) {
+      current += it.remaining();
+      it.Next();
+    }
+    const size_type delta = position - current;
+    samples[i] = it.fiber()->Is8Bit() ?
+        static_cast<char16_t>(it.data<char>()[delta]) :
+        it.data<char16_t>()[delta];
+  }
+  std::size_t h = 0;
+  for (size_type i = count; i-- > 0;) {
+    h = h ^ ((h << 5) + (h >> 2) + samples[i]);
+  }
+  return h;
+}
+
 JSString::size_type JSString::rfind(const JSString& target,
                                     size_type index) const {
   if (Is8Bit() == target.Is8Bit()) {
@@ -89,6 +215,7 @@ JSString::size_type JSString::rfind(const JSString& target,
     const core::u16string_view rhs = target.view16();
     return view8().rfind(rhs.begin(), rhs.end(), index);
   } else {
+    // 8bit needle is widened in the UTF-16 search kernel without copy
     const core::string_view rhs = target.view8();
     return view16().rfind(rhs.begin(), rhs.end(), index);
   }
@@ -183,11 +310,24 @@ int JSFlatString::compare(const this_type& x) const {
 
 char16_t JSString::At(size_type n) const {
   assert(n < size());
-  if (IsFlat()) {
-    return (*static_cast<const JSFlatString*>(this))[n];
+  const JSString* current = this;
+  size_type index = n;
+  for (int depth = 0; !current->IsFlat(); ++depth) {
+    if (depth == kMaxRopeWalkDepth) {
+      // deep rope. flatten it since it may be accessed repeatedly
+      Flatten();
+      return (*static_cast<const JSFlatString*>(this))[n];
+    }
+    const JSConsString* cons = static_cast<const JSConsString*>(current);
+    const size_type lhs_size = cons->lhs()->size();
+    if (index < lhs_size) {
+      current = cons->lhs();
+    } else {
+      index -= lhs_size;
+      current = cons->rhs();
+    }
   }
-  Flatten();
-  return (*static_cast<const JSFlatString*>(this))[n];
+  return (*static_cast<const JSFlatString*>(current))[index];
 }
 
 JSString* JSString::New(Context* ctx, Symbol sym) {
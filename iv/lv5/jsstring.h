@@ -5,6 +5,7 @@
 #include <iterator>
 #include <algorithm>
 #include <type_traits>
+#include <vector>
 #include <gc/gc_cpp.h>
 #include <iv/detail/cstdint.h>
 #include <iv/debug.h>
@@ -26,6 +27,7 @@ class JSConsString;
 class JSSeqString;
 class JSSlicedString;
 class JSExternalString;
+class JSStringFiberIterator;
 
 template<typename CharT>
 class JSFlatTypedString;
@@ -85,6 +87,9 @@ class JSString : public JSCell {
 
   size_type rfind(const JSString& target, size_type index) const;
 
+  // whether target appears at index. cons string is not flattened
+  bool StartsWith(const JSString& target, size_type index = 0) const;
+
   JSString* Substring(Context* ctx, size_type from, size_type to = npos) const;
 
   JSString* Repeat(Context* ctx, uint32_t count, Error* e);
@@ -95,12 +100,19 @@ class JSString : public JSCell {
 
   struct Hasher {
     std::size_t operator()(this_type* str) const {
+      if (!str->IsFlat()) {
+        return RopeToHash(str);
+      }
       if (str->Is8Bit()) {
         return core::Hash::StringToHash(str->view8());
       } else {
         return core::Hash::StringToHash(str->view16());
       }
     }
+
+    // same as core::Hash, but characters are sampled from cons string
+    // fibers without flattening it
+    static std::size_t RopeToHash(this_type* str);
   };
 
   struct Equaler {
@@ -201,6 +213,9 @@ class JSString : public JSCell {
   static JSString* NewExternal(Context* ctx, core::u16string_view view);
 
  protected:
+  // walking down cons string deeper than this flattens it
+  static const int kMaxRopeWalkDepth = 32;
+
   JSString(Context* ctx, int32_t size);
 
   JSString(Context* ctx);  // empty
@@ -617,6 +632,7 @@ class JSSlicedString : public JSString {
 class JSConsString : public JSString {
  public:
   friend class JSString;
+  friend class JSStringFiberIterator;
 
   JSString* Flatten() const {
     if (Is8Bit()) {
@@ -712,6 +728,76 @@ class JSConsString : public JSString {
 static_assert(sizeof(JSSlicedString) <= sizeof(JSConsString),
               "JSConsString is larger than or equal to JSSlicedString.");
 
+// Walks flat fibers of a string in order without flattening cons string.
+// Right hand sides are kept in the stack, so string built by repeated `+=`
+// is walked without recursion.
+class JSStringFiberIterator {
+ public:
+  typedef JSString::size_type size_type;
+
+  explicit JSStringFiberIterator(const JSString* str, size_type from = 0)
+    : fiber_(nullptr),
+      offset_(0),
+      stack_() {
+    assert(from <= str->size());
+    Descend(str, from);
+  }
+
+  bool Done() const { return !fiber_; }
+
+  const JSString* fiber() const { return fiber_; }
+
+  // characters in [offset, fiber()->size()) are not walked yet
+  size_type offset() const { return offset_; }
+
+  size_type remaining() const { return fiber_->size() - offset_; }
+
+  template<typename CharT>
+  const CharT* data() const { return fiber_->data<CharT>() + offset_; }
+
+  void Advance(size_type n) {
+    assert(n <= remaining());
+    offset_ += n;
+    if (remaining() == 0) {
+      Next();
+    }
+  }
+
+  void Next() {
+    if (stack_.empty()) {
+      fiber_ = nullptr;
+      return;
+    }
+    const JSString* str = stack_.back();
+    stack_.pop_back();
+    Descend(str, 0);
+  }
+
+ private:
+  // descend to the fiber which has from-th character
+  void Descend(const JSString* str, size_type from) {
+    while (!str->IsFlat()) {
+      const JSConsString* cons = static_cast<const JSConsString*>(str);
+      if (from < cons->lhs()->size()) {
+        stack_.push_back(cons->rhs());
+        str = cons->lhs();
+      } else {
+        from -= cons->lhs()->size();
+        str = cons->rhs();
+      }
+    }
+    fiber_ = str;
+    offset_ = from;
+    if (remaining() == 0) {
+      Next();
+    }
+  }
+
+  const JSString* fiber_;
+  size_type offset_;
+  std::vector<const JSString*> stack_;
+};
+
 class JSExternalString : public JSString {
  public:
   friend class JSString;
@@ -754,10 +840,6 @@ inline const JSFlatTypedString<char16_t>* JSString::Flatten16() const {
   return static_cast<const JSUTF16FlatString*>(this);
 }
 
-inline int JSString::compare(const JSString& x) const {
-  return Flatten()->compare(*x.Flatten());
-}
-
 inline bool operator==(const JSString& x, const JSString& y) {
   if (x.size() == y.size()) {
     return x.compare(y) == 0;
@@ -770,19 +852,19 @@ inline bool operator!=(const JSString& x, const JSString& y) {
 }
 
 inline bool operator<(const JSString& x, const JSString& y) {
-  return (*x.Flatten()) < (*y.Flatten());
+  return x.compare(y) < 0;
 }
 
 inline bool operator>(const JSString& x, const JSString& y) {
-  return (*x.Flatten()) > (*y.Flatten());
+  return x.compare(y) > 0;
 }
 
 inline bool operator<=(const JSString& x, const JSString& y) {
-  return (*x.Flatten()) <= (*y.Flatten());
+  return x.compare(y) <= 0;
 }
 
 inline bool operator>=(const JSString& x, const JSString& y) {
-  return (*x.Flatten()) >= (*y.Flatten());
+  return x.compare(y) >= 0;
 }
 
 template<typename Iter>
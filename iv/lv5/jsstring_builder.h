@@ -16,21 +16,28 @@ class JSStringBuilder : public core::BasicStringBuilder<char16_t> {
 
   // override Append is failed...
   void AppendJSString(const JSString& str) {
-    const size_t current_size = container_type::size();
-    container_type::resize(current_size + str.size());
-    const JSFlatString* flat = str.Flatten();
-    std::copy(flat->begin(), flat->end(),
-              container_type::begin() + current_size);
+    AppendJSString(str, 0, str.size());
   }
 
+  // fibers are copied in place, cons string is not flattened
   void AppendJSString(const JSString& str,
                       size_t from,
                       size_t to) {
     const size_t current_size = container_type::size();
     container_type::resize(current_size + (to - from));
-    const JSFlatString* flat = str.Flatten();
-    std::copy(flat->begin() + from, flat->begin() + to,
-              container_type::begin() + current_size);
+    container_type::iterator out = container_type::begin() + current_size;
+    for (JSStringFiberIterator it(&str, from); from != to;) {
+      const size_t n = std::min<size_t>(it.remaining(), to - from);
+      if (it.fiber()->Is8Bit()) {
+        const char* data = it.data<char>();
+        out = std::copy(data, data + n, out);
+      } else {
+        const char16_t* data = it.data<char16_t>();
+        out = std::copy(data, data + n, out);
+      }
+      it.Advance(n);
+      from += n;
+    }
   }
 };
 
@@ -75,6 +75,38 @@ class TypedArrayImpl : public JSObject {
     return true;
   }
 
+  // element fast paths. access backing store directly and
+  // return false if index is out of range
+  static bool GetDirect(const JSObject* obj, uint32_t index, JSVal* res) {
+    const TypedArrayImpl* impl = static_cast<const TypedArrayImpl*>(obj);
+    JSArrayBuffer* buf = impl->buffer();
+    const uint32_t off = impl->byte_offset();
+    const uint64_t total = off + sizeof(T) * (static_cast<uint64_t>(index) + 1);
+    if (index >= impl->length() || total > buf->length()) {
+      return false;
+    }
+    *res = buf->GetValue<T>(off, index, core::kLittleEndian);
+    return true;
+  }
+
+  static bool PutDirect(JSObject* obj, Context* ctx, uint32_t index, JSVal val) {
+    // converting non number value may call user code
+    if (!val.IsNumber()) {
+      return false;
+    }
+    const TypedArrayImpl* impl = static_cast<const TypedArrayImpl*>(obj);
+    JSArrayBuffer* buf = impl->buffer();
+    const uint32_t off = impl->byte_offset();
+    const uint64_t total = off + sizeof(T) * (static_cast<uint64_t>(index) + 1);
+    if (index >= impl->length() || total > buf->length()) {
+      return false;
+    }
+    Error::Dummy dummy;
+    const T converted = TypedArrayTraits<T>::ToType(ctx, val, &dummy);
+    buf->SetValue<T>(off, index, core::kLittleEndian, converted);
+    return true;
+  }
+
   IV_LV5_INTERNAL_METHOD void GetOwnPropertyNamesMethod(const JSObject* obj,
                                                         Context* ctx,
                                                         PropertyNamesCollector* collector,
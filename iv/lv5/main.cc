@@ -23,35 +23,83 @@ void InitContext(iv::lv5::Context* ctx) {
   ctx->DefineFunction<&iv::lv5::Print, 1>("print");
   ctx->DefineFunction<&iv::lv5::Log, 1>("log");  // this is simply output log function
   ctx->DefineFunction<&iv::lv5::Quit, 1>("quit");
-  ctx->DefineFunction<&iv::lv5::CollectGarbage, 0>("gc");
+  {
+    // gc function, gc.stats and gc.snapshot functions
+    const iv::lv5::Symbol name = ctx->Intern("gc");
+    iv::lv5::JSFunction* gc =
+        iv::lv5::JSInlinedFunction<&iv::lv5::CollectGarbage, 0>::New(ctx, name);
+    iv::lv5::bind::Object(ctx, gc)
+        .def<&iv::lv5::CollectGarbageStatistics, 0>("stats")
+        .def<&iv::lv5::CollectGarbageSnapshot, 1>("snapshot");
+    ctx->Import("gc", gc);
+  }
   ctx->DefineFunction<&iv::lv5::HiResTime, 0>("HiResTime");
   ctx->DefineFunction<&iv::lv5::railgun::Dis, 1>("dis");
   iv::lv5::melt::Console::Export(ctx, &dummy);
 }
 
+// profile is output file of railgun VM opcode profile. empty if disabled
+void StartProfile(iv::lv5::railgun::Context* ctx, const std::string& profile) {
+  if (!profile.empty()) {
+    ctx->vm()->profiler()->Enable();
+  }
+}
+
+bool DumpProfile(iv::lv5::railgun::Context* ctx, const std::string& profile) {
+  if (profile.empty()) {
+    return true;
+  }
+  ctx->vm()->profiler()->Disable();
+  std::FILE* out = std::fopen(profile.c_str(), "w");
+  if (!out) {
+    std::fprintf(stderr, "lv5 can't open \"%s\"\n", profile.c_str());
+    return false;
+  }
+  ctx->vm()->profiler()->DumpJSON(out);
+  std::fclose(out);
+  return true;
+}
+
 #if defined(IV_ENABLE_JIT)
 int BreakerExecute(const iv::core::string_view& data,
-                   const std::string& filename, bool statistics) {
+                   const std::string& filename,
+                   bool statistics, bool tiered,
+                   const std::string& profile,
+                   const std::string& code_cache) {
   iv::lv5::Error::Standard e;
   iv::lv5::breaker::Context ctx;
   InitContext(&ctx);
+  if (tiered) {
+    ctx.set_tier_up_threshold(
+        iv::lv5::breaker::Context::kDefaultTierUpThreshold);
+  }
   ctx.DefineFunction<&iv::lv5::breaker::Run, 1>("run");
   ctx.DefineFunction<&iv::lv5::breaker::Load, 1>("load");
+  ctx.set_code_cache_directory(code_cache);
   std::shared_ptr<iv::core::FileSource>
       src(new iv::core::FileSource(data, filename));
+  StartProfile(&ctx, profile);
   iv::lv5::breaker::ExecuteInGlobal(&ctx, src, &e);
   if (e) {
     e.Dump(&ctx, stderr);
     return EXIT_FAILURE;
   }
+  if (!DumpProfile(&ctx, profile)) {
+    return EXIT_FAILURE;
+  }
   ctx.Validate();
   return EXIT_SUCCESS;
 }
 
-int BreakerExecuteFiles(const std::vector<std::string>& filenames) {
+int BreakerExecuteFiles(const std::vector<std::string>& filenames,
+                        bool tiered) {
   iv::lv5::Error::Standard e;
   iv::lv5::breaker::Context ctx;
   InitContext(&ctx);
+  if (tiered) {
+    ctx.set_tier_up_threshold(
+        iv::lv5::breaker::Context::kDefaultTierUpThreshold);
+  }
   ctx.DefineFunction<&iv::lv5::breaker::Run, 1>("run");
   ctx.DefineFunction<&iv::lv5::breaker::Load, 1>("load");
 
@@ -77,19 +125,26 @@ int BreakerExecuteFiles(const std::vector<std::string>& filenames) {
 #endif
 
 int RailgunExecute(const iv::core::string_view& data,
-                   const std::string& filename, bool statistics) {
+                   const std::string& filename, bool statistics,
+                   const std::string& profile,
+                   const std::string& code_cache) {
   iv::lv5::Error::Standard e;
   iv::lv5::railgun::Context ctx;
   InitContext(&ctx);
   ctx.DefineFunction<&iv::lv5::railgun::Run, 1>("run");
+  ctx.set_code_cache_directory(code_cache);
 
   std::shared_ptr<iv::core::FileSource>
       src(new iv::core::FileSource(data, filename));
+  StartProfile(&ctx, profile);
   iv::lv5::railgun::ExecuteInGlobal(&ctx, src, &e);
   if (e) {
     e.Dump(&ctx, stderr);
     return EXIT_FAILURE;
   }
+  if (!DumpProfile(&ctx, profile)) {
+    return EXIT_FAILURE;
+  }
   if (statistics) {
     ctx.vm()->DumpStatistics();
   }
@@ -194,12 +249,23 @@ int main(int argc, char **argv) {
   cmd.Add("railgun",
           "railgun",
           0, "force railgun VM");
+  cmd.Add("tiered",
+          "tiered",
+          0, "start in railgun VM and compile hot functions by breaker");
   cmd.Add("dis",
           "dis",
           'd', "print bytecode");
   cmd.Add("statistics",
           "statistics",
           0, "print statistics");
+  cmd.Add<std::string>(
+      "profile",
+      "profile",
+      0, "write opcode profile of railgun VM as JSON to file", false);
+  cmd.Add<std::string>(
+      "code-cache",
+      "code-cache",
+      0, "store and load compiled bytecode in directory", false);
   cmd.Add("copyright",
           "copyright",
           0,   "print the copyright");
@@ -253,7 +319,7 @@ int main(int argc, char **argv) {
           return RailgunExecuteFiles(vec);
         }
 #if defined(IV_ENABLE_JIT)
-        return BreakerExecuteFiles(vec);
+        return BreakerExecuteFiles(vec, cmd.Exist("tiered"));
 #else
         return RailgunExecuteFiles(vec);
 #endif
@@ -276,17 +342,26 @@ int main(int argc, char **argv) {
       }
     }
     const iv::core::string_view src(res.data(), res.size());
+    const std::string profile =
+        cmd.Exist("profile") ? cmd.Get<std::string>("profile") : std::string();
+    const std::string code_cache =
+        cmd.Exist("code-cache") ?
+        cmd.Get<std::string>("code-cache") : std::string();
     if (cmd.Exist("ast")) {
       return Ast(src, filename);
     } else if (cmd.Exist("dis")) {
       return DisAssemble(src, filename);
     } else if (cmd.Exist("railgun")) {
-      return RailgunExecute(src, filename, cmd.Exist("statistics"));
+      return RailgunExecute(src, filename, cmd.Exist("statistics"), profile,
+                            code_cache);
     } else {
 #if defined(IV_ENABLE_JIT)
-      return BreakerExecute(src, filename, cmd.Exist("statistics"));
+      return BreakerExecute(src, filename,
+                            cmd.Exist("statistics"), cmd.Exist("tiered"),
+                            profile, code_cache);
 #else
-      return RailgunExecute(src, filename, cmd.Exist("statistics"));
+      return RailgunExecute(src, filename, cmd.Exist("statistics"), profile,
+                            code_cache);
 #endif
     }
   } else {
@@ -238,8 +238,9 @@ class Map : public radio::HeapObject<radio::POINTER> {
     return map;
   }
 
+  // capacity of out-of-line slots of object having this map
   std::size_t StorageCapacity() const {
-    return core::NextCapacity(GetSlotsSize());
+    return core::NextCapacity(JSObject::OutOfLineSlotsSize(GetSlotsSize()));
   }
 
   Entry Get(Context* ctx, Symbol name) {
@@ -0,0 +1,106 @@
+// thread local allocation buffer (TLAB) of radio::Core
+//
+// while AllocationBuffer is alive, current thread is attached to Core.
+// attached thread owns one nursery block per size class, and cells
+// are bump allocated in it without any lock. blocks are refilled from
+// shared free block list of Core, which is lock free.
+//
+//   radio::AllocationBuffer buffer(core);
+//   core->Allocate<T>();  // allocated in buffer
+#ifndef IV_LV5_RADIO_ALLOCATION_BUFFER_H_
+#define IV_LV5_RADIO_ALLOCATION_BUFFER_H_
+#include <new>
+#include <iv/detail/array.h>
+#include <iv/detail/cstdint.h>
+#include <iv/noncopyable.h>
+#include <iv/debug.h>
+#include <iv/lv5/radio/cell.h>
+#include <iv/lv5/radio/block.h>
+#include <iv/lv5/radio/block_control.h>
+#include <iv/lv5/radio/core.h>
+namespace iv {
+namespace lv5 {
+namespace radio {
+
+class AllocationBuffer : private core::Noncopyable<AllocationBuffer> {
+ public:
+  // unallocated area of owned block
+  struct Area {
+    Area() : cursor(0), limit(0) { }
+    uintptr_t cursor;
+    uintptr_t limit;
+  };
+  typedef std::array<Area, kBlockControls> Areas;
+
+  explicit AllocationBuffer(Core* core)
+    : core_(core),
+      areas_(),
+      allocated_bytes_(0),
+      prev_(nullptr),
+      next_(nullptr) {
+    core_->AttachThread(this);
+  }
+
+  ~AllocationBuffer() {
+    core_->DetachThread(this);
+  }
+
+  // index is index of control in Core
+  Cell* Allocate(std::size_t index, BlockControl* control) {
+    assert(index < kBlockControls);
+    Area* area = &areas_[index];
+    allocated_bytes_ += control->size();
+    if (area->cursor == area->limit && !Refill(area, control)) {
+      // nursery is exhausted, so allocate cell in old generation
+      return control->AllocateOld(core_);
+    }
+    Cell* target = new(reinterpret_cast<void*>(area->cursor))Cell;
+    area->cursor += control->size();
+    return target;
+  }
+
+  // drop owned blocks. blocks are swept by GC as usual nursery blocks
+  void Retire() {
+    areas_.fill(Area());
+  }
+
+  std::size_t allocated_bytes() const { return allocated_bytes_; }
+
+  void reset_allocated_bytes() { allocated_bytes_ = 0; }
+
+  // buffers attached to Core are chained
+  AllocationBuffer* prev() const { return prev_; }
+
+  void set_prev(AllocationBuffer* prev) { prev_ = prev; }
+
+  AllocationBuffer* next() const { return next_; }
+
+  void set_next(AllocationBuffer* next) { next_ = next; }
+
+ private:
+  bool Refill(Area* area, BlockControl* control) {
+    Block* block = core_->AllocateNurseryBlock(control->size());
+    if (!block) {
+      return false;
+    }
+    // all cells are formatted as CLEAR cells before publishing block,
+    // so GC and statistics never see uninitialized area of this buffer
+    for (Block::iterator it = block->begin(),
+         last = block->end(); it != last; ++it) {
+      new(reinterpret_cast<void*>(&*it))Cell;
+    }
+    control->AddNurseryBlock(block);
+    area->cursor = block->begin().ptr();
+    area->limit = block->end().ptr();
+    return true;
+  }
+
+  Core* core_;
+  Areas areas_;
+  std::size_t allocated_bytes_;  // since last GC
+  AllocationBuffer* prev_;
+  AllocationBuffer* next_;
+};
+
+} } }  // namespace iv::lv5::radio
+#endif  // IV_LV5_RADIO_ALLOCATION_BUFFER_H_
@@ -3,11 +3,13 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iterator>
+#include <atomic>
 #include <iv/detail/cstdint.h>
 #include <iv/detail/type_traits.h>
 #include <iv/utils.h>
 #include <iv/noncopyable.h>
 #include <iv/os_allocator.h>
+#include <iv/alloc.h>
 #include <iv/lv5/radio/block.h>
 namespace iv {
 namespace lv5 {
@@ -18,7 +20,9 @@ static const std::size_t kArenaSize =
     IV_ALIGNED_SIZE(kBlockSize * kBlocks, kBlockSize);
 
 // radio::Arena has 64 Blocks
-class Arena : private core::Noncopyable<Arena> {
+// Arena may be allocated in threads attached by AllocationBuffer,
+// so it is allocated from std::malloc instead of GC heap
+class Arena : public core::Malloced, private core::Noncopyable<Arena> {
  public:
   typedef Arena this_type;
   typedef std::size_t size_type;
@@ -122,7 +126,9 @@ class Arena : private core::Noncopyable<Arena> {
 
   explicit Arena(Arena* prev)
     : next_(nullptr),
-      prev_(prev) {
+      prev_(prev),
+      used_(0),
+      releasing_(false) {
     Initialize();
     if (prev) {
       prev->next_ = this;
@@ -161,7 +167,14 @@ class Arena : private core::Noncopyable<Arena> {
     return end();
   }
 
+  // memory is returned to the OS
   ~Arena() {
+    if (prev_) {
+      prev_->next_ = next_;
+    }
+    if (next_) {
+      next_->prev_ = prev_;
+    }
     core::OSAllocator::Deallocate(top_, kArenaSize);
   }
 
@@ -174,6 +187,36 @@ class Arena : private core::Noncopyable<Arena> {
   }
 
   size_type size() const { return kBlocks; }
+
+  bool Contains(const void* ptr) const {
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+    const uintptr_t start = reinterpret_cast<uintptr_t>(block_);
+    return start <= addr && addr < (start + kBlockSize * kBlocks);
+  }
+
+  // occupancy tracking. arena which has no used block can be released
+  void AddUsedBlock() {
+    const size_type used = ++used_;
+    assert(used <= kBlocks);
+    static_cast<void>(used);
+  }
+
+  void RemoveUsedBlock() {
+    assert(used_);
+    --used_;
+  }
+
+  size_type used_blocks() const { return used_; }
+
+  bool IsEmpty() const { return used_ == 0; }
+
+  // marked while free blocks of this arena are unlinked
+  bool releasing() const { return releasing_; }
+
+  void set_releasing(bool releasing) {
+    releasing_ = releasing;
+  }
+
  private:
   void Initialize() {
     top_ = core::OSAllocator::Allocate(kArenaSize);
@@ -184,6 +227,8 @@ class Arena : private core::Noncopyable<Arena> {
 
   Arena* next_;
   Arena* prev_;
+  std::atomic<size_type> used_;  // blocks may be taken by several threads
+  bool releasing_;
   void* top_;
   Block* block_;
 };
@@ -19,6 +19,7 @@ class Context;
 namespace radio {
 
 class BlockControl;
+class Arena;
 
 class Block : private core::Noncopyable<Block> {
  public:
@@ -128,8 +129,10 @@ class Block : private core::Noncopyable<Block> {
   typedef iterator_base<Cell> iterator;
   typedef iterator_base<const Cell> const_iterator;
 
-  Block(size_type cell_size)
-    : cell_size_(cell_size) {
+  Block(size_type cell_size, Arena* arena)
+    : cell_size_(cell_size),
+      arena_(arena),
+      old_(false) {
     assert((reinterpret_cast<uintptr_t>(this) % kBlockSize) == 0);
     const std::size_t offset = core::math::Ceil(sizeof(this_type), cell_size_);
     start_ = reinterpret_cast<uintptr_t>(this) + offset;
@@ -152,7 +155,10 @@ class Block : private core::Noncopyable<Block> {
     return const_iterator(start_ + cell_size() * size(), cell_size());
   }
 
-  bool Collect(Core* core, Context* ctx, BlockControl* control) {
+  // sweep cells in this block.
+  // dead and free cells are chained in front of *free
+  // and returns true if at least one live cell is found
+  bool Collect(Core* core, Context* ctx, BlockControl* control, Cell** free) {
     assert(IsUsed());
     bool used_cell_found = false;
     for (iterator it = begin(), last = end(); it != last; ++it) {
@@ -160,10 +166,15 @@ class Block : private core::Noncopyable<Block> {
       const Color::Type color = cell->color();
       assert(color != Color::GRAY);
       if (color == Color::WHITE) {
-        control->CollectCell(core, ctx, cell);
+        cell = control->CollectCell(core, ctx, cell);
+        cell->set_next(*free);
+        *free = cell;
       } else if (color == Color::BLACK) {
         cell->Coloring(Color::WHITE);
         used_cell_found = true;
+      } else {
+        cell->set_next(*free);
+        *free = cell;
       }
     }
     return used_cell_found;
@@ -188,8 +199,15 @@ class Block : private core::Noncopyable<Block> {
     cell_size_ = 0;
     size_ = 0;
     start_ = 0;
+    old_ = false;
   }
 
+  // young blocks are allocated by bump pointer in nursery
+  // and promoted to old generation when surviving a collection
+  bool IsOld() const { return old_; }
+
+  void Promote() { old_ = true; }
+
   size_type cell_size() const { return cell_size_; }
 
   void set_next(Block* block) {
@@ -198,11 +216,20 @@ class Block : private core::Noncopyable<Block> {
 
   Block* next() const { return next_; }
 
+  // owner arena. it is kept after Release
+  Arena* arena() const { return arena_; }
+
+  void set_arena(Arena* arena) {
+    arena_ = arena;
+  }
+
  private:
   size_type cell_size_;
   size_type size_;
   uintptr_t start_;
   Block* next_;
+  Arena* arena_;
+  bool old_;
 };
 
 } } }  // namespace iv::lv5::radio
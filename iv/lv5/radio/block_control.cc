@@ -1,47 +1,136 @@
 #include <iv/lv5/jsval.h>
 #include <iv/lv5/context.h>
 #include <iv/lv5/radio/cell.h>
+#include <iv/lv5/radio/block.h>
 #include <iv/lv5/radio/block_control.h>
+#include <iv/lv5/radio/core.h>
+#include <iv/lv5/radio/statistics.h>
 namespace iv {
 namespace lv5 {
 namespace radio {
 
 Cell* BlockControl::Allocate(Core* core) {
-  if (free_cells_) {
-    Cell* target = free_cells_;
-    free_cells_ = free_cells_->next();
+  // bump pointer allocation in nursery
+  if (cursor_ != limit_) {
+    Cell* target = new(reinterpret_cast<void*>(cursor_))Cell;
+    cursor_ += size_;
     return target;
   }
-  // assign block
-  AllocateBlock(core);
-  // and try once more
-  return Allocate(core);
+  if (AllocateNurseryBlock(core)) {
+    return Allocate(core);
+  }
+  // nursery is exhausted, so allocate cell in old generation.
+  return AllocateOld(core);
+}
+
+Cell* BlockControl::AllocateOld(Core* core) {
+  // old cell is not scanned in minor GC, so remember it
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  while (!free_cells_ && SweepBlock(core)) { }
+  if (!free_cells_ && !AllocateBlock(core)) {
+    // heap limit is reached
+    return nullptr;
+  }
+  Cell* target = free_cells_;
+  free_cells_ = free_cells_->next();
+  target = new(reinterpret_cast<void*>(target))Cell;
+  core->Remember(target);
+  return target;
 }
 
 void BlockControl::Collect(Core* core, Context* ctx) {
-  for (Block *prev = nullptr, *block = block_; block;) {
-    if (block->Collect(core, ctx, this)) {
-      // when all objects are sweeped in block
-      if (prev) {
-        prev->set_next(block->next());
-      } else {
-        block_ = block->next();
-      }
-      Block* will_released = block;
-      // enumeration
-      block = block->next();
-      core->ReleaseBlock(will_released);
+  {
+    core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+    assert(!unswept_);
+    // free list is rebuilt by sweeping
+    unswept_ = block_;
+    block_ = nullptr;
+    free_cells_ = nullptr;
+    ctx_ = ctx;
+  }
+  SweepNursery(core, ctx);
+}
+
+bool BlockControl::SweepBlock(Core* core) {
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  Block* block = unswept_;
+  if (!block) {
+    return false;
+  }
+  unswept_ = block->next();
+  // free cells of this block are chained in front of free_cells_
+  Cell* const saved = free_cells_;
+  if (block->Collect(core, ctx_, this, &free_cells_)) {
+    block->set_next(block_);
+    block_ = block;
+  } else {
+    // when all objects are sweeped in block
+    free_cells_ = saved;
+    core->ReleaseBlock(block);
+  }
+  return true;
+}
+
+void BlockControl::CompleteSweep(Core* core) {
+  while (SweepBlock(core)) { }
+}
+
+void BlockControl::CollectNursery(Core* core, Context* ctx) {
+  SweepNursery(core, ctx);
+}
+
+void BlockControl::RetireNursery() {
+  for (; cursor_ != limit_; cursor_ += size_) {
+    new(reinterpret_cast<void*>(cursor_))Cell;
+  }
+}
+
+void BlockControl::SweepNursery(Core* core, Context* ctx) {
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  RetireNursery();
+  cursor_ = limit_ = 0;
+  for (Block* block = nursery_; block;) {
+    Block* next = block->next();
+    Cell* const saved = free_cells_;
+    if (block->Collect(core, ctx, this, &free_cells_)) {
+      // survived, promote block to old generation
+      core->PromoteBlock(block);
+      block->set_next(block_);
+      block_ = block;
     } else {
-      // enumeration
-      prev = block;
-      block = block->next();
+      free_cells_ = saved;
+      core->ReleaseBlock(block);
     }
+    block = next;
   }
+  nursery_ = nullptr;
+}
+
+void BlockControl::AddNurseryBlock(Block* block) {
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  block->set_next(nursery_);
+  nursery_ = block;
 }
 
-void BlockControl::AllocateBlock(Core* core) {
+bool BlockControl::AllocateNurseryBlock(Core* core) {
+  assert(cursor_ == limit_);
+  Block* block = core->AllocateNurseryBlock(size_);
+  if (!block) {
+    return false;
+  }
+  AddNurseryBlock(block);
+  assert(block->IsUsed());
+  cursor_ = block->begin().ptr();
+  limit_ = block->end().ptr();
+  return true;
+}
+
+bool BlockControl::AllocateBlock(Core* core) {
   assert(!free_cells_);
-  Block* block = core->AllocateBlock(size_);
+  Block* block = core->AllocateOldBlock(size_);
+  if (!block) {
+    return false;
+  }
   block->set_next(block_);
   block_ = block;
 
@@ -65,14 +154,37 @@ void BlockControl::AllocateBlock(Core* core) {
       break;
     }
   }
+  return true;
 }
 
-void BlockControl::CollectCell(Core* core, Context* ctx, Cell* cell) {
+Cell* BlockControl::CollectCell(Core* core, Context* ctx, Cell* cell) {
   cell->~Cell();
   cell = new(static_cast<void*>(cell))Cell;
   assert(cell->color() == Color::CLEAR);
-  cell->set_next(free_cells_);
-  free_cells_ = cell;
+  return cell;
+}
+
+void BlockControl::GetStatistics(BlockControlStatistics* stats) {
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  stats->cell_size = size_;
+  stats->blocks = stats->cells = stats->used_cells = 0;
+  Block* const lists[] = { block_, unswept_, nursery_ };
+  for (std::size_t i = 0; i < 3; ++i) {
+    for (Block* block = lists[i]; block; block = block->next()) {
+      ++stats->blocks;
+      stats->cells += block->size();
+      for (Block::iterator it = block->begin(),
+           last = block->end(); it != last; ++it) {
+        // unused area of current bump allocation block is not initialized
+        if (cursor_ <= it.ptr() && it.ptr() < limit_) {
+          break;
+        }
+        if (it->color() != Color::CLEAR) {
+          ++stats->used_cells;
+        }
+      }
+    }
+  }
 }
 
 } } }  // namespace iv::lv5::radio
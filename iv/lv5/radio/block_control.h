@@ -1,7 +1,9 @@
 #ifndef IV_LV5_RADIO_BLOCK_CONTROL_H_
 #define IV_LV5_RADIO_BLOCK_CONTROL_H_
 #include <new>
+#include <iv/detail/cstdint.h>
 #include <iv/noncopyable.h>
+#include <iv/thread.h>
 namespace iv {
 namespace lv5 {
 
@@ -12,11 +14,20 @@ namespace radio {
 class Core;
 class Cell;
 class Block;
+struct BlockControlStatistics;
 
 class BlockControl : private core::Noncopyable<BlockControl> {
  public:
   BlockControl()
-    : size_(0), block_(nullptr), free_cells_(nullptr) { }
+    : size_(0),
+      block_(nullptr),
+      nursery_(nullptr),
+      unswept_(nullptr),
+      free_cells_(nullptr),
+      cursor_(0),
+      limit_(0),
+      ctx_(nullptr),
+      mutex_() { }
 
   void Initialize(std::size_t size) {
     size_ = size;
@@ -24,16 +35,48 @@ class BlockControl : private core::Noncopyable<BlockControl> {
 
   Cell* Allocate(Core* core);
 
+  // allocate cell in old generation. cell is remembered
+  Cell* AllocateOld(Core* core);
+
+  // link nursery block owned by AllocationBuffer
+  void AddNurseryBlock(Block* block);
+
+  // sweep nursery blocks, and old blocks are swept lazily
   void Collect(Core* core, Context* ctx);
 
-  void CollectCell(Core* core, Context* ctx, Cell* cell);
+  // sweep one unswept old block. returns false if no block is left
+  bool SweepBlock(Core* core);
+
+  void CompleteSweep(Core* core);
+
+  // sweep nursery blocks only
+  void CollectNursery(Core* core, Context* ctx);
+
+  // fill unused area of current bump allocation block with CLEAR cells
+  void RetireNursery();
+
+  Cell* CollectCell(Core* core, Context* ctx, Cell* cell);
+
+  void GetStatistics(BlockControlStatistics* stats);
+
+  std::size_t size() const { return size_; }
 
  private:
-  void AllocateBlock(Core* core);
+  bool AllocateBlock(Core* core);
+
+  bool AllocateNurseryBlock(Core* core);
+
+  void SweepNursery(Core* core, Context* ctx);
 
   std::size_t size_;
-  Block* block_;
+  Block* block_;  // old blocks
+  Block* nursery_;  // young blocks
+  Block* unswept_;  // old blocks marked but not swept yet
   Cell* free_cells_;
+  uintptr_t cursor_;  // bump pointer
+  uintptr_t limit_;
+  Context* ctx_;  // context of last GC
+  core::thread::Mutex mutex_;  // lock old blocks for concurrent sweeping
 };
 
 } } }  // namespace iv::lv5::radio
@@ -3,6 +3,7 @@
 #include <gc/gc.h>
 #include <gc/gc_cpp.h>
 #include <iv/byteorder.h>
+#include <iv/cas.h>
 #include <iv/lv5/radio/color.h>
 #include <iv/lv5/radio/block_size.h>
 namespace iv {
@@ -77,7 +78,33 @@ class Cell {
   }
 
   void Coloring(Color::Type color) {
-    storage_.pair.color = color;
+    storage_.pair.color = (storage_.pair.color & ~Color::kMask) | color;
+  }
+
+  // atomically change color from `from` to `to`.
+  // used by parallel marker, returns true if this thread changed it
+  bool TryColoring(Color::Type from, Color::Type to) {
+    volatile int* target =
+        reinterpret_cast<volatile int*>(&storage_.pair.color);
+    const int old_value = *target;
+    if ((old_value & Color::kMask) != from) {
+      return false;
+    }
+    const int new_value = (old_value & ~Color::kMask) | to;
+    return core::thread::CompareAndSwap(
+        target, new_value, old_value) == old_value;
+  }
+
+  bool IsRemembered() const {
+    return storage_.pair.color & Color::kRemembered;
+  }
+
+  void set_remembered(bool remembered) {
+    if (remembered) {
+      storage_.pair.color |= Color::kRemembered;
+    } else {
+      storage_.pair.color &= ~Color::kRemembered;
+    }
   }
 
   Cell* next() const {
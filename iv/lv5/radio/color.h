@@ -12,6 +12,8 @@ struct Color {
     GRAY  = 3
   };
   static const int kMask = 3;
+  // flag bit, cell is in remembered set of radio::Core
+  static const int kRemembered = 4;
 };
 
 } } }  // namespace iv::lv5::radio
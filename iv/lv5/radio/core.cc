@@ -1,24 +1,65 @@
 #include <algorithm>
 #include <iv/functor.h>
+#include <iv/date_utils.h>
 #include <iv/lv5/jsval.h>
+#include <iv/lv5/error.h>
 #include <iv/lv5/context.h>
 #include <iv/lv5/radio/core.h>
 #include <iv/lv5/radio/scope.h>
 #include <iv/lv5/radio/block_control.h>
+#include <iv/lv5/radio/allocation_buffer.h>
+#include <iv/lv5/radio/parallel_marker.h>
 namespace iv {
 namespace lv5 {
 namespace radio {
+namespace {
+
+// lower bits of free list head are tag, which is incremented
+// at each update
+static const uintptr_t kFreeBlockTagMask = ~kBlockMask;
+
+inline Block* UntagBlock(uintptr_t head) {
+  return reinterpret_cast<Block*>(head & kBlockMask);
+}
+
+inline uintptr_t TagBlock(Block* block, uintptr_t head) {
+  return reinterpret_cast<uintptr_t>(block) | ((head + 1) & kFreeBlockTagMask);
+}
+
+}  // namespace anonymous
 
 Core::Core()
   : working_(nullptr),
-    free_blocks_(nullptr),
+    arenas_(0),
+    released_arenas_(0),
+    heap_limit_(0),
+    free_blocks_(0),
     weak_maps_(nullptr),
+    minor_(false),
+    marking_(false),
+    marking_step_budget_(kDefaultMarkingStepBudget),
+    slices_(),
+    pauses_(),
+    allocated_bytes_(0),
+    minor_collections_(0),
+    major_collections_(0),
+    marker_threads_(1),
+    parallel_(nullptr),
+    visitor_(nullptr),
+    buffer_(),
+    buffers_(nullptr),
+    concurrent_sweep_(false),
+    sweeper_(),
+    mutex_(),
+    nursery_blocks_(0),
+    old_blocks_(0),
+    major_gc_threshold_(kInitialMajorGCThreshold),
     handles_(),
     stack_(),
     persistents_(),
+    remembered_(),
     controls_() {
   stack_.reserve(kInitialMarkStackSize);
-  AddArena();
   std::size_t size = kBlockControlStep;
   for (BlockControls::iterator it = controls_.begin(),
        last = controls_.end(); it != last; ++it, size += kBlockControlStep) {
@@ -28,21 +69,102 @@ Core::Core()
 }
 
 Core::~Core() {
+  JoinSweeper();
+  assert(!buffers_);
+  // unused area of bump allocation blocks is not initialized
+  for (BlockControls::iterator it = controls_.begin(),
+       last = controls_.end(); it != last; ++it) {
+    it->RetireNursery();
+  }
   // Destroy All Arenas
   for (Arena* arena = working_; arena;) {
     Arena* next = arena->prev();
     arena->DestroyAllBlocks();
-    arena->~Arena();
+    delete arena;
     arena = next;
   }
 }
 
-Cell* Core::AllocateFrom(BlockControl* control) {
-  assert(control);
+void Core::AttachThread(AllocationBuffer* buffer) {
+  assert(!buffer_.get());
+  {
+    core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+    buffer->set_next(buffers_);
+    if (buffers_) {
+      buffers_->set_prev(buffer);
+    }
+    buffers_ = buffer;
+  }
+  buffer_.set(buffer);
+}
+
+void Core::DetachThread(AllocationBuffer* buffer) {
+  assert(buffer_.get() == buffer);
+  buffer_.set(nullptr);
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  // owned blocks are left in nursery and swept by next GC
+  allocated_bytes_ += buffer->allocated_bytes();
+  if (buffer->prev()) {
+    buffer->prev()->set_next(buffer->next());
+  } else {
+    buffers_ = buffer->next();
+  }
+  if (buffer->next()) {
+    buffer->next()->set_prev(buffer->prev());
+  }
+}
+
+void Core::RetireBuffers() {
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  for (AllocationBuffer* buffer = buffers_; buffer; buffer = buffer->next()) {
+    buffer->Retire();
+    buffer->reset_allocated_bytes();
+  }
+}
+
+Cell* Core::AllocateCell(BlockControl* control) {
+  if (AllocationBuffer* buffer = buffer_.get()) {
+    return buffer->Allocate(control - controls_.data(), control);
+  }
+  allocated_bytes_ += control->size();
   return control->Allocate(this);
 }
 
+Cell* Core::AllocateFrom(BlockControl* control, Context* ctx, Error* e) {
+  assert(control);
+  if (Cell* cell = AllocateCell(control)) {
+    return cell;
+  }
+  // heap limit is reached. collect all generations and retry
+  if (marking_) {
+    FinishIncrementalMarking(ctx);
+  }
+  CollectNursery(ctx);
+  CollectAll(ctx);
+  CompleteSweep();
+  if (Cell* cell = AllocateCell(control)) {
+    return cell;
+  }
+  if (e) {
+    e->Report(Error::Range, "radio heap limit exceeded");
+  }
+  return nullptr;
+}
+
 bool Core::MarkCell(Cell* cell) {
+  if (visitor_) {
+    if (cell) {
+      visitor_->Visit(cell);
+    }
+    return false;
+  }
+  // in minor GC, old cells are treated as live
+  if (minor_ && cell->block()->IsOld()) {
+    return false;
+  }
+  if (parallel_) {
+    return parallel_->MarkCell(cell);
+  }
   if (cell->color() == Color::WHITE) {
     cell->Coloring(Color::GRAY);
     stack_.push_back(cell);
@@ -51,10 +173,40 @@ bool Core::MarkCell(Cell* cell) {
   return false;
 }
 
+void Core::VisitChildren(Cell* cell, CellVisitor* visitor) {
+  assert(!visitor_);
+  visitor_ = visitor;
+  cell->MarkChildren(this);
+  visitor_ = nullptr;
+}
+
+void Core::VisitRoots(CellVisitor* visitor) {
+  assert(!visitor_);
+  visitor_ = visitor;
+  std::for_each(handles_.begin(), handles_.end(), Marker(this));
+  std::for_each(persistents_.begin(), persistents_.end(), Marker(this));
+  visitor_ = nullptr;
+}
+
+bool Core::Contains(const Cell* cell) const {
+  for (Arena* arena = working_; arena; arena = arena->prev()) {
+    if (arena->Contains(cell)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool Core::MarkValue(JSVal val) {
   return (val.IsCell()) ? MarkCell(val.cell()) : false;
 }
 
+void Core::WriteBarrier(Cell* owner, JSVal value) {
+  if (value.IsCell()) {
+    WriteBarrier(owner, value.cell());
+  }
+}
+
 bool Core::MarkPropertyDescriptor(const PropertyDescriptor& desc) {
   if (desc.IsData()) {
     return MarkValue(desc.AsDataDescriptor()->value());
@@ -73,9 +225,133 @@ bool Core::MarkPropertyDescriptor(const PropertyDescriptor& desc) {
 }
 
 void Core::CollectGarbage(Context* ctx) {
+  if (marking_) {
+    FinishIncrementalMarking(ctx);
+    return;
+  }
+  CollectNursery(ctx);
+  if (old_blocks_ >= major_gc_threshold_) {
+    CollectAll(ctx);
+  }
+}
+
+void Core::CollectNursery(Context* ctx) {
+  assert(!marking_);
+  const double start = core::date::HighResTime();
+  // mark & sweep young generation
+  MarkYoung(ctx);
+  CollectYoung(ctx);
+  ++minor_collections_;
+  RecordPause(start);
+}
+
+void Core::CollectAll(Context* ctx) {
+  const double start = core::date::HighResTime();
   // mark & sweep
   Mark(ctx);
   Collect(ctx);
+  major_gc_threshold_ =
+      (std::max)(old_blocks_ * 2, kInitialMajorGCThreshold);
+  ++major_collections_;
+  RecordPause(start);
+}
+
+void Core::StartIncrementalMarking(Context* ctx) {
+  assert(!marking_);
+  const double start = core::date::HighResTime();
+  CompleteSweep();
+  marking_ = true;
+  MarkRoots(ctx);
+  RecordSlice(start);
+}
+
+bool Core::IncrementalMarkingStep(Context* ctx) {
+  assert(marking_);
+  const double start = core::date::HighResTime();
+  const bool completed = Drain(marking_step_budget_);
+  RecordSlice(start);
+  return completed;
+}
+
+void Core::FinishIncrementalMarking(Context* ctx) {
+  assert(marking_);
+  const double start = core::date::HighResTime();
+  // handles may be changed after StartIncrementalMarking
+  MarkRoots(ctx);
+  do {
+    Drain();
+  } while (MarkWeaks());
+  assert(stack_.empty());
+  marking_ = false;
+  Collect(ctx);
+  major_gc_threshold_ =
+      (std::max)(old_blocks_ * 2, kInitialMajorGCThreshold);
+  ++major_collections_;
+  RecordSlice(start);
+}
+
+void Core::RecordSlice(double start) {
+  const double time = core::date::HighResTime() - start;
+  ++slices_.count;
+  slices_.total += time;
+  slices_.last = time;
+  slices_.max = (std::max)(slices_.max, time);
+  pauses_.Record(time);
+}
+
+void Core::RecordPause(double start) {
+  pauses_.Record(core::date::HighResTime() - start);
+}
+
+void Core::GetStatistics(HeapStatistics* stats) {
+  stats->controls.resize(controls_.size());
+  stats->used_bytes = 0;
+  for (std::size_t i = 0, len = controls_.size(); i < len; ++i) {
+    BlockControlStatistics* control = &stats->controls[i];
+    controls_[i].GetStatistics(control);
+    stats->used_bytes += control->used_cells * control->cell_size;
+  }
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  stats->arenas = arenas_;
+  stats->released_arenas = released_arenas_;
+  stats->blocks = stats->arenas * kBlocks;
+  stats->free_blocks = 0;
+  if (Block* first = TakeFreeBlocks()) {
+    Block* last = first;
+    for (Block* block = first; block; block = block->next()) {
+      ++stats->free_blocks;
+      last = block;
+    }
+    PushFreeBlocks(first, last);
+  }
+  stats->nursery_blocks = nursery_blocks_;
+  stats->old_blocks = old_blocks_;
+  stats->bytes_allocated_since_gc = allocated_bytes_;
+  for (AllocationBuffer* buffer = buffers_; buffer; buffer = buffer->next()) {
+    stats->bytes_allocated_since_gc += buffer->allocated_bytes();
+  }
+  stats->minor_collections = minor_collections_;
+  stats->major_collections = major_collections_;
+  stats->pauses = pauses_;
+}
+
+bool Core::Drain(std::size_t budget) {
+  for (; budget && !stack_.empty(); --budget) {
+    Cell* cell = stack_.back();
+    stack_.pop_back();
+    if (cell->color() == Color::GRAY) {
+      cell->MarkChildren(this);
+      cell->Coloring(Color::BLACK);
+    }
+  }
+  return stack_.empty();
+}
+
+void Core::DrainInParallel() {
+  ParallelMarker marker(this, marker_threads_);
+  parallel_ = &marker;
+  marker.Drain(&stack_);
+  parallel_ = nullptr;
 }
 
 void Core::Drain() {
@@ -106,7 +382,55 @@ void Core::MarkRoots(Context* ctx) {
   std::for_each(persistents_.begin(), persistents_.end(), Marker(this));
 }
 
+void Core::MarkRemembered() {
+  // remembered old cells are roots of minor GC
+  for (RememberedSet::const_iterator it = remembered_.begin(),
+       last = remembered_.end(); it != last; ++it) {
+    Cell* cell = *it;
+    if (cell->color() != Color::CLEAR) {
+      cell->MarkChildren(this);
+    }
+  }
+}
+
+void Core::ClearRemembered() {
+  for (RememberedSet::const_iterator it = remembered_.begin(),
+       last = remembered_.end(); it != last; ++it) {
+    (*it)->set_remembered(false);
+  }
+  remembered_.clear();
+}
+
+void Core::MarkYoung(Context* ctx) {
+  // old cells are not touched, but nursery sweeping conflicts with sweeper
+  JoinSweeper();
+  minor_ = true;
+  MarkRoots(ctx);
+  MarkRemembered();
+  do {
+    Drain();
+  } while (MarkWeaks());
+  assert(stack_.empty());
+  minor_ = false;
+}
+
+void Core::CollectYoung(Context* ctx) {
+  // all surviving young cells are promoted,
+  // so old cells don't refer young cells after this
+  ClearRemembered();
+  RetireBuffers();
+  allocated_bytes_ = 0;
+  for (BlockControls::iterator it = controls_.begin(),
+       last = controls_.end(); it != last; ++it) {
+    it->CollectNursery(this, ctx);
+  }
+  ReleaseEmptyArenas();
+}
+
 void Core::Mark(Context* ctx) {
+  // colors of unswept cells are stale
+  CompleteSweep();
+
   // mark all roots
   MarkRoots(ctx);
 
@@ -114,22 +438,144 @@ void Core::Mark(Context* ctx) {
   // http://wiki.ecmascript.org/doku.php?id=harmony:weak_maps#abstract_gc_algorithm
   // TODO(Constellation): stack all mark is faster? implement it.
   do {
-    Drain();
+    if (marker_threads_ > 1) {
+      DrainInParallel();
+    } else {
+      Drain();
+    }
   } while (MarkWeaks());
   assert(stack_.empty());
 }
 
 void Core::Collect(Context* ctx) {
+  ClearRemembered();
+  RetireBuffers();
+  allocated_bytes_ = 0;
+  // nursery blocks are swept here, and old blocks are swept
+  // lazily by BlockControl::Allocate or by background sweeper
   for (BlockControls::iterator it = controls_.begin(),
        last = controls_.end(); it != last; ++it) {
     it->Collect(this, ctx);
   }
+  if (concurrent_sweep_) {
+    sweeper_ = std::thread(&Core::SweepInBackground, this);
+  }
+}
+
+void Core::SweepInBackground() {
+  for (BlockControls::iterator it = controls_.begin(),
+       last = controls_.end(); it != last; ++it) {
+    it->CompleteSweep(this);
+  }
+}
+
+void Core::JoinSweeper() {
+  if (sweeper_.joinable()) {
+    sweeper_.join();
+    // arenas are not released while mutator may pop free blocks
+    ReleaseEmptyArenas();
+  }
+}
+
+void Core::CompleteSweep() {
+  JoinSweeper();
+  for (BlockControls::iterator it = controls_.begin(),
+       last = controls_.end(); it != last; ++it) {
+    it->CompleteSweep(this);
+  }
+  ReleaseEmptyArenas();
 }
 
 void Core::ReleaseBlock(Block* block) {
+  if (block->IsOld()) {
+    --old_blocks_;
+  } else {
+    assert(nursery_blocks_);
+    --nursery_blocks_;
+  }
+  block->arena()->RemoveUsedBlock();
   block->Release();
-  block->set_next(free_blocks_);
-  free_blocks_ = block;
+  PushFreeBlocks(block, block);
+}
+
+Block* Core::PopFreeBlock() {
+  uintptr_t head = free_blocks_.load(std::memory_order_acquire);
+  while (Block* block = UntagBlock(head)) {
+    // next of block may be stale if other thread popped it,
+    // but then tag is changed and CAS fails
+    if (free_blocks_.compare_exchange_weak(
+            head, TagBlock(block->next(), head),
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return block;
+    }
+  }
+  return nullptr;
+}
+
+void Core::PushFreeBlocks(Block* first, Block* last) {
+  uintptr_t head = free_blocks_.load(std::memory_order_relaxed);
+  do {
+    last->set_next(UntagBlock(head));
+  } while (!free_blocks_.compare_exchange_weak(
+          head, TagBlock(first, head),
+          std::memory_order_release, std::memory_order_relaxed));
+}
+
+Block* Core::TakeFreeBlocks() {
+  uintptr_t head = free_blocks_.load(std::memory_order_acquire);
+  while (!free_blocks_.compare_exchange_weak(
+          head, TagBlock(nullptr, head),
+          std::memory_order_acq_rel, std::memory_order_acquire)) { }
+  return UntagBlock(head);
+}
+
+void Core::ReleaseEmptyArenas() {
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  std::size_t retained = 0;
+  std::size_t releasing = 0;
+  for (Arena* arena = working_; arena; arena = arena->prev()) {
+    if (arena->IsEmpty()) {
+      if (retained < kRetainedEmptyArenas) {
+        ++retained;
+      } else {
+        arena->set_releasing(true);
+        ++releasing;
+      }
+    }
+  }
+  if (!releasing) {
+    return;
+  }
+  // unlink free blocks in releasing arenas
+  Block* head = nullptr;
+  Block* tail = nullptr;
+  for (Block* block = TakeFreeBlocks(); block;) {
+    Block* next = block->next();
+    if (!block->arena()->releasing()) {
+      if (tail) {
+        tail->set_next(block);
+      } else {
+        head = block;
+      }
+      tail = block;
+    }
+    block = next;
+  }
+  if (tail) {
+    PushFreeBlocks(head, tail);
+  }
+  for (Arena* arena = working_; arena;) {
+    Arena* prev = arena->prev();
+    if (arena->releasing()) {
+      if (arena == working_) {
+        working_ = prev;
+      }
+      delete arena;
+      --arenas_;
+      ++released_arenas_;
+    }
+    arena = prev;
+  }
 }
 
 } } }  // namespace iv::lv5::radio
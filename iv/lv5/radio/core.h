@@ -4,18 +4,25 @@
 #include <vector>
 #include <deque>
 #include <new>
+#include <thread>
+#include <atomic>
 #include <iv/detail/array.h>
 #include <iv/noncopyable.h>
+#include <iv/alloc.h>
 #include <iv/debug.h>
 #include <iv/arith.h>
+#include <iv/thread.h>
+#include <iv/thread_local.h>
 #include <iv/lv5/property_fwd.h>
 #include <iv/lv5/radio/arena.h>
 #include <iv/lv5/radio/cell.h>
 #include <iv/lv5/radio/block.h>
 #include <iv/lv5/radio/block_control.h>
+#include <iv/lv5/radio/statistics.h>
 namespace iv {
 namespace lv5 {
 class Context;
+class Error;
 namespace radio {
 
 static const std::size_t kInitialMarkStackSize =
@@ -23,9 +30,27 @@ static const std::size_t kInitialMarkStackSize =
 static const std::size_t kMaxObjectSize = 512;
 static const std::size_t kBlockControlStep = 16;
 static const std::size_t kBlockControls = kMaxObjectSize / kBlockControlStep;
+// nursery (young generation) blocks budget. 1 Arena
+static const std::size_t kNurseryBlocks = kBlocks;
+// minimum old blocks size to start major GC
+static const std::size_t kInitialMajorGCThreshold = kBlocks * 4;
+// default number of cells traced in one incremental marking slice
+static const std::size_t kDefaultMarkingStepBudget = 1024;
+// empty arenas kept for next allocation instead of returning to the OS
+static const std::size_t kRetainedEmptyArenas = 1;
 
 class BlockControl;
 class Scope;
+class ParallelMarker;
+class AllocationBuffer;
+
+// receives cells reported by Cell::MarkChildren instead of marking them.
+// used to walk object graph without touching mark bits
+class CellVisitor {
+ public:
+  virtual ~CellVisitor() { }
+  virtual void Visit(Cell* cell) = 0;
+};
 
 class Core : private core::Noncopyable<Core> {
  public:
@@ -33,31 +58,203 @@ class Core : private core::Noncopyable<Core> {
   typedef std::vector<Cell*> MarkStack;
   typedef std::deque<Cell*> HandleStack;
   typedef std::deque<Cell*> PersistentStack;
+  // remembered set may be grown in attached threads
+  typedef std::vector<Cell*, core::MallocAllocator<Cell*> > RememberedSet;
+
+  // incremental marking slice durations (ms)
+  struct SliceStatistics {
+    SliceStatistics() : count(0), total(0), max(0), last(0) { }
+    std::size_t count;
+    double total;
+    double max;
+    double last;
+  };
+
   Core();
 
   ~Core();
 
   // allocate memory for radio::Cell
+  // returns nullptr if heap limit is exceeded even after full GC
   template<typename T>
   Cell* Allocate() {
+    return Allocate<T>(nullptr, nullptr);
+  }
+
+  // if heap limit is exceeded even after full GC, reports RangeError
+  template<typename T>
+  Cell* Allocate(Context* ctx, Error* e) {
     static_assert(std::is_base_of<Cell, T>::value, "Cell should be base of T");
     return AllocateFrom(
-        GetBlockControl<IV_ROUNDUP(sizeof(T), kBlockControlStep)>());
+        GetBlockControl<IV_ROUNDUP(sizeof(T), kBlockControlStep)>(), ctx, e);
   }
 
   // GC trigger
+  // perform minor GC, and major GC if old generation grows
   void CollectGarbage(Context* ctx);
 
+  // minor GC, mark & sweep young generation only
+  void CollectNursery(Context* ctx);
+
+  // major GC, mark & sweep all generations
+  void CollectAll(Context* ctx);
+
+  // incremental marking
+  // marks roots and starts tri-color marking. mutator must notify stores
+  // by WriteBarrier while marking
+  void StartIncrementalMarking(Context* ctx);
+
+  // trace at most marking_step_budget cells.
+  // returns true when no gray cell is left
+  bool IncrementalMarkingStep(Context* ctx);
+
+  // rescan roots, complete marking and sweep
+  void FinishIncrementalMarking(Context* ctx);
+
+  bool IsMarking() const { return marking_; }
+
+  std::size_t marking_step_budget() const { return marking_step_budget_; }
+
+  void set_marking_step_budget(std::size_t budget) {
+    assert(budget);
+    marking_step_budget_ = budget;
+  }
+
+  const SliceStatistics& slice_statistics() const { return slices_; }
+
+  // pauses of minor GC, major GC and incremental marking slices
+  const PauseHistogram& pauses() const { return pauses_; }
+
+  // snapshot of heap occupancy and GC telemetry
+  void GetStatistics(HeapStatistics* stats);
+
+  // sweep all old blocks which are not swept lazily yet
+  void CompleteSweep();
+
+  // sweep old blocks on background thread after major GC marking
+  bool concurrent_sweep() const { return concurrent_sweep_; }
+
+  void set_concurrent_sweep(bool concurrent) {
+    concurrent_sweep_ = concurrent;
+  }
+
+  // number of threads used in marking phase of major GC
+  std::size_t marker_threads() const { return marker_threads_; }
+
+  void set_marker_threads(std::size_t threads) {
+    assert(threads);
+    marker_threads_ = threads;
+  }
+
+  // maximum bytes of arenas. 0 means unlimited.
+  // heap grows by kArenaSize, so limit is rounded down to it
+  std::size_t heap_limit() const { return heap_limit_; }
+
+  void set_heap_limit(std::size_t bytes) {
+    heap_limit_ = bytes;
+  }
+
+  // thread local allocation buffer
+  // after attaching, cells allocated in current thread are bump allocated
+  // in blocks owned by this thread without lock.
+  // GC must not run while other threads allocate cells.
+  // called by AllocationBuffer
+  void AttachThread(AllocationBuffer* buffer);
+
+  void DetachThread(AllocationBuffer* buffer);
+
+  // returns nullptr when heap limit is reached
   Block* AllocateBlock(std::size_t size) {
-    if (free_blocks_) {
-      Block* block = free_blocks_;
-      free_blocks_ = free_blocks_->next();
-      return new(block)Block(size);
+    Block* block = PopFreeBlock();
+    if (!block) {
+      core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+      // other thread may add arena
+      while (!(block = PopFreeBlock())) {
+        if (!AddArena()) {
+          return nullptr;
+        }
+      }
+    }
+    Arena* arena = block->arena();
+    arena->AddUsedBlock();
+    return new(block)Block(size, arena);
+  }
+
+  // returns nullptr when nursery is exhausted
+  Block* AllocateNurseryBlock(std::size_t size) {
+    if (nursery_blocks_.fetch_add(1) >= kNurseryBlocks) {
+      --nursery_blocks_;
+      return nullptr;
+    }
+    Block* block = AllocateBlock(size);
+    if (!block) {
+      --nursery_blocks_;
     }
-    AddArena();
-    return AllocateBlock(size);
+    return block;
   }
 
+  Block* AllocateOldBlock(std::size_t size) {
+    Block* block = AllocateBlock(size);
+    if (!block) {
+      return nullptr;
+    }
+    block->Promote();
+    ++old_blocks_;
+    return block;
+  }
+
+  // young block survives GC
+  void PromoteBlock(Block* block) {
+    assert(!block->IsOld());
+    assert(nursery_blocks_);
+    --nursery_blocks_;
+    block->Promote();
+    ++old_blocks_;
+  }
+
+  // write barrier
+  // when young cell is stored to old cell, remember old cell.
+  // and while incremental marking, white cell stored to black cell
+  // is grayed to keep tri-color invariant
+  void WriteBarrier(Cell* owner, Cell* value) {
+    if (!value) {
+      return;
+    }
+    if (owner->block()->IsOld() && !value->block()->IsOld()) {
+      Remember(owner);
+    }
+    if (marking_ && owner->color() == Color::BLACK) {
+      MarkCell(value);
+    }
+  }
+
+  void WriteBarrier(Cell* owner, JSVal value);
+
+  void Remember(Cell* cell) {
+    if (!cell->IsRemembered()) {
+      core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+      cell->set_remembered(true);
+      remembered_.push_back(cell);
+    }
+  }
+
+  bool IsCollectingNursery() const { return minor_; }
+
+  std::size_t nursery_blocks() const { return nursery_blocks_; }
+
+  std::size_t old_blocks() const { return old_blocks_; }
+
+  std::size_t arenas() const { return arenas_; }
+
+  // report children of cell to visitor
+  void VisitChildren(Cell* cell, CellVisitor* visitor);
+
+  // report handles and persistent handles to visitor
+  void VisitRoots(CellVisitor* visitor);
+
+  // cell is allocated in arenas of this core
+  bool Contains(const Cell* cell) const;
+
   void ChainToScope(Cell* cell) {
     handles_.push_back(cell);
   }
@@ -93,6 +290,10 @@ class Core : private core::Noncopyable<Core> {
 
   void Collect(Context* ctx);
 
+  void MarkYoung(Context* ctx);
+
+  void CollectYoung(Context* ctx);
+
   void ReleaseBlock(Block* block);
 
   struct Marker {
@@ -112,37 +313,80 @@ class Core : private core::Noncopyable<Core> {
   };
 
  private:
-  void AddArena() {
-    assert(!free_blocks_);
+  // returns false when heap limit is reached
+  bool AddArena() {
+    if (heap_limit_ && (arenas_ + 1) * kArenaSize > heap_limit_) {
+      return false;
+    }
     working_ = new Arena(working_);
+    ++arenas_;
     // assign
     Arena::iterator it = working_->begin();
     const Arena::const_iterator last = working_->end();
     assert(it != last);
-    Block* prev = free_blocks_ = &*it;
+    Block* first = &*it;
+    Block* prev = first;
+    prev->set_arena(working_);
     prev->Release();
     ++it;
     while (true) {
       if (it != last) {
         Block* block = &*it;
+        block->set_arena(working_);
         block->Release();
         prev->set_next(block);
         prev = block;
         ++it;
       } else {
-        prev->set_next(nullptr);
         break;
       }
     }
+    PushFreeBlocks(first, prev);
+    return true;
   }
 
+  // free blocks are chained in lock free stack.
+  // blocks are aligned to kBlockSize, so lower bits of head hold tag
+  // to avoid ABA problem
+  Block* PopFreeBlock();
+
+  void PushFreeBlocks(Block* first, Block* last);
+
+  // take all free blocks. mutex_ should be locked
+  Block* TakeFreeBlocks();
+
+  // retire allocation buffers of all threads before sweeping
+  void RetireBuffers();
+
+  // return empty arenas to the OS
+  void ReleaseEmptyArenas();
+
   void MarkRoots(Context* ctx);
 
+  void MarkRemembered();
+
+  void ClearRemembered();
+
   bool MarkWeaks();
 
   void Drain();
 
-  Cell* AllocateFrom(BlockControl* control);
+  // returns true when mark stack becomes empty
+  bool Drain(std::size_t budget);
+
+  void DrainInParallel();
+
+  void SweepInBackground();
+
+  void JoinSweeper();
+
+  void RecordSlice(double start);
+
+  void RecordPause(double start);
+
+  Cell* AllocateFrom(BlockControl* control, Context* ctx, Error* e);
+
+  Cell* AllocateCell(BlockControl* control);
 
   template<std::size_t N>
   BlockControl* GetBlockControl() {
@@ -161,11 +405,34 @@ class Core : private core::Noncopyable<Core> {
   Cell* weak_maps() const { return weak_maps_; }
 
   Arena* working_;
-  Block* free_blocks_;
+  std::size_t arenas_;
+  std::size_t released_arenas_;
+  std::size_t heap_limit_;
+  std::atomic<uintptr_t> free_blocks_;  // tagged head of free blocks
   Cell* weak_maps_;
+  bool minor_;  // in minor GC
+  bool marking_;  // in incremental marking
+  std::size_t marking_step_budget_;
+  SliceStatistics slices_;
+  PauseHistogram pauses_;
+  std::size_t allocated_bytes_;  // since last GC
+  std::size_t minor_collections_;
+  std::size_t major_collections_;
+  std::size_t marker_threads_;
+  ParallelMarker* parallel_;  // marker while parallel marking
+  CellVisitor* visitor_;  // visitor while VisitChildren
+  core::ThreadLocalPtr<AllocationBuffer> buffer_;  // buffer of current thread
+  AllocationBuffer* buffers_;  // buffers of all attached threads
+  bool concurrent_sweep_;
+  std::thread sweeper_;
+  core::thread::Mutex mutex_;  // lock blocks for concurrent sweeping
+  std::atomic<std::size_t> nursery_blocks_;
+  std::atomic<std::size_t> old_blocks_;
+  std::size_t major_gc_threshold_;
   HandleStack handles_;  // scoped handles
   MarkStack stack_;  // mark stack
   PersistentStack persistents_;  // persistent handles
+  RememberedSet remembered_;  // old cells which may refer young cells
   BlockControls controls_;  // blocks. first block is 8 bytes
 };
 
@@ -0,0 +1,148 @@
+#include <thread>
+#include <iv/lv5/radio/core.h>
+#include <iv/lv5/radio/parallel_marker.h>
+namespace iv {
+namespace lv5 {
+namespace radio {
+
+void ParallelMarker::Worker::Push(Cell* cell) {
+  local_.push_back(cell);
+  if (local_.size() > kMarkStackPublishThreshold) {
+    // publish older half
+    const std::size_t half = local_.size() / 2;
+    core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+    shared_.insert(shared_.end(), local_.begin(), local_.begin() + half);
+    local_.erase(local_.begin(), local_.begin() + half);
+  }
+}
+
+Cell* ParallelMarker::Worker::Pop() {
+  if (!local_.empty()) {
+    Cell* cell = local_.back();
+    local_.pop_back();
+    return cell;
+  }
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  if (shared_.empty()) {
+    return nullptr;
+  }
+  Cell* cell = shared_.back();
+  shared_.pop_back();
+  return cell;
+}
+
+bool ParallelMarker::Worker::StealFrom(Worker* victim) {
+  MarkStack stolen;
+  {
+    core::thread::ScopedLock<core::thread::Mutex> lock(&victim->mutex_);
+    if (victim->shared_.empty()) {
+      return false;
+    }
+    const std::size_t size = (victim->shared_.size() + 1) / 2;
+    stolen.assign(victim->shared_.begin(), victim->shared_.begin() + size);
+    victim->shared_.erase(victim->shared_.begin(),
+                          victim->shared_.begin() + size);
+  }
+  local_.insert(local_.end(), stolen.begin(), stolen.end());
+  return true;
+}
+
+bool ParallelMarker::Worker::HasSharedCells() {
+  core::thread::ScopedLock<core::thread::Mutex> lock(&mutex_);
+  return !shared_.empty();
+}
+
+ParallelMarker::ParallelMarker(Core* core, std::size_t threads)
+  : core_(core),
+    workers_(),
+    current_(),
+    active_(0) {
+  assert(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    workers_.push_back(std::unique_ptr<Worker>(new Worker));
+  }
+}
+
+bool ParallelMarker::MarkCell(Cell* cell) {
+  if (cell->TryColoring(Color::WHITE, Color::GRAY)) {
+    Worker* worker = current_.get();
+    assert(worker);
+    worker->Push(cell);
+    return true;
+  }
+  return false;
+}
+
+void ParallelMarker::Drain(MarkStack* stack) {
+  // distribute initial gray cells
+  for (std::size_t i = 0, len = stack->size(); i < len; ++i) {
+    workers_[i % workers_.size()]->Push((*stack)[i]);
+  }
+  stack->clear();
+  active_ = workers_.size();
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < workers_.size(); ++i) {
+    threads.push_back(
+        std::thread(&ParallelMarker::Run, this, workers_[i].get()));
+  }
+  // main thread is the first marker
+  Run(workers_.front().get());
+  for (std::vector<std::thread>::iterator it = threads.begin(),
+       last = threads.end(); it != last; ++it) {
+    it->join();
+  }
+  assert(!HasSharedCells());
+}
+
+void ParallelMarker::Run(Worker* worker) {
+  current_.set(worker);
+  while (true) {
+    while (Cell* cell = worker->Pop()) {
+      if (cell->color() == Color::GRAY) {
+        cell->MarkChildren(core_);
+        cell->Coloring(Color::BLACK);
+        worker->Count();
+      }
+    }
+    if (Steal(worker)) {
+      continue;
+    }
+    // termination detection.
+    // cells are only held by active workers or in shared stacks,
+    // so when no worker is active and no cell is shared, marking is done
+    --active_;
+    while (true) {
+      if (HasSharedCells()) {
+        ++active_;
+        break;
+      }
+      if (active_ == 0) {
+        current_.set(nullptr);
+        return;
+      }
+      core::thread::YieldCPU();
+    }
+  }
+}
+
+bool ParallelMarker::Steal(Worker* worker) {
+  for (std::vector<std::unique_ptr<Worker> >::const_iterator
+       it = workers_.begin(), last = workers_.end(); it != last; ++it) {
+    if (it->get() != worker && worker->StealFrom(it->get())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ParallelMarker::HasSharedCells() {
+  for (std::vector<std::unique_ptr<Worker> >::const_iterator
+       it = workers_.begin(), last = workers_.end(); it != last; ++it) {
+    if ((*it)->HasSharedCells()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} } }  // namespace iv::lv5::radio
@@ -0,0 +1,77 @@
+// parallel marker of radio::Core
+// each marker thread has its own mark stack and
+// idle threads steal cells from shared part of other threads' stacks
+#ifndef IV_LV5_RADIO_PARALLEL_MARKER_H_
+#define IV_LV5_RADIO_PARALLEL_MARKER_H_
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <iv/noncopyable.h>
+#include <iv/thread.h>
+#include <iv/thread_local.h>
+#include <iv/lv5/radio/cell.h>
+namespace iv {
+namespace lv5 {
+namespace radio {
+
+class Core;
+
+// when local mark stack exceeds this, half of it is published for stealing
+static const std::size_t kMarkStackPublishThreshold = 64;
+
+class ParallelMarker : private core::Noncopyable<ParallelMarker> {
+ public:
+  typedef std::vector<Cell*> MarkStack;
+
+  class Worker : private core::Noncopyable<Worker> {
+   public:
+    Worker() : local_(), shared_(), mutex_(), marked_(0) { }
+
+    void Push(Cell* cell);
+
+    Cell* Pop();
+
+    // steal half of shared cells of victim
+    bool StealFrom(Worker* victim);
+
+    bool HasSharedCells();
+
+    std::size_t marked() const { return marked_; }
+
+    void Count() { ++marked_; }
+
+   private:
+    MarkStack local_;
+    std::deque<Cell*> shared_;
+    core::thread::Mutex mutex_;
+    std::size_t marked_;
+  };
+
+  ParallelMarker(Core* core, std::size_t threads);
+
+  // trace all cells reachable from cells in stack. stack becomes empty
+  void Drain(MarkStack* stack);
+
+  // called from Core::MarkCell in marker threads
+  bool MarkCell(Cell* cell);
+
+  std::size_t threads() const { return workers_.size(); }
+
+  const Worker& worker(std::size_t i) const { return *workers_[i]; }
+
+ private:
+  void Run(Worker* worker);
+
+  bool Steal(Worker* worker);
+
+  bool HasSharedCells();
+
+  Core* core_;
+  std::vector<std::unique_ptr<Worker> > workers_;
+  core::ThreadLocalPtr<Worker> current_;
+  std::atomic<std::size_t> active_;
+};
+
+} } }  // namespace iv::lv5::radio
+#endif  // IV_LV5_RADIO_PARALLEL_MARKER_H_
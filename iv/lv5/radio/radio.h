@@ -2,6 +2,7 @@
 #define IV_LV5_RADIO_RADIO_H_
 
 // RadioNoise is GC
+#include <iv/lv5/radio/allocation_buffer.h>
 #include <iv/lv5/radio/arena.h>
 #include <iv/lv5/radio/block.h>
 #include <iv/lv5/radio/block_control.h>
@@ -9,6 +10,8 @@
 #include <iv/lv5/radio/cell.h>
 #include <iv/lv5/radio/color.h>
 #include <iv/lv5/radio/core.h>
+#include <iv/lv5/radio/parallel_marker.h>
 #include <iv/lv5/radio/scope.h>
+#include <iv/lv5/radio/statistics.h>
 
 #endif  // IV_LV5_RADIO_RADIO_H_
@@ -0,0 +1,128 @@
+// heap statistics and pause time telemetry of GC
+#ifndef IV_LV5_RADIO_STATISTICS_H_
+#define IV_LV5_RADIO_STATISTICS_H_
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <iv/detail/array.h>
+#include <iv/detail/cstdint.h>
+#include <iv/debug.h>
+#include <iv/utils.h>
+#include <iv/lv5/radio/block_size.h>
+namespace iv {
+namespace lv5 {
+namespace radio {
+
+// GC pause histogram (ms).
+// bucket i counts pauses shorter than 2^i ms, and the last bucket
+// counts all longer pauses
+class PauseHistogram {
+ public:
+  static const std::size_t kBuckets = 16;
+  typedef std::array<std::size_t, kBuckets> Buckets;
+
+  PauseHistogram()
+    : buckets_(),
+      count_(0),
+      total_(0),
+      max_(0),
+      last_(0) {
+    buckets_.fill(0);
+  }
+
+  void Record(double time) {
+    std::size_t index = 0;
+    for (double limit = 1.0;
+         index < (kBuckets - 1) && time >= limit; limit *= 2) {
+      ++index;
+    }
+    ++buckets_[index];
+    ++count_;
+    total_ += time;
+    last_ = time;
+    max_ = (std::max)(max_, time);
+  }
+
+  // upper bound of bucket (exclusive)
+  static double BucketLimit(std::size_t index) {
+    assert(index < kBuckets);
+    if (index == (kBuckets - 1)) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return static_cast<double>(static_cast<std::size_t>(1) << index);
+  }
+
+  const Buckets& buckets() const { return buckets_; }
+
+  std::size_t count() const { return count_; }
+
+  double total() const { return total_; }
+
+  double max() const { return max_; }
+
+  double last() const { return last_; }
+
+  double mean() const { return (count_) ? total_ / count_ : 0; }
+
+ private:
+  Buckets buckets_;
+  std::size_t count_;
+  double total_;
+  double max_;
+  double last_;
+};
+
+// occupancy of one size class
+struct BlockControlStatistics {
+  BlockControlStatistics()
+    : cell_size(0), blocks(0), cells(0), used_cells(0) { }
+  std::size_t cell_size;
+  std::size_t blocks;
+  std::size_t cells;  // capacity of assigned blocks
+  // allocated cells. cells in lazily swept blocks are counted
+  // until they are swept, so call Core::CompleteSweep for exact live cells
+  std::size_t used_cells;
+};
+
+struct HeapStatistics {
+  typedef std::vector<BlockControlStatistics> Controls;
+
+  HeapStatistics()
+    : arenas(0),
+      released_arenas(0),
+      blocks(0),
+      free_blocks(0),
+      nursery_blocks(0),
+      old_blocks(0),
+      used_bytes(0),
+      bytes_allocated_since_gc(0),
+      minor_collections(0),
+      major_collections(0),
+      controls(),
+      pauses() { }
+
+  // ratio of unused bytes in assigned (nursery and old) blocks
+  double fragmentation() const {
+    const std::size_t assigned = (nursery_blocks + old_blocks) * kBlockSize;
+    if (!assigned) {
+      return 0;
+    }
+    return 1.0 - static_cast<double>(used_bytes) / assigned;
+  }
+
+  std::size_t arenas;
+  std::size_t released_arenas;  // returned to the OS
+  std::size_t blocks;  // all blocks in arenas
+  std::size_t free_blocks;
+  std::size_t nursery_blocks;
+  std::size_t old_blocks;
+  std::size_t used_bytes;
+  std::size_t bytes_allocated_since_gc;
+  std::size_t minor_collections;
+  std::size_t major_collections;
+  Controls controls;
+  PauseHistogram pauses;
+};
+
+} } }  // namespace iv::lv5::radio
+#endif  // IV_LV5_RADIO_STATISTICS_H_
@@ -1,6 +1,7 @@
 #ifndef IV_LV5_RAILGUN_API_H_
 #define IV_LV5_RAILGUN_API_H_
 #include <iv/lv5/railgun/context.h>
+#include <iv/lv5/railgun/code_cache.h>
 namespace iv {
 namespace lv5 {
 namespace railgun {
@@ -9,23 +10,36 @@ inline Code* CompileInGlobal(Context* ctx,
                              std::shared_ptr<core::FileSource> src,
                              bool use_folded_registers,
                              Error* e) {
+  JSScript* script = JSSourceScript<core::FileSource>::New(ctx, src);
+  const CodeCache cache(ctx, use_folded_registers);
+  if (Code* code = cache.Load(*src.get(), script)) {
+    return code;
+  }
   AstFactory factory(ctx);
   core::Parser<
       AstFactory,
       core::FileSource> parser(&factory, *src.get(), ctx->symbol_table());
   const FunctionLiteral* const global = parser.ParseProgram();
-  JSScript* script = JSSourceScript<core::FileSource>::New(ctx, src);
   if (!global) {
     e->Report(
         parser.reference_error() ? Error::Reference : Error::Syntax,
         parser.error());
     return nullptr;
   }
-  Code* code = CompileGlobal(ctx, *global, script, use_folded_registers);
+  // functions are reparsed and compiled at first invocation, unless
+  // whole code is required at once by breaker / disassembler
+  // (folded registers) or code cache
+  std::shared_ptr<core::FileSource> lazy_source;
+  if (!use_folded_registers && !cache.IsEnabled()) {
+    lazy_source = src;
+  }
+  Code* code =
+      CompileGlobal(ctx, *global, script, use_folded_registers, lazy_source);
   if (!code) {
     e->Report(Error::Syntax, "something wrong");
     return nullptr;
   }
+  cache.Store(*src.get(), *global, code);
   return code;
 }
 
@@ -29,6 +29,8 @@ class Code : public radio::HeapObject<radio::POINTER> {
   };
   friend class Compiler;
   friend class ConstantPool;
+  friend class CodeSerializer;
+  friend class CodeDeserializer;
   friend class breaker::Compiler;
   typedef GCVector<Symbol>::type Names;
   typedef CoreData::Data Data;
@@ -64,7 +66,10 @@ class Code : public radio::HeapObject<radio::POINTER> {
       maps_(),
       exception_table_(),
       construct_map_(nullptr),
-      executable_(nullptr) {
+      executable_(nullptr),
+      native_code_(nullptr),
+      has_osr_entry_(false),
+      lazy_(nullptr) {
     if (has_name_) {
       name_ = func.name().Address()->symbol();
     }
@@ -201,6 +206,16 @@ class Code : public radio::HeapObject<radio::POINTER> {
 
   void* executable() const { return executable_; }
 
+  // native code which executable is in, owned by CoreData
+  const breaker::NativeCode* native_code() const { return native_code_; }
+
+  // native code has entries at loop headers of this code.
+  // VM checks it before leaving interpreter loop for OSR
+  bool HasOSREntry() const { return has_osr_entry_; }
+
+  // not null until bytecode is emitted by CompileLazyCode
+  LazyCode* lazy() const { return lazy_; }
+
   void RegisterMap(Map* map) { maps_.push_back(map); }
 
   void MarkChildren(radio::Core* core) {
@@ -217,7 +232,42 @@ class Code : public radio::HeapObject<radio::POINTER> {
     return ++hot_code_counter_;
   }
 
+  uint32_t hot_code_counter() const { return hot_code_counter_; }
+
  private:
+  // restored by CodeDeserializer
+  Code(JSScript* script, CoreData* core, CodeType code_type)
+    : code_type_(code_type),
+      strict_(false),
+      empty_(false),
+      has_name_(false),
+      needs_declarative_environment_(false),
+      this_materialized_(false),
+      heap_size_(0),
+      stack_size_(0),
+      temporary_registers_(0),
+      frame_size_(0),
+      hot_code_counter_(0),
+      name_(),
+      script_(script),
+      block_begin_position_(0),
+      block_end_position_(0),
+      core_(core),
+      start_(),
+      end_(),
+      codes_(),
+      names_(),
+      params_(),
+      constants_(),
+      maps_(),
+      exception_table_(),
+      construct_map_(nullptr),
+      executable_(nullptr),
+      native_code_(nullptr),
+      has_osr_entry_(false),
+      lazy_(nullptr) {
+  }
+
   void set_start(std::size_t start) { start_ = start; }
 
   void set_end(std::size_t end) { end_ = end; }
@@ -230,6 +280,14 @@ class Code : public radio::HeapObject<radio::POINTER> {
 
   void set_empty(bool val) { empty_ = val; }
 
+  void set_native_code(breaker::NativeCode* code) { native_code_ = code; }
+
+  void set_has_osr_entry(bool val) { has_osr_entry_ = val; }
+
+  void set_lazy(LazyCode* lazy) { lazy_ = lazy; }
+
+  void set_core_data(CoreData* core) { core_ = core; }
+
   void set_this_materialized(bool val) { this_materialized_ = val; }
 
   void set_needs_declarative_environment(bool val) {
@@ -266,6 +324,9 @@ class Code : public radio::HeapObject<radio::POINTER> {
   ExceptionTable exception_table_;
   Map* construct_map_;
   void* executable_;
+  breaker::NativeCode* native_code_;
+  bool has_osr_entry_;
+  LazyCode* lazy_;
 };
 
 } } }  // namespace iv::lv5::railgun
@@ -0,0 +1,1412 @@
+// persistent bytecode cache
+//
+// compiled global code is serialized to file keyed by hash of source,
+// and it is loaded by mmap in the next execution of the same source,
+// so parsing and compiling are skipped. the file holds the source itself,
+// and it is compared with the given source when loading, so code of
+// the other source which has the same hash is never loaded.
+//
+// serialized code is compiled, but not executed code. so IC slots in
+// instructions are reset and instructions rewritten by IC are restored to
+// generic ones. compile time values depending on the realm (global
+// declarations, global variable slots, object literal maps) are recorded
+// symbolically and resolved when loading. if they can't be resolved,
+// loading fails and source is compiled as usual.
+#ifndef IV_LV5_RAILGUN_CODE_CACHE_H_
+#define IV_LV5_RAILGUN_CODE_CACHE_H_
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iv/detail/unordered_set.h>
+#include <iv/conversions.h>
+#include <iv/file_source.h>
+#include <iv/platform_io.h>
+#include <iv/lv5/jsval.h>
+#include <iv/lv5/jsstring.h>
+#include <iv/lv5/jsregexp.h>
+#include <iv/lv5/jsarray.h>
+#include <iv/lv5/jsvector.h>
+#include <iv/lv5/jsglobal.h>
+#include <iv/lv5/map_builder.h>
+#include <iv/lv5/property_names_collector.h>
+#include <iv/lv5/railgun/fwd.h>
+#include <iv/lv5/railgun/code.h>
+#include <iv/lv5/railgun/core_data.h>
+#include <iv/lv5/railgun/context_fwd.h>
+#include <iv/lv5/railgun/compiler.h>
+namespace iv {
+namespace lv5 {
+namespace railgun {
+
+class CodeSerializer : private core::Noncopyable<CodeSerializer> {
+ public:
+  typedef std::vector<char> Buffer;
+
+  enum ConstantType {
+    CONSTANT_UNDEFINED,
+    CONSTANT_NULL,
+    CONSTANT_TRUE,
+    CONSTANT_FALSE,
+    CONSTANT_EMPTY,
+    CONSTANT_NUMBER,
+    CONSTANT_STRING,
+    CONSTANT_REGEXP,
+    CONSTANT_ARRAY
+  };
+
+  explicit CodeSerializer(Context* ctx, Buffer* buffer)
+    : ctx_(ctx),
+      buffer_(buffer) {
+  }
+
+  // global declarations are instantiated at compile time,
+  // so they are recorded from global FunctionLiteral.
+  // returns false if code has values which can't be serialized
+  bool Serialize(const FunctionLiteral& global, Code* code) {
+    const CoreData::Lines& lines = code->core_data()->lines();
+    Write<uint64_t>(code->GetData()->size());
+    Write<uint32_t>(lines.size());
+    for (CoreData::Lines::const_iterator it = lines.begin(),
+         last = lines.end(); it != last; ++it) {
+      Write<uint64_t>(it->first);
+      Write<uint64_t>(it->second);
+    }
+
+    const Scope& scope = global.scope();
+    typedef Scope::FunctionLiterals Functions;
+    const Functions& functions = scope.function_declarations();
+    Write<uint32_t>(functions.size());
+    for (Functions::const_iterator it = functions.begin(),
+         last = functions.end(); it != last; ++it) {
+      const uint32_t index = LookupCode(code, **it);
+      if (index == core::kNotFound32) {
+        return false;
+      }
+      if (!WriteSymbol((*it)->name().Address()->symbol())) {
+        return false;
+      }
+      Write<uint32_t>(index);
+    }
+
+    typedef Scope::Variables Variables;
+    const Variables& vars = scope.variables();
+    Write<uint32_t>(vars.size());
+    for (Variables::const_iterator it = vars.begin(),
+         last = vars.end(); it != last; ++it) {
+      if (!WriteSymbol(it->first->symbol())) {
+        return false;
+      }
+    }
+    return SerializeCode(code);
+  }
+
+ private:
+  static uint32_t LookupCode(const Code* code, const FunctionLiteral& lit) {
+    uint32_t index = 0;
+    for (Code::Codes::const_iterator it = code->codes().begin(),
+         last = code->codes().end(); it != last; ++it, ++index) {
+      if ((*it)->block_begin_position() == lit.block_begin_position()) {
+        return index;
+      }
+    }
+    return core::kNotFound32;
+  }
+
+  bool SerializeCode(Code* code) {
+    Write<uint32_t>(code->code_type());
+    Write<uint8_t>(code->strict());
+    Write<uint8_t>(code->empty());
+    Write<uint8_t>(code->HasName());
+    Write<uint8_t>(code->needs_declarative_environment());
+    Write<uint8_t>(code->IsThisMaterialized());
+    Write<uint32_t>(code->heap_size());
+    Write<uint32_t>(code->stack_size());
+    Write<uint32_t>(code->temporary_registers());
+    Write<uint32_t>(code->FrameSize());
+    if (code->HasName() && !WriteSymbol(code->name())) {
+      return false;
+    }
+    Write<uint64_t>(code->block_begin_position());
+    Write<uint64_t>(code->block_end_position());
+    if (!WriteSymbols(code->names()) || !WriteSymbols(code->params())) {
+      return false;
+    }
+
+    Write<uint32_t>(code->constants().size());
+    for (JSVals::const_iterator it = code->constants().begin(),
+         last = code->constants().end(); it != last; ++it) {
+      if (!WriteConstant(*it, true)) {
+        return false;
+      }
+    }
+
+    Write<uint32_t>(code->maps_.size());
+    for (Code::Maps::const_iterator it = code->maps_.begin(),
+         last = code->maps_.end(); it != last; ++it) {
+      if (!WriteMap(*it)) {
+        return false;
+      }
+    }
+
+    const ExceptionTable& table = code->exception_table();
+    Write<uint32_t>(table.size());
+    for (ExceptionTable::const_iterator it = table.begin(),
+         last = table.end(); it != last; ++it) {
+      Write<uint32_t>(it->type());
+      Write<int16_t>(it->jmp());
+      Write<int16_t>(it->ret());
+      Write<int16_t>(it->flag());
+      Write<uint32_t>(it->begin());
+      Write<uint32_t>(it->end());
+    }
+
+    if (!WriteInstructions(code)) {
+      return false;
+    }
+
+    Write<uint32_t>(code->codes().size());
+    for (Code::Codes::const_iterator it = code->codes().begin(),
+         last = code->codes().end(); it != last; ++it) {
+      if (!SerializeCode(*it)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool WriteInstructions(Code* code) {
+    Write<uint64_t>(code->start());
+    Write<uint64_t>(code->end() - code->GetData()->data());
+    JSGlobal* global = ctx_->global_obj();
+    for (const Instruction* instr = code->begin(),
+         *last = code->end(); instr != last;) {
+      const OP::Type op = GenericOP(instr->GetOP());
+      const uint32_t length = kOPLength[op];
+      Write<uint32_t>(op);
+      for (uint32_t i = 1; i < length; ++i) {
+        Write<uint64_t>(instr[i].u64);
+      }
+      switch (op) {
+        case OP::LOAD_GLOBAL:
+        case OP::STORE_GLOBAL:
+        case OP::DELETE_GLOBAL:
+        case OP::TYPEOF_GLOBAL:
+          // opcode | (dst | index) | map | offset
+          Overwrite<uint64_t>(2, length, 0);
+          Overwrite<uint64_t>(3, length, 0);
+          break;
+        case OP::LOAD_PROP:
+          // opcode | (dst | base | name) | map | offset | nop
+          Overwrite<uint64_t>(2, length, 0);
+          Overwrite<uint64_t>(3, length, 0);
+          Overwrite<uint64_t>(4, length, 0);
+          break;
+        case OP::STORE_PROP:
+          // opcode | (base | src | index) | nop | nop
+          Overwrite<uint64_t>(2, length, 0);
+          Overwrite<uint64_t>(3, length, 0);
+          break;
+        case OP::CALL:
+          // opcode | (callee | offset | argc_with_this) | feedback
+          Overwrite<uint64_t>(2, length, 0);
+          break;
+        case OP::LOAD_GLOBAL_DIRECT:
+        case OP::STORE_GLOBAL_DIRECT: {
+          // opcode | (dst | nop) | slot
+          // slot is recorded as index of variable name in names
+          const uint32_t index = LookupSlotName(global, code, instr[2].slot);
+          if (index == core::kNotFound32) {
+            return false;
+          }
+          Overwrite<uint64_t>(2, length, index);
+          break;
+        }
+        case OP::LOAD_OBJECT: {
+          // opcode | dst | map
+          const Code::Maps::const_iterator it =
+              std::find(code->maps_.begin(), code->maps_.end(), instr[2].map);
+          if (it == code->maps_.end()) {
+            return false;
+          }
+          Overwrite<uint64_t>(2, length, it - code->maps_.begin());
+          break;
+        }
+        default:
+          break;
+      }
+      std::advance(instr, length);
+    }
+    return true;
+  }
+
+  // instructions rewritten by IC are restored to generic ones.
+  // they have the same length
+  static OP::Type GenericOP(OP::Type op) {
+    switch (op) {
+      case OP::LOAD_PROP_GENERIC:
+      case OP::LOAD_PROP_OWN:
+      case OP::LOAD_PROP_PROTO:
+      case OP::LOAD_PROP_CHAIN:
+      case OP::LOAD_PROP_POLY:
+      case OP::LOAD_PROP_MEGAMORPHIC:
+        return OP::LOAD_PROP;
+      case OP::STORE_PROP_GENERIC:
+        return OP::STORE_PROP;
+      default:
+        return op;
+    }
+  }
+
+  static uint32_t LookupSlotName(JSGlobal* global,
+                                 const Code* code, StoredSlot* slot) {
+    uint32_t index = 0;
+    for (Code::Names::const_iterator it = code->names().begin(),
+         last = code->names().end(); it != last; ++it, ++index) {
+      const uint32_t entry = global->LookupVariable(*it);
+      if (entry != core::kNotFound32 && &global->PointAt(entry) == slot) {
+        return index;
+      }
+    }
+    return core::kNotFound32;
+  }
+
+  bool WriteConstant(JSVal value, bool allow_object) {
+    if (value.IsUndefined()) {
+      Write<uint8_t>(CONSTANT_UNDEFINED);
+    } else if (value.IsNull()) {
+      Write<uint8_t>(CONSTANT_NULL);
+    } else if (value.IsBoolean()) {
+      Write<uint8_t>(value.boolean() ? CONSTANT_TRUE : CONSTANT_FALSE);
+    } else if (value.IsEmpty()) {
+      Write<uint8_t>(CONSTANT_EMPTY);
+    } else if (value.IsNumber()) {
+      Write<uint8_t>(CONSTANT_NUMBER);
+      Write<double>(value.number());
+    } else if (value.IsString()) {
+      Write<uint8_t>(CONSTANT_STRING);
+      WriteString(value.string()->GetUTF16());
+    } else if (value.IsObject() && allow_object) {
+      JSObject* obj = value.object();
+      if (obj->IsClass<Class::RegExp>()) {
+        // LOAD_REGEXP
+        JSRegExp* reg = static_cast<JSRegExp*>(obj);
+        std::u16string flags;
+        if (reg->global()) {
+          flags.push_back('g');
+        }
+        if (reg->ignore()) {
+          flags.push_back('i');
+        }
+        if (reg->multiline()) {
+          flags.push_back('m');
+        }
+        if (reg->sticky()) {
+          flags.push_back('y');
+        }
+        Write<uint8_t>(CONSTANT_REGEXP);
+        WriteString(reg->source()->GetUTF16());
+        WriteString(flags);
+      } else if (obj->IsClass<Class::Array>()) {
+        // DUP_ARRAY, array of primitive constants
+        JSArray* ary = static_cast<JSArray*>(obj);
+        const uint32_t length = ary->length();
+        Write<uint8_t>(CONSTANT_ARRAY);
+        Write<uint32_t>(length);
+        for (uint32_t i = 0; i < length; ++i) {
+          Error::Dummy dummy;
+          const JSVal item =
+              ary->Get(ctx_, symbol::MakeSymbolFromIndex(i), &dummy);
+          if (dummy || !WriteConstant(item, false)) {
+            return false;
+          }
+        }
+      } else {
+        return false;
+      }
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // object literal map
+  bool WriteMap(Map* map) {
+    PropertyNamesCollector collector;
+    map->GetOwnPropertyNames(&collector, true);
+    const PropertyNamesCollector::Names& names = collector.names();
+    Write<uint32_t>(names.size());
+    for (PropertyNamesCollector::Names::const_iterator it = names.begin(),
+         last = names.end(); it != last; ++it) {
+      const Symbol name = *it;
+      const Map::Entry entry = map->Get(ctx_, name);
+      if (entry.IsNotFound() || !WriteSymbol(name)) {
+        return false;
+      }
+      Write<uint32_t>(entry.offset);
+      Write<uint8_t>(entry.attributes.IsAccessor());
+    }
+    return true;
+  }
+
+  bool WriteSymbols(const Code::Names& names) {
+    Write<uint32_t>(names.size());
+    for (Code::Names::const_iterator it = names.begin(),
+         last = names.end(); it != last; ++it) {
+      if (!WriteSymbol(*it)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // only symbols which are named by string can be restored by interning
+  bool WriteSymbol(Symbol sym) {
+    if (!symbol::IsIndexSymbol(sym) && !symbol::IsStringSymbol(sym)) {
+      return false;
+    }
+    WriteString(symbol::GetSymbolString(sym));
+    return true;
+  }
+
+  void WriteString(const std::u16string& str) {
+    Write<uint32_t>(str.size());
+    const char* data = reinterpret_cast<const char*>(str.data());
+    buffer_->insert(buffer_->end(), data, data + str.size() * sizeof(char16_t));
+  }
+
+  template<typename T>
+  void Write(T value) {
+    const char* data = reinterpret_cast<const char*>(&value);
+    buffer_->insert(buffer_->end(), data, data + sizeof(T));
+  }
+
+  // overwrite i-th operand of the last written instruction
+  template<typename T>
+  void Overwrite(uint32_t i, uint32_t length, T value) {
+    assert(i < length);
+    const std::size_t offset =
+        buffer_->size() - (length - i) * sizeof(uint64_t);
+    std::memcpy(buffer_->data() + offset, &value, sizeof(T));
+  }
+
+  Context* ctx_;
+  Buffer* buffer_;
+};
+
+class CodeDeserializer : private core::Noncopyable<CodeDeserializer> {
+ public:
+  CodeDeserializer(Context* ctx,
+                   JSScript* script, const char* data, std::size_t size)
+    : ctx_(ctx),
+      script_(script),
+      core_(nullptr),
+      cursor_(data),
+      end_(data + size),
+      failed_(false) {
+  }
+
+  // returns nullptr if data is broken or global declarations can't be
+  // instantiated in the same way as compiled
+  Code* Deserialize() {
+    core_ = CoreData::New();
+    const uint64_t size = Read<uint64_t>();
+    if (failed_ || size > static_cast<uint64_t>(end_ - cursor_)) {
+      return nullptr;
+    }
+    core_->data()->resize(size, Instruction(0u));
+    const uint32_t lines = Read<uint32_t>();
+    for (uint32_t i = 0; i < lines && !failed_; ++i) {
+      const uint64_t offset = Read<uint64_t>();
+      const uint64_t line = Read<uint64_t>();
+      core_->AttachLine(offset, line);
+    }
+
+    Functions functions(ReadCount());
+    for (Functions::iterator it = functions.begin(),
+         last = functions.end(); it != last && !failed_; ++it) {
+      it->first = ReadSymbol();
+      it->second = Read<uint32_t>();
+    }
+    std::vector<Symbol> variables(ReadCount());
+    for (std::vector<Symbol>::iterator it = variables.begin(),
+         last = variables.end(); it != last && !failed_; ++it) {
+      *it = ReadSymbol();
+    }
+    if (failed_) {
+      return nullptr;
+    }
+
+    Code* code = DeserializeCode();
+    if (!code || code->code_type() != Code::GLOBAL || cursor_ != end_) {
+      return nullptr;
+    }
+    Codes heaps;
+    if (!VerifyCode(code, &heaps)) {
+      return nullptr;
+    }
+    for (Functions::const_iterator it = functions.begin(),
+         last = functions.end(); it != last; ++it) {
+      if (it->second >= code->codes().size()) {
+        return nullptr;
+      }
+    }
+
+    // everything is checked before global object is changed,
+    // so rejected file never leaves global declarations
+    Symbols declared;
+    if (!CheckGlobalDeclarations(functions, variables, &declared) ||
+        !CheckGlobalSlots(code, declared)) {
+      return nullptr;
+    }
+
+    // global declaration instantiation, same as Compiler::GlobalInstantiation
+    for (Functions::const_iterator it = functions.begin(),
+         last = functions.end(); it != last; ++it) {
+      JSFunction* func =
+          ctx_->NewFunction(code->codes()[it->second], ctx_->global_env());
+      const bool instantiated =
+          Compiler::InstantiateGlobalFunction(ctx_, it->first, func);
+      assert(instantiated);
+      static_cast<void>(instantiated);
+    }
+    for (std::vector<Symbol>::const_iterator it = variables.begin(),
+         last = variables.end(); it != last; ++it) {
+      Compiler::InstantiateGlobalVariable(ctx_, *it);
+    }
+
+    ResolveGlobalSlots(code);
+    core_->SetCompiled();
+    return code;
+  }
+
+ private:
+  Code* DeserializeCode() {
+    const uint32_t type = Read<uint32_t>();
+    if (type > Code::EVAL) {
+      failed_ = true;
+      return nullptr;
+    }
+    Code* code =
+        new Code(script_, core_, static_cast<Code::CodeType>(type));
+    code->strict_ = Read<uint8_t>();
+    code->empty_ = Read<uint8_t>();
+    code->has_name_ = Read<uint8_t>();
+    code->needs_declarative_environment_ = Read<uint8_t>();
+    code->this_materialized_ = Read<uint8_t>();
+    code->heap_size_ = Read<uint32_t>();
+    code->stack_size_ = Read<uint32_t>();
+    code->temporary_registers_ = Read<uint32_t>();
+    code->frame_size_ = Read<uint32_t>();
+    if (code->has_name_) {
+      code->name_ = ReadSymbol();
+    }
+    code->block_begin_position_ = Read<uint64_t>();
+    code->block_end_position_ = Read<uint64_t>();
+    ReadSymbols(&code->names_);
+    ReadSymbols(&code->params_);
+
+    const uint32_t constants = Read<uint32_t>();
+    for (uint32_t i = 0; i < constants && !failed_; ++i) {
+      code->constants_.push_back(ReadConstant(true));
+    }
+
+    const uint32_t maps = Read<uint32_t>();
+    for (uint32_t i = 0; i < maps && !failed_; ++i) {
+      code->RegisterMap(ReadMap());
+    }
+
+    const uint32_t handlers = Read<uint32_t>();
+    for (uint32_t i = 0; i < handlers && !failed_; ++i) {
+      const uint32_t handler_type = Read<uint32_t>();
+      const int16_t jmp = Read<int16_t>();
+      const int16_t ret = Read<int16_t>();
+      const int16_t flag = Read<int16_t>();
+      const uint32_t begin = Read<uint32_t>();
+      const uint32_t end = Read<uint32_t>();
+      code->RegisterHandler(
+          Handler(static_cast<Handler::Type>(handler_type),
+                  begin, end, jmp, ret, flag));
+    }
+
+    if (failed_ || !ReadInstructions(code)) {
+      return nullptr;
+    }
+
+    const uint32_t codes = Read<uint32_t>();
+    for (uint32_t i = 0; i < codes; ++i) {
+      Code* sub = DeserializeCode();
+      if (!sub) {
+        return nullptr;
+      }
+      code->codes_.push_back(sub);
+    }
+    return (failed_) ? nullptr : code;
+  }
+
+  bool ReadInstructions(Code* code) {
+    const uint64_t start = Read<uint64_t>();
+    const uint64_t end = Read<uint64_t>();
+    if (failed_ || start > end || end > core_->data()->size()) {
+      return false;
+    }
+    code->set_start(start);
+    code->set_end(end);
+    for (Instruction* instr = code->begin(),
+         *last = code->end(); instr != last;) {
+      const uint32_t op = Read<uint32_t>();
+      if (failed_ || op >= OP::NUM_OF_OP) {
+        return false;
+      }
+      const uint32_t length = kOPLength[op];
+      if (static_cast<std::size_t>(last - instr) < length) {
+        return false;
+      }
+      instr[0] = Instruction::GetOPInstruction(static_cast<OP::Type>(op));
+      for (uint32_t i = 1; i < length; ++i) {
+        instr[i].u64 = Read<uint64_t>();
+      }
+      if (op == OP::LOAD_OBJECT) {
+        // opcode | dst | map
+        const uint64_t index = instr[2].u64;
+        if (index >= code->maps_.size()) {
+          return false;
+        }
+        instr[2].map = code->maps_[index];
+      }
+      std::advance(instr, length);
+    }
+    return !failed_;
+  }
+
+  typedef std::vector<std::pair<Symbol, uint32_t> > Functions;
+  typedef std::unordered_set<Symbol> Symbols;
+  typedef std::vector<const Code*> Codes;
+
+  // operands are verified against the frame and the tables of code, so
+  // broken file never makes VM index out of the frame, constants, names,
+  // codes or instructions. kinds of values in registers are not tracked,
+  // file corruption is detected by checksum before this.
+  // heaps is the chain of enclosing codes which have declarative
+  // environment, referenced by heap opcodes
+  bool VerifyCode(const Code* code, Codes* heaps) const {
+    if (code->FrameSize() < code->registers() ||
+        code->FrameSize() >= static_cast<uint32_t>(
+            FrameConstant<>::kConstantOffset) ||
+        (code->heap_size() && !code->needs_declarative_environment())) {
+      return false;
+    }
+    if (code->needs_declarative_environment()) {
+      heaps->push_back(code);
+    }
+    const bool result = VerifyInstructions(code, *heaps) &&
+                        VerifyCodes(code, heaps);
+    if (code->needs_declarative_environment()) {
+      heaps->pop_back();
+    }
+    return result;
+  }
+
+  bool VerifyCodes(const Code* code, Codes* heaps) const {
+    for (Code::Codes::const_iterator it = code->codes().begin(),
+         last = code->codes().end(); it != last; ++it) {
+      if ((*it)->code_type() != Code::FUNCTION || !VerifyCode(*it, heaps)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // catch and finally handlers jump to the end of range
+  bool VerifyHandlers(const Code* code, const std::vector<bool>& heads) const {
+    const ExceptionTable& table = code->exception_table();
+    for (ExceptionTable::const_iterator it = table.begin(),
+         last = table.end(); it != last; ++it) {
+      if (it->begin() > it->end() || it->end() > heads.size()) {
+        return false;
+      }
+      switch (it->type()) {
+        case Handler::CATCH:
+          if (!IsValidRegister(code, it->ret()) ||
+              !IsValidJump(heads, it->end(), 0)) {
+            return false;
+          }
+          break;
+        case Handler::FINALLY:
+          if (!IsValidRegister(code, it->jmp()) ||
+              !IsValidRegister(code, it->flag()) ||
+              !IsValidJump(heads, it->end(), 0)) {
+            return false;
+          }
+          break;
+        case Handler::ITERATOR:
+          if (!IsValidRegister(code, it->ret())) {
+            return false;
+          }
+          break;
+        case Handler::ENV:
+          break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  bool VerifyInstructions(const Code* code, const Codes& heaps) const {
+    const Instruction* begin = code->begin();
+    const uint32_t length = code->end() - begin;
+
+    // jump targets are restricted to the head of instructions
+    std::vector<bool> heads(length, false);
+    uint32_t array_size = 0;
+    std::size_t slots = 0;
+    for (uint32_t index = 0; index < length;
+         index += kOPLength[begin[index].GetOP()]) {
+      heads[index] = true;
+      if (begin[index].GetOP() == OP::LOAD_ARRAY) {
+        array_size = std::max(array_size, begin[index + 1].ssw.u32);
+      }
+    }
+    for (Code::Maps::const_iterator it = code->maps_.begin(),
+         last = code->maps_.end(); it != last; ++it) {
+      slots = std::max(slots, (*it)->GetSlotsSize());
+    }
+
+    for (uint32_t index = 0; index < length;) {
+      const Instruction* instr = begin + index;
+      const OP::Type op = instr->GetOP();
+      const uint32_t next = index + kOPLength[op];
+      bool valid = true;
+      switch (op) {
+        case OP::NOP:
+        case OP::ENTER:
+        case OP::POP_ENV:
+        case OP::DEBUGGER:
+          break;
+
+        case OP::MV:
+        case OP::UNARY_POSITIVE:
+        case OP::UNARY_NEGATIVE:
+        case OP::UNARY_NOT:
+        case OP::UNARY_BIT_NOT:
+        case OP::TYPEOF:
+        case OP::POSTFIX_INCREMENT:
+        case OP::POSTFIX_DECREMENT:
+        case OP::RETURN_SUBROUTINE:
+          // opcode | (dst | src)
+          valid = IsValidRegister(code, instr[1].i16[0]) &&
+                  IsValidRegister(code, instr[1].i16[1]);
+          break;
+
+        case OP::MV_RETURN:
+          // superinstruction of MV and RETURN
+          valid = IsValidRegister(code, instr[1].i16[0]) &&
+                  IsValidRegister(code, instr[1].i16[1]) &&
+                  IsFollowedBy(begin, next, length, OP::RETURN);
+          break;
+
+        case OP::BINARY_ADD:
+        case OP::BINARY_SUBTRACT:
+        case OP::BINARY_MULTIPLY:
+        case OP::BINARY_DIVIDE:
+        case OP::BINARY_MODULO:
+        case OP::BINARY_LSHIFT:
+        case OP::BINARY_RSHIFT:
+        case OP::BINARY_RSHIFT_LOGICAL:
+        case OP::BINARY_LT:
+        case OP::BINARY_LTE:
+        case OP::BINARY_GT:
+        case OP::BINARY_GTE:
+        case OP::BINARY_INSTANCEOF:
+        case OP::BINARY_IN:
+        case OP::BINARY_EQ:
+        case OP::BINARY_STRICT_EQ:
+        case OP::BINARY_NE:
+        case OP::BINARY_STRICT_NE:
+        case OP::BINARY_BIT_AND:
+        case OP::BINARY_BIT_XOR:
+        case OP::BINARY_BIT_OR:
+        case OP::LOAD_ELEMENT:
+        case OP::STORE_ELEMENT:
+        case OP::DELETE_ELEMENT:
+        case OP::INCREMENT_ELEMENT:
+        case OP::DECREMENT_ELEMENT:
+        case OP::POSTFIX_INCREMENT_ELEMENT:
+        case OP::POSTFIX_DECREMENT_ELEMENT:
+          // opcode | (dst | lhs | rhs)
+          valid = IsValidRegister(code, instr[1].i16[0]) &&
+                  IsValidRegister(code, instr[1].i16[1]) &&
+                  IsValidRegister(code, instr[1].i16[2]);
+          break;
+
+        case OP::BINARY_ADD_RETURN:
+          // superinstruction of BINARY_ADD and RETURN
+          valid = IsValidRegister(code, instr[1].i16[0]) &&
+                  IsValidRegister(code, instr[1].i16[1]) &&
+                  IsValidRegister(code, instr[1].i16[2]) &&
+                  IsFollowedBy(begin, next, length, OP::RETURN);
+          break;
+
+        case OP::RETURN:
+        case OP::THROW:
+        case OP::RESULT:
+        case OP::TO_NUMBER:
+        case OP::TO_PRIMITIVE_AND_TO_STRING:
+        case OP::WITH_SETUP:
+        case OP::INCREMENT:
+        case OP::DECREMENT:
+        case OP::FORIN_LEAVE:
+        case OP::LOAD_ARGUMENTS:
+        case OP::LOAD_OBJECT:
+        case OP::LOAD_GLOBAL_DIRECT:
+        case OP::STORE_GLOBAL_DIRECT:
+          // opcode | src
+          // map of LOAD_OBJECT is verified when reading,
+          // and slot of *_GLOBAL_DIRECT is verified when resolving
+          valid = IsValidRegister(code, instr[1].i32[0]);
+          break;
+
+        case OP::BUILD_ENV:
+          // opcode | (size | mutable_start)
+          valid = code->needs_declarative_environment() &&
+                  instr[1].u32[0] == code->heap_size() &&
+                  instr[1].u32[0] <= code->names().size() &&
+                  instr[1].u32[1] <= instr[1].u32[0];
+          break;
+
+        case OP::RAISE: {
+          // opcode | (code | message)
+          const uint32_t constant = instr[1].u32[1];
+          valid = instr[1].u32[0] < Error::NUM_OF_CODE &&
+                  constant < code->constants().size() &&
+                  code->constants()[constant].IsString();
+          break;
+        }
+
+        case OP::INSTANTIATE_DECLARATION_BINDING:
+        case OP::INSTANTIATE_VARIABLE_BINDING:
+          // opcode | (name | configurable)
+          valid = instr[1].u32[0] < code->names().size();
+          break;
+
+        case OP::LOAD_CONST:
+          // opcode | (dst | offset)
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  instr[1].ssw.u32 < code->constants().size();
+          break;
+
+        case OP::LOAD_CONST_BINARY_ADD:
+        case OP::LOAD_CONST_BINARY_SUBTRACT:
+        case OP::LOAD_CONST_IF_FALSE_BINARY_LT: {
+          // superinstruction of LOAD_CONST and the next opcode
+          const OP::Type second =
+              (op == OP::LOAD_CONST_BINARY_ADD) ? OP::BINARY_ADD :
+              (op == OP::LOAD_CONST_BINARY_SUBTRACT) ? OP::BINARY_SUBTRACT :
+              OP::IF_FALSE_BINARY_LT;
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  instr[1].ssw.u32 < code->constants().size() &&
+                  IsFollowedBy(begin, next, length, second);
+          break;
+        }
+
+        case OP::LOAD_REGEXP:
+        case OP::DUP_ARRAY: {
+          // opcode | (dst | offset)
+          const uint32_t constant = instr[1].ssw.u32;
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  constant < code->constants().size() &&
+                  code->constants()[constant].IsObject() &&
+                  ((op == OP::LOAD_REGEXP) ?
+                   code->constants()[constant].object()->IsClass<Class::RegExp>() :
+                   code->constants()[constant].object()->IsClass<Class::Array>());
+          break;
+        }
+
+        case OP::LOAD_FUNCTION:
+          // opcode | (dst | code)
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  instr[1].ssw.u32 < code->codes().size();
+          break;
+
+        case OP::LOAD_ARRAY:
+          // opcode | (dst | size)
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]);
+          break;
+
+        case OP::TRY_CATCH_SETUP:
+        case OP::LOAD_NAME:
+        case OP::STORE_NAME:
+        case OP::DELETE_NAME:
+        case OP::INCREMENT_NAME:
+        case OP::DECREMENT_NAME:
+        case OP::POSTFIX_INCREMENT_NAME:
+        case OP::POSTFIX_DECREMENT_NAME:
+        case OP::TYPEOF_NAME:
+        case OP::LOAD_GLOBAL:
+        case OP::STORE_GLOBAL:
+        case OP::DELETE_GLOBAL:
+        case OP::TYPEOF_GLOBAL:
+          // opcode | (dst | name)
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  instr[1].ssw.u32 < code->names().size();
+          break;
+
+        case OP::INITIALIZE_HEAP_IMMUTABLE:
+          // opcode | (src | offset)
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  code->needs_declarative_environment() &&
+                  instr[1].ssw.u32 < code->heap_size();
+          break;
+
+        case OP::LOAD_HEAP:
+        case OP::STORE_HEAP:
+        case OP::DELETE_HEAP:
+        case OP::INCREMENT_HEAP:
+        case OP::DECREMENT_HEAP:
+        case OP::POSTFIX_INCREMENT_HEAP:
+        case OP::POSTFIX_DECREMENT_HEAP:
+        case OP::TYPEOF_HEAP: {
+          // opcode | (dst | imm | name) | (offset | nest)
+          const uint32_t offset = instr[2].u32[0];
+          const uint32_t nest = instr[2].u32[1];
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  instr[1].ssw.u32 < code->names().size() &&
+                  nest < heaps.size() &&
+                  offset < heaps[heaps.size() - 1 - nest]->heap_size();
+          break;
+        }
+
+        case OP::STORE_OBJECT_DATA:
+        case OP::STORE_OBJECT_GET:
+        case OP::STORE_OBJECT_SET:
+          // opcode | (obj | item) | (offset | merged)
+          valid = IsValidRegister(code, instr[1].i16[0]) &&
+                  IsValidRegister(code, instr[1].i16[1]) &&
+                  instr[2].u32[0] < slots;
+          break;
+
+        case OP::STORE_OBJECT_INDEXED:
+          // opcode | (obj | item) | (index | type)
+          valid = IsValidRegister(code, instr[1].i16[0]) &&
+                  IsValidRegister(code, instr[1].i16[1]) &&
+                  (instr[2].u32[1] == ObjectLiteral::DATA ||
+                   instr[2].u32[1] == ObjectLiteral::GET ||
+                   instr[2].u32[1] == ObjectLiteral::SET);
+          break;
+
+        case OP::INIT_VECTOR_ARRAY_ELEMENT:
+        case OP::INIT_SPARSE_ARRAY_ELEMENT: {
+          // opcode | (ary | reg) | (index | size)
+          const uint64_t index = instr[2].u32[0];
+          const uint32_t size = instr[2].u32[1];
+          valid = IsValidRegister(code, instr[1].i16[0]) &&
+                  IsValidRange(code, instr[1].i16[1], size) &&
+                  ((op == OP::INIT_VECTOR_ARRAY_ELEMENT) ?
+                   index + size <= std::min<uint32_t>(
+                       array_size, IndexedElements::kMaxVectorSize) :
+                   index >= IndexedElements::kMaxVectorSize);
+          break;
+        }
+
+        case OP::CALL:
+        case OP::CONSTRUCT:
+        case OP::EVAL:
+          // opcode | (callee | offset | argc_with_this)
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  instr[1].ssw.u32 >= 1 &&
+                  IsValidRange(code, instr[1].ssw.i16[1], instr[1].ssw.u32);
+          break;
+
+        case OP::CONCAT:
+          // opcode | (dst | start | count)
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  instr[1].ssw.u32 >= 1 &&
+                  IsValidRange(code, instr[1].ssw.i16[1], instr[1].ssw.u32);
+          break;
+
+        case OP::PREPARE_DYNAMIC_CALL:
+        case OP::LOAD_PROP:
+        case OP::STORE_PROP:
+        case OP::DELETE_PROP:
+        case OP::INCREMENT_PROP:
+        case OP::DECREMENT_PROP:
+        case OP::POSTFIX_INCREMENT_PROP:
+        case OP::POSTFIX_DECREMENT_PROP:
+          // opcode | (dst | base | name)
+          valid = IsValidRegister(code, instr[1].ssw.i16[0]) &&
+                  IsValidRegister(code, instr[1].ssw.i16[1]) &&
+                  instr[1].ssw.u32 < code->names().size();
+          break;
+
+        case OP::JUMP_BY:
+          // opcode | jmp
+          valid = IsValidJump(heads, index, instr[1].jump.to);
+          break;
+
+        case OP::IF_FALSE:
+        case OP::IF_TRUE:
+          // opcode | (jmp : cond)
+          valid = IsValidRegister(code, instr[1].jump.i16[0]) &&
+                  IsValidJump(heads, index, instr[1].jump.to);
+          break;
+
+        case OP::JUMP_SUBROUTINE:
+        case OP::IF_FALSE_BINARY_LT:
+        case OP::IF_TRUE_BINARY_LT:
+        case OP::IF_FALSE_BINARY_LTE:
+        case OP::IF_TRUE_BINARY_LTE:
+        case OP::IF_FALSE_BINARY_GT:
+        case OP::IF_TRUE_BINARY_GT:
+        case OP::IF_FALSE_BINARY_GTE:
+        case OP::IF_TRUE_BINARY_GTE:
+        case OP::IF_FALSE_BINARY_INSTANCEOF:
+        case OP::IF_TRUE_BINARY_INSTANCEOF:
+        case OP::IF_FALSE_BINARY_IN:
+        case OP::IF_TRUE_BINARY_IN:
+        case OP::IF_FALSE_BINARY_EQ:
+        case OP::IF_TRUE_BINARY_EQ:
+        case OP::IF_FALSE_BINARY_NE:
+        case OP::IF_TRUE_BINARY_NE:
+        case OP::IF_FALSE_BINARY_STRICT_EQ:
+        case OP::IF_TRUE_BINARY_STRICT_EQ:
+        case OP::IF_FALSE_BINARY_STRICT_NE:
+        case OP::IF_TRUE_BINARY_STRICT_NE:
+        case OP::IF_FALSE_BINARY_BIT_AND:
+        case OP::IF_TRUE_BINARY_BIT_AND:
+        case OP::FORIN_SETUP:
+        case OP::FORIN_ENUMERATE:
+          // opcode | (jmp : lhs | rhs)
+          valid = IsValidRegister(code, instr[1].jump.i16[0]) &&
+                  IsValidRegister(code, instr[1].jump.i16[1]) &&
+                  IsValidJump(heads, index, instr[1].jump.to);
+          break;
+
+        default:
+          // opcodes rewritten by IC are never serialized
+          valid = false;
+          break;
+      }
+      if (!valid) {
+        return false;
+      }
+      index = next;
+    }
+    return VerifyHandlers(code, heads);
+  }
+
+  static bool IsValidRegister(const Code* code, int32_t reg) {
+    if (reg >= FrameConstant<>::kConstantOffset) {
+      return static_cast<uint32_t>(reg - FrameConstant<>::kConstantOffset) <
+          code->constants().size();
+    }
+    if (reg >= 0) {
+      return static_cast<uint32_t>(reg) < code->FrameSize();
+    }
+    if (reg == FrameConstant<>::kThisOffset ||
+        reg == FrameConstant<>::kCalleeOffset) {
+      return true;
+    }
+    return reg < FrameConstant<>::kThisOffset &&
+        static_cast<uint32_t>(FrameConstant<>::ConvertRegisterToArg(reg)) <
+        code->params().size();
+  }
+
+  // registers [reg, reg + size) are in the frame
+  static bool IsValidRange(const Code* code, int32_t reg, uint32_t size) {
+    const int64_t last = static_cast<int64_t>(reg) + size;
+    return size == 0 ||
+        (reg >= 0 && last <= static_cast<int64_t>(code->FrameSize()));
+  }
+
+  static bool IsValidJump(const std::vector<bool>& heads,
+                          uint32_t index, int32_t jump) {
+    const int64_t to = static_cast<int64_t>(index) + jump;
+    return to >= 0 && to < static_cast<int64_t>(heads.size()) && heads[to];
+  }
+
+  // next opcode executed inline by superinstruction may be fused with
+  // its own next opcode, like LOAD_CONST_BINARY_ADD and BINARY_ADD_RETURN
+  static bool IsFollowedBy(const Instruction* begin,
+                           uint32_t next, uint32_t length, OP::Type op) {
+    if (next >= length) {
+      return false;
+    }
+    const OP::Type actual = begin[next].GetOP();
+    return actual == op ||
+        (op == OP::BINARY_ADD && actual == OP::BINARY_ADD_RETURN);
+  }
+
+  // same conditions as Compiler::InstantiateGlobalFunction and
+  // Compiler::InstantiateGlobalVariable, but global object is not changed.
+  // names which will be new global variables are collected to declared
+  bool CheckGlobalDeclarations(const Functions& functions,
+                               const std::vector<Symbol>& variables,
+                               Symbols* declared) const {
+    JSGlobal* global = ctx_->global_obj();
+    for (Functions::const_iterator it = functions.begin(),
+         last = functions.end(); it != last; ++it) {
+      const Symbol name = it->first;
+      if (declared->count(name)) {
+        continue;
+      }
+      const uint32_t entry = global->LookupVariable(name);
+      if (entry != core::kNotFound32) {
+        const StoredSlot& slot(global->PointAt(entry));
+        if (!slot.attributes().IsWritable() ||
+            !slot.attributes().IsEnumerable()) {
+          return false;
+        }
+        continue;
+      }
+      Slot slot;
+      if (global->GetPropertySlot(ctx_, name, &slot) &&
+          !slot.attributes().IsConfigurable()) {
+        if (slot.attributes().IsAccessor() ||
+            !slot.attributes().IsWritable() ||
+            !slot.attributes().IsEnumerable()) {
+          return false;
+        }
+        // ignored
+        continue;
+      }
+      declared->insert(name);
+    }
+    for (std::vector<Symbol>::const_iterator it = variables.begin(),
+         last = variables.end(); it != last; ++it) {
+      if (!declared->count(*it) &&
+          global->LookupVariable(*it) == core::kNotFound32 &&
+          !global->HasProperty(ctx_, *it)) {
+        declared->insert(*it);
+      }
+    }
+    return true;
+  }
+
+  // global variable slots point existing variables or variables
+  // declared by this code
+  bool CheckGlobalSlots(const Code* code, const Symbols& declared) const {
+    JSGlobal* global = ctx_->global_obj();
+    for (const Instruction* instr = code->begin(),
+         *last = code->end(); instr != last;) {
+      const OP::Type op = instr->GetOP();
+      if (op == OP::LOAD_GLOBAL_DIRECT || op == OP::STORE_GLOBAL_DIRECT) {
+        // opcode | (dst | nop) | slot
+        const uint64_t index = instr[2].u64;
+        if (index >= code->names().size()) {
+          return false;
+        }
+        const Symbol name = code->names()[index];
+        if (!declared.count(name) &&
+            global->LookupVariable(name) == core::kNotFound32) {
+          return false;
+        }
+      }
+      std::advance(instr, kOPLength[op]);
+    }
+    for (Code::Codes::const_iterator it = code->codes().begin(),
+         last = code->codes().end(); it != last; ++it) {
+      if (!CheckGlobalSlots(*it, declared)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // global variable slots are resolved after global declarations are
+  // instantiated, because they may point variables of this code
+  void ResolveGlobalSlots(Code* code) {
+    JSGlobal* global = ctx_->global_obj();
+    for (Instruction* instr = code->begin(),
+         *last = code->end(); instr != last;) {
+      const OP::Type op = instr->GetOP();
+      if (op == OP::LOAD_GLOBAL_DIRECT || op == OP::STORE_GLOBAL_DIRECT) {
+        // opcode | (dst | nop) | slot
+        const uint32_t entry =
+            global->LookupVariable(code->names()[instr[2].u64]);
+        assert(entry != core::kNotFound32);
+        instr[2].slot = &global->PointAt(entry);
+      }
+      std::advance(instr, kOPLength[op]);
+    }
+    for (Code::Codes::const_iterator it = code->codes().begin(),
+         last = code->codes().end(); it != last; ++it) {
+      ResolveGlobalSlots(*it);
+    }
+  }
+
+  JSVal ReadConstant(bool allow_object) {
+    switch (Read<uint8_t>()) {
+      case CodeSerializer::CONSTANT_UNDEFINED:
+        return JSUndefined;
+      case CodeSerializer::CONSTANT_NULL:
+        return JSNull;
+      case CodeSerializer::CONSTANT_TRUE:
+        return JSTrue;
+      case CodeSerializer::CONSTANT_FALSE:
+        return JSFalse;
+      case CodeSerializer::CONSTANT_EMPTY:
+        return JSEmpty;
+      case CodeSerializer::CONSTANT_NUMBER:
+        return JSVal(Read<double>());
+      case CodeSerializer::CONSTANT_STRING:
+        return ReadJSString();
+      case CodeSerializer::CONSTANT_REGEXP: {
+        if (!allow_object) {
+          break;
+        }
+        JSString* source = ReadJSString();
+        JSString* flags = ReadJSString();
+        if (failed_) {
+          break;
+        }
+        Error::Standard e;
+        JSRegExp* reg = JSRegExp::New(ctx_, source, flags, &e);
+        if (e) {
+          break;
+        }
+        return reg;
+      }
+      case CodeSerializer::CONSTANT_ARRAY: {
+        if (!allow_object) {
+          break;
+        }
+        const uint32_t length = Read<uint32_t>();
+        JSVector* vector = JSVector::New(ctx_);
+        for (uint32_t i = 0; i < length && !failed_; ++i) {
+          vector->push_back(ReadConstant(false));
+        }
+        return vector->ToJSArray();
+      }
+    }
+    failed_ = true;
+    return JSUndefined;
+  }
+
+  // offsets of map are permutation of slots,
+  // so stores to object literal never exceed allocated slots
+  Map* ReadMap() {
+    MapBuilder builder(ctx_, ctx_->global_data()->object_prototype());
+    const uint32_t size = ReadCount();
+    std::vector<bool> used(size, false);
+    for (uint32_t i = 0; i < size && !failed_; ++i) {
+      const Symbol name = ReadSymbol();
+      const uint32_t offset = Read<uint32_t>();
+      const bool accessor = Read<uint8_t>();
+      if (failed_ || !builder.Find(name).IsNotFound() ||
+          offset >= size || used[offset]) {
+        failed_ = true;
+        break;
+      }
+      used[offset] = true;
+      builder.Add(name, offset,
+                  accessor ? ATTR::Object::Accessor() : ATTR::Object::Data());
+    }
+    return builder.Build();
+  }
+
+  void ReadSymbols(Code::Names* names) {
+    const uint32_t size = Read<uint32_t>();
+    for (uint32_t i = 0; i < size && !failed_; ++i) {
+      names->push_back(ReadSymbol());
+    }
+  }
+
+  Symbol ReadSymbol() {
+    const std::u16string str = ReadString();
+    return ctx_->Intern(core::u16string_view(str));
+  }
+
+  JSString* ReadJSString() {
+    const std::u16string str = ReadString();
+    Error::Dummy dummy;
+    return JSString::New(
+        ctx_, str.begin(), str.end(),
+        core::character::IsASCII(str.begin(), str.end()), &dummy);
+  }
+
+  std::u16string ReadString() {
+    const uint32_t size = Read<uint32_t>();
+    const std::size_t bytes = size * sizeof(char16_t);
+    if (failed_ || bytes > static_cast<std::size_t>(end_ - cursor_)) {
+      failed_ = true;
+      return std::u16string();
+    }
+    std::u16string str(size, 0);
+    std::memcpy(&str[0], cursor_, bytes);
+    cursor_ += bytes;
+    return str;
+  }
+
+  // count of entries, each of them has at least 1 byte
+  uint32_t ReadCount() {
+    const uint32_t count = Read<uint32_t>();
+    if (count > static_cast<std::size_t>(end_ - cursor_)) {
+      failed_ = true;
+      return 0;
+    }
+    return count;
+  }
+
+  template<typename T>
+  T Read() {
+    T value = T();
+    if (failed_ || sizeof(T) > static_cast<std::size_t>(end_ - cursor_)) {
+      failed_ = true;
+      return value;
+    }
+    std::memcpy(&value, cursor_, sizeof(T));
+    cursor_ += sizeof(T);
+    return value;
+  }
+
+  Context* ctx_;
+  JSScript* script_;
+  CoreData* core_;
+  const char* cursor_;
+  const char* end_;
+  bool failed_;
+};
+
+// cache of compiled global code in directory.
+// each file is named by hash of source and compile options.
+// file layout is header | source | serialized code, and checksum of
+// source and serialized code is recorded in header
+class CodeCache : private core::Noncopyable<CodeCache> {
+ public:
+  static const uint32_t kMagic = 0x6335766C;  // "lv5c"
+  static const uint32_t kVersion = 3;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t instruction_size;
+    uint32_t opcodes;
+    uint32_t options;
+    uint32_t reserved;
+    uint64_t source_size;
+    uint64_t source_hash;
+    uint64_t checksum;
+  };
+
+  CodeCache(Context* ctx, bool use_folded_registers)
+    : ctx_(ctx),
+      options_((use_folded_registers ? 1 : 0) |
+               (ctx->IsSuperinstructionEnabled() ? 2 : 0)) {
+  }
+
+  bool IsEnabled() const { return !ctx_->code_cache_directory().empty(); }
+
+  // 64bit FNV-1a of bytes
+  static uint64_t Checksum(const char* data, std::size_t size) {
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (const char* last = data + size; data != last; ++data) {
+      hash ^= static_cast<uint8_t>(*data);
+      hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+  }
+
+  Code* Load(const core::FileSource& src, JSScript* script) const {
+    if (!IsEnabled()) {
+      return nullptr;
+    }
+    const Header expected = CreateHeader(src);
+    core::io::MappedFile file;
+    if (!file.Open(GetFileName(expected), false)) {
+      return nullptr;
+    }
+    const core::u16string_view source = src.GetData();
+    const std::size_t source_bytes = source.size() * sizeof(char16_t);
+    const std::size_t offset = sizeof(Header) + source_bytes;
+    if (file.size() < offset ||
+        std::memcmp(file.data(), &expected, offsetof(Header, checksum)) != 0 ||
+        std::memcmp(file.data() + sizeof(Header),
+                    source.data(), source_bytes) != 0) {
+      return nullptr;
+    }
+    const Header* header = reinterpret_cast<const Header*>(file.data());
+    if (header->checksum !=
+        Checksum(file.data() + sizeof(Header), file.size() - sizeof(Header))) {
+      return nullptr;
+    }
+    CodeDeserializer deserializer(ctx_, script,
+                                  file.data() + offset,
+                                  file.size() - offset);
+    return deserializer.Deserialize();
+  }
+
+  std::string GetFileName(const core::FileSource& src) const {
+    return GetFileName(CreateHeader(src));
+  }
+
+  // returns false if code is not stored
+  bool Store(const core::FileSource& src,
+             const FunctionLiteral& global, Code* code) const {
+    if (!IsEnabled()) {
+      return false;
+    }
+    const Header header = CreateHeader(src);
+    CodeSerializer::Buffer buffer;
+    const char* data = reinterpret_cast<const char*>(&header);
+    buffer.insert(buffer.end(), data, data + sizeof(Header));
+    const core::u16string_view source = src.GetData();
+    const char* source_data = reinterpret_cast<const char*>(source.data());
+    buffer.insert(buffer.end(),
+                  source_data,
+                  source_data + source.size() * sizeof(char16_t));
+    CodeSerializer serializer(ctx_, &buffer);
+    if (!serializer.Serialize(global, code)) {
+      return false;
+    }
+    const uint64_t checksum =
+        Checksum(buffer.data() + sizeof(Header), buffer.size() - sizeof(Header));
+    std::memcpy(buffer.data() + offsetof(Header, checksum),
+                &checksum, sizeof(uint64_t));
+    // write to temporary file and rename it,
+    // so partially written file is never loaded
+    const std::string filename = GetFileName(header);
+    const std::string temporary = filename + ".tmp";
+    std::FILE* fp = core::io::OpenFile(temporary, "wb");
+    if (!fp) {
+      return false;
+    }
+    const bool written =
+        std::fwrite(buffer.data(), buffer.size(), 1, fp) == 1;
+    std::fclose(fp);
+    if (!written || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+      std::remove(temporary.c_str());
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  Header CreateHeader(const core::FileSource& src) const {
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.instruction_size = sizeof(Instruction);
+    header.opcodes = OP::NUM_OF_OP;
+    header.options = options_;
+    header.source_size = src.size();
+    header.source_hash = core::FNVHash::StringToHash(src.GetData());
+    return header;
+  }
+
+  std::string GetFileName(const Header& header) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "/%016llx-%x.lv5c",
+                  static_cast<unsigned long long>(header.source_hash),  // NOLINT
+                  header.options);
+    return ctx_->code_cache_directory() + name;
+  }
+
+  Context* ctx_;
+  uint32_t options_;
+};
+
+} } }  // namespace iv::lv5::railgun
+#endif  // IV_LV5_RAILGUN_CODE_CACHE_H_
@@ -71,6 +71,9 @@ inline JSVal Dis(const Arguments& args, Error* e) {
         JSFunction* func = static_cast<JSFunction*>(obj);
         if (func->function_type() == JSFunction::FUNCTION_USER) {
           JSVMFunction* vm_func = static_cast<JSVMFunction*>(func);
+          if (vm_func->code()->lazy()) {
+            CompileLazyCode(static_cast<Context*>(args.ctx()), vm_func->code());
+          }
           OutputDisAssembler dis(static_cast<Context*>(args.ctx()), stdout);
           dis.DisAssemble(*vm_func->code(), false);
           return JSTrue;
@@ -7,11 +7,14 @@
 #include <iv/detail/memory.h>
 #include <iv/utils.h>
 #include <iv/ast_visitor.h>
+#include <iv/parser.h>
+#include <iv/file_source.h>
 #include <iv/noncopyable.h>
 #include <iv/conversions.h>
 #include <iv/unicode.h>
 #include <iv/utils.h>
 #include <iv/lv5/specialized_ast.h>
+#include <iv/lv5/factory.h>
 #include <iv/lv5/jsval.h>
 #include <iv/lv5/jsstring.h>
 #include <iv/lv5/jsregexp.h>
@@ -32,6 +35,7 @@
 #include <iv/lv5/railgun/constant_pool.h>
 #include <iv/lv5/railgun/direct_threading.h>
 #include <iv/lv5/railgun/jsfunction.h>
+#include <iv/lv5/railgun/lazy_code.h>
 namespace iv {
 namespace lv5 {
 namespace railgun {
@@ -136,6 +140,7 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
       core_(nullptr),
       data_(nullptr),
       script_(nullptr),
+      lazy_source_(),
       code_info_stack_(),
       jump_table_(),
       level_stack_(),
@@ -155,10 +160,16 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
   // entry points
 
   // Global Code
-  Code* CompileGlobal(const FunctionLiteral& global, JSScript* script) {
+  // if source is given, functions in global code are reparsed from it
+  // and compiled when they are called first time
+  Code* CompileGlobal(const FunctionLiteral& global,
+                      JSScript* script,
+                      std::shared_ptr<core::FileSource> lazy_source =
+                          std::shared_ptr<core::FileSource>()) {
     Code* code = nullptr;
     {
       script_ = script;
+      lazy_source_ = lazy_source;
       core_ = CoreData::New();
       data_ = core_->data();
       data_->reserve(4 * core::Size::KB);
@@ -171,6 +182,25 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
     return code;
   }
 
+  // Function Code deferred by CompileGlobal with source.
+  // function is given by reparsing the lazy code,
+  // and each lazily compiled code has its own CoreData
+  void CompileLazy(const FunctionLiteral& function, Code* code) {
+    LazyCode* const lazy = code->lazy();
+    assert(lazy);
+    {
+      script_ = code->script();
+      lazy_source_ = lazy->source();
+      core_ = CoreData::New();
+      data_ = core_->data();
+      data_->reserve(core::Size::KB);
+      code->set_core_data(core_);
+      code->set_lazy(nullptr);
+      EmitFunctionCode<Code::FUNCTION>(function, code, lazy->upper());
+    }
+    CompileEpilogue(code);
+  }
+
   // Function Code
   Code* CompileFunction(const FunctionLiteral& function, JSScript* script) {
     Code* code = nullptr;
@@ -237,9 +267,68 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
     return code;
   }
 
+  // global declaration instantiation is done at compile time.
+  // these are shared with CodeDeserializer, which instantiates
+  // declarations of cached global code.
+  // returns false if function binding can't be created
+  static bool InstantiateGlobalFunction(Context* ctx,
+                                        Symbol name, JSFunction* func) {
+    JSGlobal* global = ctx->global_obj();
+    const uint32_t entry = global->LookupVariable(name);
+    if (entry == core::kNotFound32) {
+      // Does global have the same name property?
+      Slot slot;
+      if (global->GetPropertySlot(ctx, name, &slot)) {
+        if (!slot.attributes().IsConfigurable()) {
+          // property found and not configurable
+          if (slot.attributes().IsAccessor()) {
+            return false;
+          }
+          assert(slot.attributes().IsData());
+          if (!slot.attributes().IsWritable() || !slot.attributes().IsEnumerable()) {
+            return false;
+          }
+          // ignore this
+          return true;
+        }
+        // OK. We can remove this property safety and set global register.
+        Error::Dummy dummy;
+        global->Delete(ctx, name, true, &dummy);
+        assert(!dummy);
+      }
+      // new global register
+      global->PushVariable(
+          name, func, Attributes::CreateData(ATTR::W | ATTR::E));
+    } else {
+      // override variable
+      StoredSlot& slot(global->PointAt(entry));
+      if (!slot.attributes().IsWritable() || !slot.attributes().IsEnumerable()) {
+        return false;
+      }
+      slot.set_value(func);
+    }
+    return true;
+  }
+
+  static void InstantiateGlobalVariable(Context* ctx, Symbol name) {
+    JSGlobal* global = ctx->global_obj();
+    const uint32_t entry = global->LookupVariable(name);
+    if (entry == core::kNotFound32) {
+      if (global->HasProperty(ctx, name)) {
+        // ignore this
+        return;
+      }
+      global->PushVariable(
+          name, JSUndefined, Attributes::CreateData(ATTR::W | ATTR::E));
+    }
+  }
+
  private:
   void CompileEpilogue(Code* code) {
     // optimiazation or direct threading
+    if (ctx_->IsSuperinstructionEnabled()) {
+      FuseSuperinstructions(code->GetData());
+    }
 #if defined(IV_LV5_RAILGUN_USE_DIRECT_THREADED_CODE)
     // direct threading label translation
     const DirectThreadingDispatchTable& table = VM::DispatchTable();
@@ -255,6 +344,27 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
     ctx_->global_data()->RegExpClear();
   }
 
+  // peephole pass replacing the first opcode of hot opcode pair with
+  // superinstruction. because the second opcode is left as is and
+  // superinstruction has the same length as the first opcode,
+  // jump offsets, exception handler ranges and line numbers are not changed
+  void FuseSuperinstructions(Code::Data* data) {
+    for (Code::Data::iterator it = data->begin(),
+         last = data->end(); it != last;) {
+      const uint32_t opcode = it->u32[0];
+      const Code::Data::iterator next = it + kOPLength[opcode];
+      if (next == last) {
+        break;
+      }
+      const OP::Type fused = OP::Superinstruction(opcode, next->u32[0]);
+      if (fused != OP::NOP) {
+        assert(kOPLength[fused] == kOPLength[opcode]);
+        it->u32[0] = fused;
+      }
+      it = next;
+    }
+  }
+
   void CodeContextPrologue(Code* code) {
     set_code(code);
     jump_table_.clear();
@@ -715,7 +825,7 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
       eval_result_ = Temporary();
     }
 
-    if (env->scope()->needs_heap_scope()) {
+    if (env->needs_heap_scope()) {
       assert(!env->heap().empty());
       assert(code_->names_.empty());
       Emit<OP::BUILD_ENV>(
@@ -749,7 +859,7 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
           EmitInstantiate(index, info, registers_.LocalID(info.register_location()));
         }
       }
-      if (env->scope()->IsArgumentsRealized()) {
+      if (env->IsArgumentsRealized()) {
         InstantiateArguments();
       }
 
@@ -811,53 +921,18 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
   bool GlobalInstantiation(const FunctionLiteral& lit) {
     registers_.Clear(0, 0);
 
-    JSGlobal* global = ctx()->global_obj();
-
     const Scope& scope = lit.scope();
     typedef Scope::FunctionLiterals Functions;
     const Functions& functions = scope.function_declarations();
     for (Functions::const_iterator it = functions.begin(),
          last = functions.end(); it != last; ++it) {
       const Symbol name = (*it)->name().Address()->symbol();
-      const uint32_t entry = global->LookupVariable(name);
       const uint32_t index = DefineCode(*it);
       Code* target = code_->codes()[index];
       JSFunction* func = ctx()->NewFunction(target, ctx()->global_env());
-      if (entry == core::kNotFound32) {
-        // Does global have the same name property?
-        Slot slot;
-        if (global->GetPropertySlot(ctx(), name, &slot)) {
-          if (!slot.attributes().IsConfigurable()) {
-            // property found and not configurable
-            if (slot.attributes().IsAccessor()) {
-              // report error
-              EmitError(Error::Type, "create mutable function binding failed");
-              return false;
-            }
-            assert(slot.attributes().IsData());
-            if (!slot.attributes().IsWritable() || !slot.attributes().IsEnumerable()) {
-              EmitError(Error::Type, "create mutable function binding failed");
-              return false;
-            }
-            // ignore this
-            continue;
-          }
-          // OK. We can remove this property safety and set global register.
-          Error::Dummy dummy;
-          global->Delete(ctx(), name, true, &dummy);
-          assert(!dummy);
-        }
-        // new global register
-        global->PushVariable(
-            name, func, Attributes::CreateData(ATTR::W | ATTR::E));
-      } else {
-        // override variable
-        StoredSlot& slot(global->PointAt(entry));
-        if (!slot.attributes().IsWritable() || !slot.attributes().IsEnumerable()) {
-          EmitError(Error::Type, "create mutable function binding failed");
-          return false;
-        }
-        slot.set_value(func);
+      if (!InstantiateGlobalFunction(ctx(), name, func)) {
+        EmitError(Error::Type, "create mutable function binding failed");
+        return false;
       }
     }
 
@@ -866,16 +941,7 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
     const Variables& vars = scope.variables();
     for (Variables::const_iterator it = vars.begin(),
          last = vars.end(); it != last; ++it) {
-      const Symbol name = it->first->symbol();
-      const uint32_t entry = global->LookupVariable(name);
-      if (entry == core::kNotFound32) {
-        if (global->HasProperty(ctx(), name)) {
-          // ignore this
-          continue;
-        }
-        global->PushVariable(
-            name, JSUndefined, Attributes::CreateData(ATTR::W | ATTR::E));
-      }
+      InstantiateGlobalVariable(ctx(), it->first->symbol());
     }
 
     return true;
@@ -966,9 +1032,15 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
            it != last; ++it, ++code_info_stack_index) {
         const CodeInfo info = code_info_stack_[code_info_stack_index];
         assert(std::get<0>(info) == *it);
-        EmitFunctionCode<Code::FUNCTION>(*std::get<1>(info),
-                                         *it,
-                                         std::get<2>(info));
+        if (lazy_source_) {
+          (*it)->set_lazy(
+              LazyCode::New(lazy_source_, *std::get<1>(info),
+                            code->strict(), std::get<2>(info)));
+        } else {
+          EmitFunctionCode<Code::FUNCTION>(*std::get<1>(info),
+                                           *it,
+                                           std::get<2>(info));
+        }
       }
     }
     current_variable_scope_ = target->upper();
@@ -1132,6 +1204,7 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
   CoreData* core_;
   Code::Data* data_;
   JSScript* script_;
+  std::shared_ptr<core::FileSource> lazy_source_;
   CodeInfoStack code_info_stack_;
   Jump::Table jump_table_;
   Level::Stack level_stack_;
@@ -1152,9 +1225,31 @@ class Compiler : private core::Noncopyable<Compiler>, public AstVisitor {
 inline Code* CompileGlobal(Context* ctx,
                            const FunctionLiteral& global,
                            JSScript* script,
-                           bool use_folded_registers = false) {
+                           bool use_folded_registers = false,
+                           std::shared_ptr<core::FileSource> lazy_source =
+                               std::shared_ptr<core::FileSource>()) {
   Compiler compiler(ctx, use_folded_registers);
-  return compiler.CompileGlobal(global, script);
+  return compiler.CompileGlobal(global, script, lazy_source);
+}
+
+// lazy source is only given in not folded registers mode.
+// AST of the function is released after compiling it
+inline void CompileLazyCode(Context* ctx, Code* code) {
+  LazyCode* const lazy = code->lazy();
+  assert(lazy);
+  AstFactory factory(ctx);
+  core::Parser<AstFactory, core::FileSource>
+      parser(&factory, *lazy->source(), ctx->symbol_table());
+  parser.set_strict(lazy->strict());
+  const FunctionLiteral* const function =
+      parser.ParseFunctionLiteralAt(lazy->begin_position(),
+                                    lazy->line_number(),
+                                    lazy->decl_type(),
+                                    lazy->arg_type());
+  // source is already parsed successfully as a part of global code
+  assert(function);
+  Compiler compiler(ctx, false);
+  compiler.CompileLazy(*function, code);
 }
 
 inline Code* CompileFunction(Context* ctx,
@@ -1262,8 +1262,14 @@ inline RegisterID Compiler::EmitCall(const Call& call, RegisterID dst) {
         Instruction::SSW(site.callee(),
                          site.GetFirstPosition(),
                          site.argc_with_this()));
+  } else if (op == OP::CALL) {
+    Emit<OP::CALL>(
+        Instruction::SSW(site.callee(),
+                         site.GetFirstPosition(),
+                         site.argc_with_this()),
+        Instruction::Callee(nullptr));
   } else {
-    Emit<op>(
+    Emit<OP::CONSTRUCT>(
         Instruction::SSW(site.callee(),
                          site.GetFirstPosition(),
                          site.argc_with_this()));
@@ -16,7 +16,10 @@ inline Context::Context()
     RAX_(),
     direct_eval_map_(10),
     iterator_cache_(),
-    global_map_cache_(nullptr) {
+    global_map_cache_(nullptr),
+    tier_up_threshold_(0),
+    superinstruction_enabled_(true),
+    code_cache_directory_() {
   Init();
 }
 
@@ -26,7 +29,10 @@ inline Context::Context(JSAPI function_constructor, JSAPI global_eval)
     RAX_(),
     direct_eval_map_(10),
     iterator_cache_(),
-    global_map_cache_(nullptr) {
+    global_map_cache_(nullptr),
+    tier_up_threshold_(0),
+    superinstruction_enabled_(true),
+    code_cache_directory_() {
   Init();
 }
 
@@ -1,5 +1,6 @@
 #ifndef IV_LV5_RAILGUN_CONTEXT_FWD_H_
 #define IV_LV5_RAILGUN_CONTEXT_FWD_H_
+#include <string>
 #include <gc/gc_cpp.h>
 #include <iv/lv5/railgun/fwd.h>
 #include <iv/lv5/railgun/lru_code_map.h>
@@ -37,6 +38,48 @@ class Context : public lv5::Context {
 
   virtual JSFunction* NewFunction(Code* code, JSEnv* env);
 
+  // tiered execution
+  // when tier up threshold is not 0, code is interpreted at first and
+  // TierUp is called when hot code counter of code reaches threshold.
+  // hot code counter is incremented by invocations and backward jumps.
+  uint32_t tier_up_threshold() const { return tier_up_threshold_; }
+
+  void set_tier_up_threshold(uint32_t threshold) {
+    tier_up_threshold_ = threshold;
+  }
+
+  bool IsTiered() const { return tier_up_threshold_ != 0; }
+
+  virtual void TierUp(Code* code) { }
+
+  // on-stack replacement
+  // called at backward jump to target in interpreted frame whose code is
+  // already compiled by TierUp. if execution of frame is transferred,
+  // returns true and stores frame result to result.
+  virtual bool OnStackReplace(Frame* frame, const Instruction* target,
+                              JSVal* result, Error* e) {
+    return false;
+  }
+
+  // superinstructions
+  // when enabled, Compiler fuses hot opcode pairs into superinstructions
+  bool IsSuperinstructionEnabled() const { return superinstruction_enabled_; }
+
+  void set_superinstruction_enabled(bool enabled) {
+    superinstruction_enabled_ = enabled;
+  }
+
+  // bytecode cache
+  // when directory is not empty, compiled global code is stored to and
+  // loaded from directory. see code_cache.h
+  const std::string& code_cache_directory() const {
+    return code_cache_directory_;
+  }
+
+  void set_code_cache_directory(const std::string& directory) {
+    code_cache_directory_ = directory;
+  }
+
   inline JSVal& RAX() { return RAX_; }
 
   NativeIterator* GainNativeIterator(JSObject* obj);
@@ -56,6 +99,9 @@ class Context : public lv5::Context {
   LRUCodeMap direct_eval_map_;
   std::vector<NativeIterator*> iterator_cache_;
   MapCache* global_map_cache_;
+  uint32_t tier_up_threshold_;
+  bool superinstruction_enabled_;
+  std::string code_cache_directory_;
 
 #ifdef DEBUG
   int iterator_live_count_;
@@ -30,48 +30,62 @@ inline GC_ms_entry* CoreData::MarkChildren(GC_word* top,
                                            GC_ms_entry* mark_sp_limit,
                                            GC_word env) {
   if (compiled_) {
-    if (!native_code()) {
-      for (std::size_t n = 0, len = data_.size(); n < len;) {
-        const Instruction& instr = data_[n];
-        // loop and search Map pointer operations
-        // check global opcodes
-        if (VM::IsOP<OP::LOAD_GLOBAL>(instr) ||
-            VM::IsOP<OP::STORE_GLOBAL>(instr)) {
-          // opcode | (dst | index) | map | offset
+    // instructions are scanned even if native code exists, because
+    // interpreted code in tiered execution caches Maps in them
+    for (std::size_t n = 0, len = data_.size(); n < len;) {
+      const Instruction& instr = data_[n];
+      // loop and search Map pointer operations
+      // check global opcodes
+      if (VM::IsOP<OP::LOAD_GLOBAL>(instr) ||
+          VM::IsOP<OP::STORE_GLOBAL>(instr)) {
+        // opcode | (dst | index) | map | offset
+        entry = GC_MARK_AND_PUSH(
+            data_[n + 2].map,
+            entry, mark_sp_limit, reinterpret_cast<void**>(this));
+      } else if (VM::IsOP<OP::STORE_PROP>(instr)) {
+        // opcode | (base | src | index) | nop | nop
+        entry = GC_MARK_AND_PUSH(
+            data_[n + 2].map,
+            entry, mark_sp_limit, reinterpret_cast<void**>(this));
+      } else if (VM::IsOP<OP::LOAD_PROP_OWN>(instr)) {
+        // opcode | (dst | base | name) | map | offset | nop
+        entry = GC_MARK_AND_PUSH(
+            data_[n + 2].map,
+            entry, mark_sp_limit, reinterpret_cast<void**>(this));
+      } else if (VM::IsOP<OP::LOAD_PROP_PROTO>(instr)) {
+        // opcode | (dst | base | name) | map | map | offset
+        entry = GC_MARK_AND_PUSH(
+            data_[n + 2].map,
+            entry, mark_sp_limit, reinterpret_cast<void**>(this));
+        entry = GC_MARK_AND_PUSH(
+            data_[n + 3].map,
+            entry, mark_sp_limit, reinterpret_cast<void**>(this));
+      } else if (VM::IsOP<OP::LOAD_PROP_CHAIN>(instr)) {
+        // opcode | (dst | base | name) | chain | map | offset
+        entry = GC_MARK_AND_PUSH(
+            data_[n + 2].chain,
+            entry, mark_sp_limit, reinterpret_cast<void**>(this));
+        entry = GC_MARK_AND_PUSH(
+            data_[n + 3].map,
+            entry, mark_sp_limit, reinterpret_cast<void**>(this));
+      } else if (VM::IsOP<OP::LOAD_PROP_POLY>(instr)) {
+        // opcode | (dst | base | name) | ic | nop | nop
+        entry = GC_MARK_AND_PUSH(
+            data_[n + 2].poly_ic,
+            entry, mark_sp_limit, reinterpret_cast<void**>(this));
+      } else if (VM::IsOP<OP::CALL>(instr)) {
+        // opcode | (callee | offset | argc_with_this) | feedback
+        if (data_[n + 2].callee != Instruction::PolymorphicCallee()) {
           entry = GC_MARK_AND_PUSH(
-              data_[n + 2].map,
-              entry, mark_sp_limit, reinterpret_cast<void**>(this));
-        } else if (VM::IsOP<OP::STORE_PROP>(instr)) {
-          // opcode | (base | src | index) | nop | nop
-          entry = GC_MARK_AND_PUSH(
-              data_[n + 2].map,
-              entry, mark_sp_limit, reinterpret_cast<void**>(this));
-        } else if (VM::IsOP<OP::LOAD_PROP_OWN>(instr)) {
-          // opcode | (dst | base | name) | map | offset | nop
-          entry = GC_MARK_AND_PUSH(
-              data_[n + 2].map,
-              entry, mark_sp_limit, reinterpret_cast<void**>(this));
-        } else if (VM::IsOP<OP::LOAD_PROP_PROTO>(instr)) {
-          // opcode | (dst | base | name) | map | map | offset
-          entry = GC_MARK_AND_PUSH(
-              data_[n + 2].map,
-              entry, mark_sp_limit, reinterpret_cast<void**>(this));
-          entry = GC_MARK_AND_PUSH(
-              data_[n + 3].map,
-              entry, mark_sp_limit, reinterpret_cast<void**>(this));
-        } else if (VM::IsOP<OP::LOAD_PROP_CHAIN>(instr)) {
-          // opcode | (dst | base | name) | chain | map | offset
-          entry = GC_MARK_AND_PUSH(
-              data_[n + 2].chain,
-              entry, mark_sp_limit, reinterpret_cast<void**>(this));
-          entry = GC_MARK_AND_PUSH(
-              data_[n + 3].map,
+              data_[n + 2].callee,
               entry, mark_sp_limit, reinterpret_cast<void**>(this));
         }
-        n += instr.GetLength();
       }
-    } else {
-      entry = native_code_->MarkChildren(top, entry, mark_sp_limit, env);
+      n += instr.GetLength();
+    }
+    for (NativeCodes::const_iterator it = native_codes_.begin(),
+         last = native_codes_.end(); it != last; ++it) {
+      entry = (*it)->MarkChildren(top, entry, mark_sp_limit, env);
     }
   }
   return entry;
@@ -79,34 +93,44 @@ inline GC_ms_entry* CoreData::MarkChildren(GC_word* top,
 
 inline void CoreData::MarkChildren(radio::Core* core) {
   if (compiled_) {
-    if (!native_code()) {
-      for (std::size_t n = 0, len = data_.size(); n < len;) {
-        const Instruction& instr = data_[n];
-        // loop and search Map pointer operations
-        // check global opcodes
-        if (VM::IsOP<OP::LOAD_GLOBAL>(instr) ||
-            VM::IsOP<OP::STORE_GLOBAL>(instr)) {
-          // opcode | (dst | index) | map | offset
-          core->MarkCell(data_[n + 2].map);
-        } else if (VM::IsOP<OP::STORE_PROP>(instr)) {
-          // opcode | (base | src | index) | nop | nop
-          core->MarkCell(data_[n + 2].map);
-        } else if (VM::IsOP<OP::LOAD_PROP_OWN>(instr)) {
-          // opcode | (dst | base | name) | map | offset | nop
-          core->MarkCell(data_[n + 2].map);
-        } else if (VM::IsOP<OP::LOAD_PROP_PROTO>(instr)) {
-          // opcode | (dst | base | name) | map | map | offset
-          core->MarkCell(data_[n + 2].map);
-          core->MarkCell(data_[n + 3].map);
-        } else if (VM::IsOP<OP::LOAD_PROP_CHAIN>(instr)) {
-          // opcode | (dst | base | name) | chain | map | offset
-          core->MarkCell(data_[n + 2].chain);
-          core->MarkCell(data_[n + 3].map);
+    // instructions are scanned even if native code exists, because
+    // interpreted code in tiered execution caches Maps in them
+    for (std::size_t n = 0, len = data_.size(); n < len;) {
+      const Instruction& instr = data_[n];
+      // loop and search Map pointer operations
+      // check global opcodes
+      if (VM::IsOP<OP::LOAD_GLOBAL>(instr) ||
+          VM::IsOP<OP::STORE_GLOBAL>(instr)) {
+        // opcode | (dst | index) | map | offset
+        core->MarkCell(data_[n + 2].map);
+      } else if (VM::IsOP<OP::STORE_PROP>(instr)) {
+        // opcode | (base | src | index) | nop | nop
+        core->MarkCell(data_[n + 2].map);
+      } else if (VM::IsOP<OP::LOAD_PROP_OWN>(instr)) {
+        // opcode | (dst | base | name) | map | offset | nop
+        core->MarkCell(data_[n + 2].map);
+      } else if (VM::IsOP<OP::LOAD_PROP_PROTO>(instr)) {
+        // opcode | (dst | base | name) | map | map | offset
+        core->MarkCell(data_[n + 2].map);
+        core->MarkCell(data_[n + 3].map);
+      } else if (VM::IsOP<OP::LOAD_PROP_CHAIN>(instr)) {
+        // opcode | (dst | base | name) | chain | map | offset
+        core->MarkCell(data_[n + 2].chain);
+        core->MarkCell(data_[n + 3].map);
+      } else if (VM::IsOP<OP::LOAD_PROP_POLY>(instr)) {
+        // opcode | (dst | base | name) | ic | nop | nop
+        core->MarkCell(data_[n + 2].poly_ic);
+      } else if (VM::IsOP<OP::CALL>(instr)) {
+        // opcode | (callee | offset | argc_with_this) | feedback
+        if (data_[n + 2].callee != Instruction::PolymorphicCallee()) {
+          core->MarkCell(data_[n + 2].callee);
         }
-        n += instr.GetLength();
       }
-    } else {
-      native_code_->MarkChildren(core);
+      n += instr.GetLength();
+    }
+    for (NativeCodes::const_iterator it = native_codes_.begin(),
+         last = native_codes_.end(); it != last; ++it) {
+      (*it)->MarkChildren(core);
     }
   }
 }
@@ -17,6 +17,7 @@ class CoreData : public GCKind<CoreData> {
   friend class breaker::Compiler;
 
   typedef std::vector<Instruction> Data;
+  typedef std::vector<std::unique_ptr<breaker::NativeCode> > NativeCodes;
 
   // Vector of pairs of bytecode offset and line number.
   // This offset is counted from Total Bytecode (that is, CoreData unit),
@@ -76,6 +77,8 @@ class CoreData : public GCKind<CoreData> {
     }
   }
 
+  const Lines& lines() const { return lines_; }
+
   std::size_t LookupLineNumber(std::size_t bytecode_offset) const {
     const Lines::const_iterator it =
         std::upper_bound(lines_.begin(),
@@ -87,25 +90,24 @@ class CoreData : public GCKind<CoreData> {
     return 1;
   }
 
-  const breaker::NativeCode* native_code() const { return native_code_.get(); }
-
  private:
   explicit CoreData()
     : data_(),
       lines_(),
       compiled_(false),
-      native_code_() {
+      native_codes_() {
     lines_.reserve(1024);
   }
 
-  void set_native_code(breaker::NativeCode* code) {
-    native_code_.reset(code);
+  // in tiered execution, each hot code has its own native code
+  void AddNativeCode(breaker::NativeCode* code) {
+    native_codes_.push_back(std::unique_ptr<breaker::NativeCode>(code));
   }
 
   Data data_;
   Lines lines_;
   bool compiled_;
-  std::unique_ptr<breaker::NativeCode> native_code_;
+  NativeCodes native_codes_;
 };
 
 } } }  // namespace iv::lv5::railgun
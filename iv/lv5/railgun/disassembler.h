@@ -102,6 +102,7 @@ class DisAssembler : private core::Noncopyable<> {
       case OP::UNARY_NOT:
       case OP::UNARY_NEGATIVE:
       case OP::UNARY_POSITIVE:
+      case OP::MV_RETURN:
       case OP::MV: {
         const int r0 = instr[1].i16[0], r1 = instr[1].i16[1];
         len = snprintf(
@@ -160,6 +161,9 @@ class DisAssembler : private core::Noncopyable<> {
       case OP::DELETE_NAME:
       case OP::STORE_NAME:
       case OP::LOAD_NAME:
+      case OP::LOAD_CONST_IF_FALSE_BINARY_LT:
+      case OP::LOAD_CONST_BINARY_SUBTRACT:
+      case OP::LOAD_CONST_BINARY_ADD:
       case OP::LOAD_CONST:
       case OP::INITIALIZE_HEAP_IMMUTABLE: {
         const int r0 = instr[1].ssw.i16[0];
@@ -239,6 +243,7 @@ class DisAssembler : private core::Noncopyable<> {
       case OP::BINARY_DIVIDE:
       case OP::BINARY_MULTIPLY:
       case OP::BINARY_SUBTRACT:
+      case OP::BINARY_ADD_RETURN:
       case OP::BINARY_ADD:
       case OP::POSTFIX_INCREMENT_ELEMENT:
       case OP::POSTFIX_DECREMENT_ELEMENT:
@@ -283,6 +288,7 @@ class DisAssembler : private core::Noncopyable<> {
       case OP::DELETE_PROP:
       case OP::STORE_PROP_GENERIC:
       case OP::LOAD_PROP_GENERIC:
+      case OP::LOAD_PROP_MEGAMORPHIC:
       case OP::LOAD_PROP: {
         const int r0 = instr[1].ssw.i16[0], r1 = instr[1].ssw.i16[1];
         const unsigned int name = instr[1].ssw.u32;
@@ -343,6 +349,16 @@ class DisAssembler : private core::Noncopyable<> {
             reinterpret_cast<const void*>(map), offset);
         break;
       }
+      case OP::LOAD_PROP_POLY: {
+        const int r0 = instr[1].ssw.i16[0], r1 = instr[1].ssw.i16[1];
+        const unsigned int name = instr[1].ssw.u32;
+        const PolyIC* ic = instr[2].poly_ic;
+        len = snprintf(
+            buf, sizeof(buf) - 1, "%s %s %s %u %p",
+            op, ExtractReg(r0).c_str(), ExtractReg(r1).c_str(), name,
+            reinterpret_cast<const void*>(ic));
+        break;
+      }
       case OP::IF_TRUE:
       case OP::IF_FALSE: {
         const int r0 = instr[1].jump.i16[0], jump = instr[1].jump.to;
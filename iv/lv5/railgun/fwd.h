@@ -11,6 +11,7 @@ class Operation;
 class VM;
 class CodeContext;
 class Code;
+class LazyCode;
 struct Frame;
 class Stack;
 
@@ -29,6 +30,7 @@ class DisAssembler;
 JSVal FunctionConstructor(const Arguments& args, Error* e);
 JSVal GlobalEval(const Arguments& args, Error* e);
 inline JSVal DirectCallToEval(const Arguments& args, Frame* frame, Error* e);
+inline void CompileLazyCode(Context* ctx, Code* code);
 
 class JSScript;
 
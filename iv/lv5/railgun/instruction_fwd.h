@@ -10,9 +10,12 @@ namespace lv5 {
 class Map;
 class Chain;
 class StoredSlot;
+class JSFunction;
 
 namespace railgun {
 
+class PolyIC;
+
 struct Instruction {
   Instruction(uint32_t arg) { u32[0] = arg; }  // NOLINT
 
@@ -38,7 +41,9 @@ struct Instruction {
     } jump;
     Map* map;
     Chain* chain;
+    PolyIC* poly_ic;
     StoredSlot* slot;
+    JSFunction* callee;
     uint64_t u64;
   };
 
@@ -54,6 +59,18 @@ struct Instruction {
     return instr;
   }
 
+  static Instruction Callee(JSFunction* callee) {
+    Instruction instr(0u);
+    instr.callee = callee;
+    return instr;
+  }
+
+  // callee feedback of CALL site which is called with multiple functions.
+  // this is not a valid pointer, so it is not marked
+  static JSFunction* PolymorphicCallee() {
+    return reinterpret_cast<JSFunction*>(static_cast<uintptr_t>(1));
+  }
+
   static Instruction Reg2(RegisterID a, RegisterID b) {
     Instruction instr(0u);
     instr.i16[0] = static_cast<int16_t>(a->register_offset());
@@ -26,8 +26,7 @@ class JSVMFunction : public JSFunction {
 
   virtual JSVal Construct(Arguments* args, Error* e) {
     Context* const ctx = static_cast<Context*>(args->ctx());
-    Map* map = construct_map(ctx, IV_LV5_ERROR(e));
-    JSObject* const obj = JSObject::New(ctx, map);
+    JSObject* const obj = NewConstructObject(ctx, IV_LV5_ERROR(e));
     assert(args->IsConstructorCalled());
     return JSVMFunction::Call(args, obj, e);
   }
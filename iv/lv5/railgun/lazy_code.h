@@ -0,0 +1,76 @@
+#ifndef IV_LV5_RAILGUN_LAZY_CODE_H_
+#define IV_LV5_RAILGUN_LAZY_CODE_H_
+#include <iv/detail/memory.h>
+#include <iv/file_source.h>
+#include <iv/lv5/specialized_ast.h>
+#include <iv/lv5/radio/cell.h>
+#include <iv/lv5/railgun/fwd.h>
+#include <iv/lv5/railgun/scope.h>
+namespace iv {
+namespace lv5 {
+namespace railgun {
+
+// Source range and enclosing variable scope of function code,
+// which is reparsed and compiled at first invocation.
+// AST of enclosing code is not kept
+class LazyCode : public radio::HeapObject<radio::POINTER_CLEANUP> {
+ public:
+  typedef FunctionLiteral::DeclType DeclType;
+  typedef FunctionLiteral::ArgType ArgType;
+
+  static LazyCode* New(std::shared_ptr<core::FileSource> source,
+                       const FunctionLiteral& literal,
+                       bool strict,
+                       const std::shared_ptr<VariableScope>& upper) {
+    return new LazyCode(source, literal, strict, upper);
+  }
+
+  const std::shared_ptr<core::FileSource>& source() const { return source_; }
+
+  std::size_t begin_position() const { return begin_position_; }
+
+  std::size_t line_number() const { return line_number_; }
+
+  DeclType decl_type() const { return decl_type_; }
+
+  ArgType arg_type() const { return arg_type_; }
+
+  // strict mode of enclosing code
+  bool strict() const { return strict_; }
+
+  const std::shared_ptr<VariableScope>& upper() const { return upper_; }
+
+ private:
+  LazyCode(std::shared_ptr<core::FileSource> source,
+           const FunctionLiteral& literal,
+           bool strict,
+           const std::shared_ptr<VariableScope>& upper)
+    : source_(source),
+      begin_position_(literal.begin_position()),
+      line_number_(literal.line_number()),
+      decl_type_(literal.type()),
+      arg_type_(GetArgType(literal)),
+      strict_(strict),
+      upper_(upper) {
+  }
+
+  // getter and setter literals begin at their parameters
+  static ArgType GetArgType(const FunctionLiteral& literal) {
+    if (literal.begin_position() != literal.block_begin_position()) {
+      return FunctionLiteral::GENERAL;
+    }
+    return literal.params().empty() ?
+        FunctionLiteral::GETTER : FunctionLiteral::SETTER;
+  }
+
+  std::shared_ptr<core::FileSource> source_;
+  std::size_t begin_position_;
+  std::size_t line_number_;
+  DeclType decl_type_;
+  ArgType arg_type_;
+  bool strict_;
+  std::shared_ptr<VariableScope> upper_;
+};
+
+} } }  // namespace iv::lv5::railgun
+#endif  // IV_LV5_RAILGUN_LAZY_CODE_H_
@@ -83,6 +83,8 @@ V(LOAD_PROP_GENERIC, 5)\
 V(LOAD_PROP_OWN, 5)\
 V(LOAD_PROP_PROTO, 5)\
 V(LOAD_PROP_CHAIN, 5)\
+V(LOAD_PROP_POLY, 5)\
+V(LOAD_PROP_MEGAMORPHIC, 5)\
 V(STORE_PROP, 4)\
 V(STORE_PROP_GENERIC, 4)\
 V(DELETE_PROP, 5)\
@@ -159,7 +161,7 @@ V(POSTFIX_INCREMENT, 2)\
 V(POSTFIX_DECREMENT, 2)\
 V(PREPARE_DYNAMIC_CALL, 2)\
 \
-V(CALL, 2)\
+V(CALL, 3)\
 V(CONSTRUCT, 2)\
 V(EVAL, 2)\
 V(RESULT, 2)\
@@ -176,7 +178,14 @@ V(BUILD_ENV, 2)\
 V(INSTANTIATE_DECLARATION_BINDING, 2)\
 V(INSTANTIATE_VARIABLE_BINDING, 2)\
 V(INITIALIZE_HEAP_IMMUTABLE, 2)\
-V(LOAD_ARGUMENTS, 2)
+V(LOAD_ARGUMENTS, 2)\
+/* superinstructions */\
+/* first opcode of hot pair is replaced and second opcode is left as is */\
+V(LOAD_CONST_BINARY_ADD, 2)\
+V(LOAD_CONST_BINARY_SUBTRACT, 2)\
+V(LOAD_CONST_IF_FALSE_BINARY_LT, 2)\
+V(BINARY_ADD_RETURN, 2)\
+V(MV_RETURN, 2)
 
 struct OP {
 #define IV_LV5_RAILGUN_DEFINE_ENUM(V, N) V,
@@ -323,6 +332,29 @@ struct OP {
     return OP::NOP;  // makes compiler happy
   }
 
+  // superinstruction of opcode pair (first, second), or NOP.
+  // superinstruction has the same length as first and executes second inline.
+  // both opcodes must not be rewritten by VM at runtime,
+  // so LOAD_PROP (rewritten by property caches) is not fused
+  static OP::Type Superinstruction(uint32_t first, uint32_t second) {
+    switch (first) {
+      case OP::LOAD_CONST:
+        switch (second) {
+          case OP::BINARY_ADD: return OP::LOAD_CONST_BINARY_ADD;
+          case OP::BINARY_SUBTRACT: return OP::LOAD_CONST_BINARY_SUBTRACT;
+          case OP::IF_FALSE_BINARY_LT:
+            return OP::LOAD_CONST_IF_FALSE_BINARY_LT;
+          default: return OP::NOP;
+        }
+      case OP::BINARY_ADD:
+        return (second == OP::RETURN) ? OP::BINARY_ADD_RETURN : OP::NOP;
+      case OP::MV:
+        return (second == OP::RETURN) ? OP::MV_RETURN : OP::NOP;
+      default:
+        return OP::NOP;
+    }
+  }
+
   static inline const char* String(int op);
 };
 
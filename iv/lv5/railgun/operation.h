@@ -6,8 +6,10 @@
 #include <iv/lv5/jsval.h>
 #include <iv/lv5/chain.h>
 #include <iv/lv5/jsglobal.h>
+#include <iv/lv5/jstyped_array.h>
 #include <iv/lv5/railgun/fwd.h>
 #include <iv/lv5/railgun/instruction_fwd.h>
+#include <iv/lv5/railgun/poly_ic.h>
 namespace iv {
 namespace lv5 {
 namespace railgun {
@@ -53,7 +55,7 @@ class Operation {
                              arg + (argc_with_this - 1),
                              argc_with_this - 1);
     const JSAPI native = func->NativeFunction();
-    if (native && native == &GlobalEval) {
+    if (native && native == ctx_->global_eval()) {
       // direct call to eval point
       args.set_this_binding(args.this_binding());
       return DirectCallToEval(args, prev, e);
@@ -139,8 +141,9 @@ class Operation {
     // property found
     if (!slot.IsLoadCacheable() || symbol::IsArrayIndexSymbol(s)) {
       // bailout to generic
+      // slot may be accessor, so return result of getter
       instr[0] = Instruction::GetOPInstruction(generic);
-      return slot.value();
+      return res;
     }
 
     assert(!symbol::IsArrayIndexSymbol(s));
@@ -182,8 +185,57 @@ class Operation {
     return slot.value();
   }
 
+  // load property and fill entry of polymorphic caches.
+  // entry->map is nullptr if result is not cacheable
+  JSVal LoadProp(JSVal base, Symbol s, PolyIC::Entry* entry, Error* e) {
+    // opcode | (dst | base | name) | ic | nop | nop
+    entry->map = nullptr;
+    base.CheckObjectCoercible(CHECK);
+    Slot slot;
+    const JSVal res = base.GetSlot(ctx_, s, &slot, IV_LV5_ERROR(e));
+
+    if (slot.IsNotFound() ||
+        !slot.IsLoadCacheable() || symbol::IsArrayIndexSymbol(s)) {
+      return res;
+    }
+
+    JSObject* obj = nullptr;
+    if (base.IsPrimitive()) {
+      obj = base.GetPrimitiveProto(ctx_);
+    } else {
+      obj = base.object();
+    }
+
+    if (slot.base() == obj) {
+      // own property
+      entry->map = obj->map();
+      entry->prototype = nullptr;
+      entry->offset = slot.offset();
+    } else if (slot.base() == obj->prototype()) {
+      // proto property
+      obj->FlattenMap();
+      entry->map = obj->map();
+      entry->prototype = slot.base()->map();
+      entry->offset = slot.offset();
+    }
+    // chain property is not cached
+    return res;
+  }
+
   JSVal LoadElement(JSVal base,
                     JSVal element, bool strict, Error* e) {
+    if (base.IsObject() && element.IsInt32() && element.int32() >= 0) {
+      // array index fast path
+      JSObject* obj = base.object();
+      const uint32_t index = element.int32();
+      JSVal res;
+      if (obj->GetDenseIndexed(index, &res) ||
+          GetTypedArrayDirect(obj, index, &res)) {
+        return res;
+      }
+      Slot slot;
+      return obj->GetIndexedSlot(ctx_, index, &slot, e);
+    }
     base.CheckObjectCoercible(CHECK);
     const Symbol s = element.ToSymbol(ctx_, CHECK);
     return LoadPropImpl(base, s, strict, e);
@@ -242,6 +294,18 @@ class Operation {
 
   void StoreElement(JSVal base, JSVal element,
                     JSVal stored, bool strict, Error* e) {
+    if (base.IsObject() && element.IsInt32() && element.int32() >= 0) {
+      // array index fast path
+      JSObject* obj = base.object();
+      const uint32_t index = element.int32();
+      if (obj->PutDenseIndexed(index, stored) ||
+          PutTypedArrayDirect(obj, index, stored)) {
+        return;
+      }
+      Slot slot;
+      obj->PutIndexedSlot(ctx_, index, stored, &slot, strict, e);
+      return;
+    }
     base.CheckObjectCoercible(CHECK);
     const Symbol s = element.ToSymbol(ctx_, CHECK);
     StorePropImpl(base, s, stored, strict, e);
@@ -613,6 +677,43 @@ class Operation {
     return false;
   }
 
+#define IV_LV5_RAILGUN_TYPED_ARRAY_LIST(V)\
+  V(Int8Array)\
+  V(Uint8Array)\
+  V(Int16Array)\
+  V(Uint16Array)\
+  V(Int32Array)\
+  V(Uint32Array)\
+  V(Float32Array)\
+  V(Float64Array)\
+  V(Uint8ClampedArray)
+
+  static bool GetTypedArrayDirect(const JSObject* obj,
+                                  uint32_t index, JSVal* res) {
+    switch (obj->cls()->type) {
+#define V(NAME)\
+      case Class::NAME:\
+        return JS##NAME::GetDirect(obj, index, res);
+      IV_LV5_RAILGUN_TYPED_ARRAY_LIST(V)
+#undef V
+      default:
+        return false;
+    }
+  }
+
+  bool PutTypedArrayDirect(JSObject* obj, uint32_t index, JSVal val) {
+    switch (obj->cls()->type) {
+#define V(NAME)\
+      case Class::NAME:\
+        return JS##NAME::PutDirect(obj, ctx_, index, val);
+      IV_LV5_RAILGUN_TYPED_ARRAY_LIST(V)
+#undef V
+      default:
+        return false;
+    }
+  }
+
+#undef IV_LV5_RAILGUN_TYPED_ARRAY_LIST
 #undef CHECK
 
   inline lv5::Context* ctx() const { return ctx_; }
@@ -0,0 +1,155 @@
+// polymorphic property caches of railgun interpreter
+//
+// LOAD_PROP_OWN and LOAD_PROP_PROTO cache one Map in instruction stream.
+// when they miss, the site is rewritten to LOAD_PROP_POLY, which holds
+// PolyIC caching up to kMaxPolyICSize maps. when PolyIC overflows, the site
+// is rewritten to LOAD_PROP_MEGAMORPHIC, which looks up MegamorphicCache
+// shared by all sites in VM and keyed by (Map, Symbol).
+//
+// see also breaker/poly_ic.h
+#ifndef IV_LV5_RAILGUN_POLY_IC_H_
+#define IV_LV5_RAILGUN_POLY_IC_H_
+#include <functional>
+#include <iv/detail/array.h>
+#include <iv/lv5/symbol.h>
+#include <iv/lv5/jsobject_fwd.h>
+#include <iv/lv5/map.h>
+namespace iv {
+namespace lv5 {
+namespace railgun {
+
+class PolyIC : public radio::HeapObject<radio::POINTER> {
+ public:
+  static const std::size_t kMaxPolyICSize = 4;
+
+  struct Entry {
+    Map* map;
+    Map* prototype;  // nullptr if own property
+    uint32_t offset;
+  };
+
+  PolyIC() : size_(0), entries_() { }
+
+  // returns true if cache hit
+  bool Load(const JSObject* obj, JSVal* res) const {
+    const Map* map = obj->map();
+    for (std::size_t i = 0; i < size_; ++i) {
+      const Entry& entry = entries_[i];
+      if (entry.map != map) {
+        continue;
+      }
+      if (!entry.prototype) {
+        *res = obj->Direct(entry.offset);
+        return true;
+      }
+      // same map means same prototype
+      const JSObject* proto = obj->prototype();
+      if (proto->map() == entry.prototype) {
+        *res = proto->Direct(entry.offset);
+        return true;
+      }
+      return false;
+    }
+    return false;
+  }
+
+  // returns false if cache is full
+  bool Store(Map* map, Map* prototype, uint32_t offset) {
+    Entry* target = nullptr;
+    for (std::size_t i = 0; i < size_; ++i) {
+      if (entries_[i].map == map) {
+        // prototype map is changed, replace it
+        target = &entries_[i];
+        break;
+      }
+    }
+    if (!target) {
+      if (size_ == kMaxPolyICSize) {
+        return false;
+      }
+      target = &entries_[size_++];
+    }
+    target->map = map;
+    target->prototype = prototype;
+    target->offset = offset;
+    return true;
+  }
+
+  std::size_t size() const { return size_; }
+
+  void MarkChildren(radio::Core* core) {
+    for (std::size_t i = 0; i < size_; ++i) {
+      core->MarkCell(entries_[i].map);
+      if (entries_[i].prototype) {
+        core->MarkCell(entries_[i].prototype);
+      }
+    }
+  }
+
+ private:
+  std::size_t size_;
+  std::array<Entry, kMaxPolyICSize> entries_;
+};
+
+// direct mapped (Map, Symbol) => offset cache.
+// this is held in VM, which is scanned conservatively,
+// so cached maps are not collected and their addresses are not reused
+class MegamorphicCache {
+ public:
+  static const std::size_t kSize = 512;
+
+  struct Entry {
+    Map* map;
+    Symbol name;
+    Map* prototype;  // nullptr if own property
+    uint32_t offset;
+  };
+
+  MegamorphicCache() : entries_() { Clear(); }
+
+  bool Load(const JSObject* obj, Symbol name, JSVal* res) const {
+    Map* map = obj->map();
+    const Entry& entry = entries_[Hash(map, name)];
+    if (entry.map != map || entry.name != name) {
+      return false;
+    }
+    if (!entry.prototype) {
+      *res = obj->Direct(entry.offset);
+      return true;
+    }
+    const JSObject* proto = obj->prototype();
+    if (proto->map() == entry.prototype) {
+      *res = proto->Direct(entry.offset);
+      return true;
+    }
+    return false;
+  }
+
+  void Store(Map* map, Symbol name, Map* prototype, uint32_t offset) {
+    Entry& entry = entries_[Hash(map, name)];
+    entry.map = map;
+    entry.name = name;
+    entry.prototype = prototype;
+    entry.offset = offset;
+  }
+
+  void Clear() {
+    for (std::size_t i = 0; i < kSize; ++i) {
+      entries_[i].map = nullptr;
+      entries_[i].name = symbol::kDummySymbol;
+      entries_[i].prototype = nullptr;
+      entries_[i].offset = 0;
+    }
+  }
+
+ private:
+  static std::size_t Hash(const Map* map, Symbol name) {
+    const std::size_t address = reinterpret_cast<uintptr_t>(map) >> 3;
+    return (address ^ std::hash<Symbol>()(name)) & (kSize - 1);
+  }
+
+  std::array<Entry, kSize> entries_;
+};
+
+} } }  // namespace iv::lv5::railgun
+#endif  // IV_LV5_RAILGUN_POLY_IC_H_
@@ -0,0 +1,255 @@
+// opcode profiler of railgun::VM
+//
+// Profiler is always compiled in and disabled by default, so release builds
+// can be profiled. while enabled, VM records
+//
+//   - execution count of each opcode
+//   - count of each dynamically adjacent opcode pair
+//     (candidates of superinstructions)
+//   - cycles attributed to each Code. time stamp counter is read every
+//     kSampleInterval opcodes and elapsed cycles are attributed to
+//     the Code executing at that time
+//   - hit / miss / generic counts of LOAD_PROP and STORE_PROP caches
+//
+// and DumpJSON writes them as one JSON object.
+//
+//   ctx.vm()->profiler()->Enable();
+//   ...
+//   ctx.vm()->profiler()->DumpJSON(stdout);
+#ifndef IV_LV5_RAILGUN_PROFILER_H_
+#define IV_LV5_RAILGUN_PROFILER_H_
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iv/detail/array.h>
+#include <iv/detail/cstdint.h>
+#include <iv/platform.h>
+#include <iv/noncopyable.h>
+#include <iv/lv5/gc_template.h>
+#include <iv/lv5/json_quote.h>
+#include <iv/lv5/railgun/fwd.h>
+#include <iv/lv5/railgun/op.h>
+#include <iv/lv5/railgun/code.h>
+#if defined(IV_COMPILER_MSVC)
+#include <intrin.h>
+#elif defined(IV_CPU_X64) || defined(IV_CPU_IA32)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+namespace iv {
+namespace lv5 {
+namespace railgun {
+
+class Profiler : private core::Noncopyable<Profiler> {
+ public:
+  static const uint32_t kSampleInterval = 1024;
+  // number of opcode pairs written by DumpJSON
+  static const std::size_t kMaxPairs = 64;
+
+  enum ICResult {
+    IC_HIT,
+    IC_MISS,
+    IC_GENERIC,  // cache is given up
+    NUM_OF_IC_RESULT
+  };
+
+  typedef std::array<uint64_t, OP::NUM_OF_OP> Counts;
+  typedef std::vector<uint64_t> PairCounts;
+  typedef std::array<uint64_t, NUM_OF_IC_RESULT> ICCounts;
+
+  struct CodeProfile {
+    CodeProfile() : cycles(0), samples(0) { }
+    uint64_t cycles;
+    uint64_t samples;
+  };
+  // entries are allocated by traceable allocator, so profiled Code is
+  // reachable from GC and its address is not reused until Clear
+  typedef trace::HashMap<const Code*, CodeProfile>::type CodeProfiles;
+
+  Profiler()
+    : enabled_(false),
+      previous_(OP::NUM_OF_OP),
+      countdown_(kSampleInterval),
+      last_tsc_(0),
+      counts_(),
+      pairs_(),
+      codes_(),
+      load_prop_(),
+      store_prop_() {
+    Clear();
+  }
+
+  bool enabled() const { return enabled_; }
+
+  void Enable() {
+    if (pairs_.empty()) {
+      pairs_.resize(OP::NUM_OF_OP * OP::NUM_OF_OP, 0);
+    }
+    previous_ = OP::NUM_OF_OP;
+    countdown_ = kSampleInterval;
+    last_tsc_ = ReadTimeStampCounter();
+    enabled_ = true;
+  }
+
+  void Disable() { enabled_ = false; }
+
+  void Clear() {
+    counts_.fill(0);
+    std::fill(pairs_.begin(), pairs_.end(), 0);
+    codes_.clear();
+    load_prop_.fill(0);
+    store_prop_.fill(0);
+    previous_ = OP::NUM_OF_OP;
+  }
+
+  void Record(OP::Type op, const Code* code) {
+    ++counts_[op];
+    if (previous_ != OP::NUM_OF_OP) {
+      ++pairs_[previous_ * OP::NUM_OF_OP + op];
+    }
+    previous_ = op;
+    if (--countdown_ == 0) {
+      Sample(code);
+    }
+  }
+
+  void RecordLoadProp(ICResult result) { ++load_prop_[result]; }
+
+  void RecordStoreProp(ICResult result) { ++store_prop_[result]; }
+
+  const Counts& counts() const { return counts_; }
+
+  uint64_t pair(OP::Type first, OP::Type second) const {
+    return (pairs_.empty()) ? 0 : pairs_[first * OP::NUM_OF_OP + second];
+  }
+
+  const CodeProfiles& codes() const { return codes_; }
+
+  const ICCounts& load_prop() const { return load_prop_; }
+
+  const ICCounts& store_prop() const { return store_prop_; }
+
+  // counters and cycles are ordered by descending order
+  void DumpJSON(std::FILE* out) const {
+    std::fprintf(out, "{\"sample_interval\":%u,", kSampleInterval);
+
+    // opcodes
+    typedef std::vector<std::pair<uint64_t, std::size_t> > Ranking;
+    Ranking ranking;
+    for (std::size_t op = 0; op < OP::NUM_OF_OP; ++op) {
+      if (counts_[op]) {
+        ranking.push_back(std::make_pair(counts_[op], op));
+      }
+    }
+    std::sort(ranking.begin(), ranking.end(), Greater());
+    std::fputs("\"opcodes\":[", out);
+    for (Ranking::const_iterator it = ranking.begin(),
+         last = ranking.end(); it != last; ++it) {
+      std::fprintf(out, "%s{\"op\":\"%s\",\"count\":%llu}",
+                   (it == ranking.begin()) ? "" : ",",
+                   OP::String(static_cast<int>(it->second)),
+                   static_cast<unsigned long long>(it->first));  // NOLINT
+    }
+    std::fputs("],", out);
+
+    // opcode pairs
+    ranking.clear();
+    for (std::size_t index = 0; index < pairs_.size(); ++index) {
+      if (pairs_[index]) {
+        ranking.push_back(std::make_pair(pairs_[index], index));
+      }
+    }
+    std::sort(ranking.begin(), ranking.end(), Greater());
+    if (ranking.size() > kMaxPairs) {
+      ranking.resize(kMaxPairs);
+    }
+    std::fputs("\"pairs\":[", out);
+    for (Ranking::const_iterator it = ranking.begin(),
+         last = ranking.end(); it != last; ++it) {
+      std::fprintf(out, "%s{\"first\":\"%s\",\"second\":\"%s\",\"count\":%llu}",
+                   (it == ranking.begin()) ? "" : ",",
+                   OP::String(static_cast<int>(it->second / OP::NUM_OF_OP)),
+                   OP::String(static_cast<int>(it->second % OP::NUM_OF_OP)),
+                   static_cast<unsigned long long>(it->first));  // NOLINT
+    }
+    std::fputs("],", out);
+
+    // codes
+    typedef std::vector<std::pair<uint64_t, const Code*> > CodeRanking;
+    CodeRanking code_ranking;
+    for (CodeProfiles::const_iterator it = codes_.begin(),
+         last = codes_.end(); it != last; ++it) {
+      code_ranking.push_back(std::make_pair(it->second.cycles, it->first));
+    }
+    std::sort(code_ranking.begin(), code_ranking.end(), Greater());
+    std::fputs("\"codes\":[", out);
+    for (CodeRanking::const_iterator it = code_ranking.begin(),
+         last = code_ranking.end(); it != last; ++it) {
+      const CodeProfile& profile = codes_.find(it->second)->second;
+      const std::string name = JSONQuoteToUTF8(
+          it->second->GenerateErrorLine(it->second->begin() + 1));
+      std::fprintf(out, "%s{\"code\":%s,\"cycles\":%llu,\"samples\":%llu}",
+                   (it == code_ranking.begin()) ? "" : ",",
+                   name.c_str(),
+                   static_cast<unsigned long long>(profile.cycles),  // NOLINT
+                   static_cast<unsigned long long>(profile.samples));  // NOLINT
+    }
+    std::fputs("],", out);
+
+    // inline caches
+    std::fputs("\"ic\":{\"load_prop\":", out);
+    DumpICCounts(out, load_prop_);
+    std::fputs(",\"store_prop\":", out);
+    DumpICCounts(out, store_prop_);
+    std::fputs("}}\n", out);
+  }
+
+  static uint64_t ReadTimeStampCounter() {
+#if defined(IV_COMPILER_MSVC) || defined(IV_CPU_X64) || defined(IV_CPU_IA32)
+    return __rdtsc();
+#else
+    // no time stamp counter, so nanoseconds are used as cycles
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+ private:
+  struct Greater {
+    template<typename T>
+    bool operator()(const T& lhs, const T& rhs) const {
+      return lhs.first > rhs.first;
+    }
+  };
+
+  void Sample(const Code* code) {
+    const uint64_t now = ReadTimeStampCounter();
+    CodeProfile& profile = codes_[code];
+    profile.cycles += now - last_tsc_;
+    ++profile.samples;
+    last_tsc_ = now;
+    countdown_ = kSampleInterval;
+  }
+
+  static void DumpICCounts(std::FILE* out, const ICCounts& counts) {
+    std::fprintf(out, "{\"hit\":%llu,\"miss\":%llu,\"generic\":%llu}",
+                 static_cast<unsigned long long>(counts[IC_HIT]),  // NOLINT
+                 static_cast<unsigned long long>(counts[IC_MISS]),  // NOLINT
+                 static_cast<unsigned long long>(counts[IC_GENERIC]));  // NOLINT
+  }
+
+  bool enabled_;
+  std::size_t previous_;  // previous opcode, NUM_OF_OP if none
+  uint32_t countdown_;  // opcodes until next sample
+  uint64_t last_tsc_;
+  Counts counts_;
+  PairCounts pairs_;
+  CodeProfiles codes_;
+  ICCounts load_prop_;
+  ICCounts store_prop_;
+};
+
+} } }  // namespace iv::lv5::railgun
+#endif  // IV_LV5_RAILGUN_PROFILER_H_
@@ -23,40 +23,35 @@ class LookupInfo {
     UNUSED
   };
 
-  static LookupInfo NewStack(int32_t register_location,
-                             bool immutable,
-                             const Assigned* assigned) {
+  static LookupInfo NewStack(int32_t register_location, bool immutable) {
     return LookupInfo(STACK,
                       register_location,
                       0,
                       immutable,
-                      0,
-                      assigned);
+                      0);
   }
 
   static LookupInfo NewUnused() {
-    return LookupInfo(UNUSED, 0, 0, false, 0, nullptr);
+    return LookupInfo(UNUSED, 0, 0, false, 0);
   }
 
   static LookupInfo NewLookup() {
-    return LookupInfo(LOOKUP, 0, 0, false, 0, nullptr);
+    return LookupInfo(LOOKUP, 0, 0, false, 0);
   }
 
   static LookupInfo NewGlobal() {
-    return LookupInfo(GLOBAL, 0, 0, false, 0, nullptr);
+    return LookupInfo(GLOBAL, 0, 0, false, 0);
   }
 
   static LookupInfo NewHeap(uint32_t heap_location,
                             int32_t register_location,
                             bool immutable,
-                            uint32_t scope_nest_count,
-                            const Assigned* assigned) {
+                            uint32_t scope_nest_count) {
     return LookupInfo(HEAP,
                       register_location,
                       heap_location,
                       immutable,
-                      scope_nest_count,
-                      assigned);
+                      scope_nest_count);
   }
 
   Type type() const { return type_; }
@@ -69,8 +64,6 @@ class LookupInfo {
 
   bool immutable() const { return immutable_; }
 
-  const Assigned* assigned() const { return assigned_; }
-
   void Displace(int32_t heap, int32_t register_location) {
     assert(type_ == HEAP);
     heap_location_ = heap;
@@ -82,14 +75,12 @@ class LookupInfo {
              int32_t register_location,
              uint32_t heap_location,
              bool immutable,
-             uint32_t scope,
-             const Assigned* assigned)
+             uint32_t scope)
     : type_(type),
       register_location_(register_location),
       heap_location_(heap_location),
       scope_(scope),
-      immutable_(immutable),
-      assigned_(assigned) {
+      immutable_(immutable) {
   }
 
   Type type_;
@@ -97,7 +88,6 @@ class LookupInfo {
   uint32_t heap_location_;
   uint32_t scope_;
   bool immutable_;
-  const Assigned* assigned_;
 };
 
 class VariableScope : private core::Noncopyable<VariableScope> {
@@ -179,6 +169,8 @@ class CodeScope;
 
 typedef CodeScope<Code::FUNCTION> FunctionScope;
 
+// FunctionScope holds no AST node. It is kept as the upper scope of
+// lazily compiled functions after the AST of enclosing code is released
 template<>
 class CodeScope<Code::FUNCTION> : public VariableScope {
  public:
@@ -194,12 +186,14 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
     : VariableScope(
         up,
         (up->scope_nest_count() + (scope->needs_heap_scope() ? 1 : 0))),
-      scope_(scope),
-      literal_(lit),
       map_(),
       heap_(),
       stack_size_(0),
-      is_eval_decl_(is_eval_decl) {
+      is_eval_decl_(is_eval_decl),
+      needs_heap_scope_(scope->needs_heap_scope()),
+      arguments_realized_(scope->IsArgumentsRealized()),
+      direct_call_to_eval_(scope->direct_call_to_eval()),
+      load_callee_needed_(false) {
     assert(upper());
 
     // accumulate heaps for better heap numbers
@@ -211,7 +205,13 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
       // already unique
       assert(map_.find((*it)->symbol()) == map_.end());
       const Assigned* assigned = (*it);
-      if (assigned->IsHeap() || scope_->upper_of_eval()) {
+      if (assigned->function_name() &&
+          (assigned->IsHeap() || scope->upper_of_eval() ||
+           assigned->IsReferenced())) {
+        // binding of function expression name is initialized by callee
+        load_callee_needed_ = true;
+      }
+      if (assigned->IsHeap() || scope->upper_of_eval()) {
         // HEAP
         if (assigned->IsParameter()) {
           const Symbol name = assigned->symbol();
@@ -219,8 +219,7 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
               heap_size,
               FrameConstant<>::ConvertArgToRegister(assigned->parameter()),
               assigned->immutable(),
-              scope_nest_count(),
-              assigned);
+              scope_nest_count());
           ++heap_size;
           if (info.immutable()) {
             immutable_heaps.push_back(name);
@@ -234,8 +233,7 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
               heap_size,
               heap_size,
               assigned->immutable(),
-              scope_nest_count(),
-              assigned);
+              scope_nest_count());
           ++heap_size;
           if (info.immutable()) {
             immutable_heaps.push_back(name);
@@ -250,14 +248,12 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
           if (assigned->IsParameter()) {
             const LookupInfo info = LookupInfo::NewStack(
                 FrameConstant<>::ConvertArgToRegister(assigned->parameter()),
-                assigned->immutable(),
-                assigned);
+                assigned->immutable());
             map_.insert(std::make_pair(assigned->symbol(), info));
           } else {
             const LookupInfo info = LookupInfo::NewStack(
                 stack_size_++,
-                assigned->immutable(),
-                assigned);
+                assigned->immutable());
             map_.insert(std::make_pair(assigned->symbol(), info));
           }
         } else {
@@ -269,14 +265,13 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
 
     if (!is_eval_decl && map_.find(symbol::arguments()) == map_.end()) {
       // not hidden
-      if (scope_->arguments_is_heap() || scope_->direct_call_to_eval()) {
+      if (scope->arguments_is_heap() || scope->direct_call_to_eval()) {
         const Symbol name = symbol::arguments();
         const LookupInfo info = LookupInfo::NewHeap(
             heap_size,
             heap_size,
             scope->strict(),
-            scope_nest_count(),
-            nullptr);
+            scope_nest_count());
         ++heap_size;
         if (info.immutable()) {
           immutable_heaps.push_back(name);
@@ -284,9 +279,9 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
           mutable_heaps.push_back(name);
         }
         map_.insert(std::make_pair(name, info));
-      } else if (scope_->has_arguments()) {
+      } else if (scope->has_arguments()) {
         const LookupInfo info =
-            LookupInfo::NewStack(stack_size_++, scope->strict(), nullptr);
+            LookupInfo::NewStack(stack_size_++, scope->strict());
         map_.insert(std::make_pair(symbol::arguments(), info));
       }
     }
@@ -314,7 +309,7 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
       return it->second;
     } else {
       // not found in this scope
-      if (scope_->direct_call_to_eval()) {
+      if (direct_call_to_eval_) {
         // maybe new variable in this scope
         return LookupInfo::NewLookup();
       }
@@ -324,19 +319,11 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
 
   bool UseExpressionReturn() const { return is_eval_decl_; }
 
-  bool LoadCalleeNeeded() const {
-    if (literal_->IsFunctionNameExposed()) {
-      const Symbol name = literal_->name().Address()->symbol();
-      const VariableMap::const_iterator it = map_.find(name);
-      assert(it != map_.end());
-      if (const Assigned* assigned = it->second.assigned()) {
-        if (assigned->function_name()) {
-          return true;
-        }
-      }
-    }
-    return false;
-  }
+  bool LoadCalleeNeeded() const { return load_callee_needed_; }
+
+  bool needs_heap_scope() const { return needs_heap_scope_; }
+
+  bool IsArgumentsRealized() const { return arguments_realized_; }
 
   const HeapVariables& heap() const { return heap_; }
 
@@ -346,15 +333,15 @@ class CodeScope<Code::FUNCTION> : public VariableScope {
 
   int32_t mutable_start() const { return mutable_start_; }
 
-  const Scope* scope() const { return scope_; }
-
  private:
-  const Scope* scope_;
-  const FunctionLiteral* literal_;
   VariableMap map_;
   HeapVariables heap_;
   uint32_t stack_size_;
   bool is_eval_decl_;
+  bool needs_heap_scope_;
+  bool arguments_realized_;
+  bool direct_call_to_eval_;
+  bool load_callee_needed_;
   int32_t mutable_start_;
 };
 
@@ -82,6 +82,9 @@ inline JSVal VM::RunEval(Code* code,
 }
 
 inline JSVal VM::Execute(Arguments* args, JSVMFunction* func, Error* e) {
+  if (func->code()->lazy()) {
+    CompileLazyCode(ctx(), func->code());
+  }
   Frame* frame = stack_.NewCodeFrame(
       ctx(),
       args->ExtractBase(),
@@ -106,6 +109,36 @@ inline JSVal VM::Execute(Arguments* args, JSVMFunction* func, Error* e) {
   return res;
 }
 
+inline bool VM::CountHotCode(Code* code) {
+  if (code->IncrementHotCodeCounter() == ctx()->tier_up_threshold()) {
+    ctx()->TierUp(code);
+  }
+  return code->executable();
+}
+
+inline void VM::RecordCallee(Instruction* instr, JSFunction* func) {
+  // opcode | (callee | offset | argc_with_this) | feedback
+  JSFunction* const feedback = instr[2].callee;
+  if (feedback != func && feedback != Instruction::PolymorphicCallee()) {
+    instr[2].callee = feedback ? Instruction::PolymorphicCallee() : func;
+  }
+}
+
+inline JSVal VM::LoadPropPolymorphic(Instruction* instr,
+                                     JSVal base, Symbol name, Error* e) {
+  // opcode | (dst | base | name) | ic | nop | nop
+  PolyIC::Entry entry;
+  const JSVal res = LoadProp(base, name, &entry, IV_LV5_ERROR(e));
+  if (entry.map &&
+      !instr[2].poly_ic->Store(entry.map, entry.prototype, entry.offset)) {
+    // too many maps, so make this site megamorphic
+    instr[0] = Instruction::GetOPInstruction(OP::LOAD_PROP_MEGAMORPHIC);
+    instr[2].poly_ic = nullptr;
+    megamorphic_cache_.Store(entry.map, name, entry.prototype, entry.offset);
+  }
+  return res;
+}
+
 inline JSVal VM::Execute(Frame* start, Error* e) {
 #if defined(IV_LV5_RAILGUN_USE_DIRECT_THREADED_CODE)
   if (!start) {
@@ -127,9 +160,26 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
   Frame* frame = start;
   Instruction* instr = frame->data();
   bool strict = frame->code()->strict();
+  // hot code is counted only in tiered execution
+  const bool tiered = ctx()->IsTiered();
 
 #define INCREMENT_NEXT(op) (instr += OPLength<OP::op>::value)
 
+#define PROFILE_OPCODE(op)\
+  if (profiler_.enabled()) {\
+    profiler_.Record(op, frame->code());\
+  }
+
+#define PROFILE_LOAD_PROP(result)\
+  if (profiler_.enabled()) {\
+    profiler_.RecordLoadProp(Profiler::result);\
+  }
+
+#define PROFILE_STORE_PROP(result)\
+  if (profiler_.enabled()) {\
+    profiler_.RecordStoreProp(Profiler::result);\
+  }
+
 #ifdef IV_LV5_RAILGUN_USE_DIRECT_THREADED_CODE
 // direct threading mode
 
@@ -137,11 +187,13 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
 #define DEFINE_OPCODE(op)\
   case OP::op:\
   op:\
-    statistics_.Increment(OP::op);
+    statistics_.Increment(OP::op);\
+    PROFILE_OPCODE(OP::op)
 #else
 #define DEFINE_OPCODE(op)\
   case OP::op:\
-  op:
+  op:\
+    PROFILE_OPCODE(OP::op)
 #endif  // ifdef DEBUG
 
 #define DISPATCH_ERROR() break
@@ -210,7 +262,18 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
 #undef DUMMY
 
 #define JUMPTO(x) (instr = frame->data() + (x))
-#define JUMPBY(x) (instr += (x))
+// backward jump is loop back edge, so it is counted in tiered execution.
+// if code is already compiled and has OSR entries,
+// try to enter native code at loop header
+#define JUMPBY(x)\
+  do {\
+    const int32_t jump_offset = (x);\
+    instr += jump_offset;\
+    if (tiered && jump_offset < 0 &&\
+        CountHotCode(frame->code()) && frame->code()->HasOSREntry()) {\
+      goto ON_STACK_REPLACEMENT;\
+    }\
+  } while (0)
 
 #define REG(n)\
   (reinterpret_cast<JSVal*>(frame)[FrameConstant<>::kFrameSize + (n)])
@@ -262,6 +325,69 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
   JUMPBY(instr[1].jump.to);\
   DISPATCH_WITH_NO_INCREMENT();
 
+// opcode macros shared with superinstructions
+
+#define FAST_PATH_BINARY_SUBTRACT()\
+  const JSVal lhs = REG(instr[1].i16[1]);\
+  const JSVal rhs = REG(instr[1].i16[2]);\
+  if (lhs.IsInt32() && rhs.IsInt32()) {\
+    int32_t dif;\
+    if (!core::math::IsSubtractOverflow(lhs.int32(), rhs.int32(), &dif)) {\
+      REG(instr[1].i16[0]) = JSVal::Int32(dif);\
+    } else {\
+      REG(instr[1].i16[0]) =\
+          JSVal(static_cast<double>(lhs.int32()) -\
+                static_cast<double>(rhs.int32()));\
+    }\
+  } else {\
+    const JSVal res = BinarySub(lhs, rhs, ERR);\
+    REG(instr[1].i16[0]) = res;\
+  }\
+  DISPATCH(BINARY_SUBTRACT);
+
+#define FAST_PATH_IF_FALSE_BINARY_LT()\
+  const JSVal lhs = REG(instr[1].jump.i16[0]);\
+  const JSVal rhs = REG(instr[1].jump.i16[1]);\
+  if (lhs.IsInt32() && rhs.IsInt32()) {\
+    if (lhs.int32() >= rhs.int32()) {\
+      JUMPBY(instr[1].jump.to);\
+      DISPATCH_WITH_NO_INCREMENT();\
+    }\
+  } else {\
+    const bool res = BinaryCompareLT(lhs, rhs, ERR);\
+    if (!res) {\
+      JUMPBY(instr[1].jump.to);\
+      DISPATCH_WITH_NO_INCREMENT();\
+    }\
+  }\
+  DISPATCH(IF_FALSE_BINARY_LT);
+
+#define FAST_PATH_RETURN() FAST_PATH_RETURN_VALUE(REG(instr[1].i32[0]))
+
+#define FAST_PATH_RETURN_VALUE(value)\
+  JSVal src = (value);\
+  if (frame->constructor_call_) {\
+    static_cast<JSFunction*>(frame->callee().object())\
+        ->RecordConstructSlots(frame->GetThis().object());\
+    if (!src.IsObject()) {\
+      src = frame->GetThis();\
+    }\
+  }\
+  /* if previous code is not native code, unwind frame and jump */\
+  if (frame->prev_pc_ == nullptr) {\
+    /* this code is invoked by native function */\
+    return src;\
+  }\
+  /* this code is invoked by JS code (EVAL / CALL / CONSTRUCT) */\
+  instr = frame->prev_pc_;\
+  /* because of Frame is code frame, first lexical_env is variable_env. */\
+  /* (if Eval / Global, this is not valid) */\
+  assert(frame->lexical_env() == frame->variable_env());\
+  frame = stack_.Unwind(frame);\
+  strict = frame->code()->strict();\
+  ctx()->RAX() = src;\
+  DISPATCH_WITH_NO_INCREMENT();
+
   // main loop
   for (;;) {
 #if defined(IV_LV5_RAILGUN_USE_DIRECT_THREADED_CODE)
@@ -270,6 +396,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
 #undef DISPATCH_ERROR
 #define DISPATCH_ERROR() goto VM_ERROR
  MAIN_LOOP_START:
+    PROFILE_OPCODE(static_cast<OP::Type>(instr->u32[0]))
     // 5 top opcode fast pathes
     // see detail https://github.com/Constellation/iv/issues/63
     if (instr->u32[0] == OP::LOAD_CONST) {
@@ -322,34 +449,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
 
       DEFINE_OPCODE(RETURN) {
         // opcode | src
-        JSVal src = REG(instr[1].i32[0]);
-        if (frame->constructor_call_ && !src.IsObject()) {
-          src = frame->GetThis();
-        }
-
-
-        // no return at last
-        // return undefined
-        // if previous code is not native code, unwind frame and jump
-        if (frame->prev_pc_ == nullptr) {
-          // this code is invoked by native function
-          return src;
-        }
-        // this code is invoked by JS code
-        // EVAL / CALL / CONSTRUCT
-
-        instr = frame->prev_pc_;
-
-        // because of Frame is code frame,
-        // first lexical_env is variable_env.
-        // (if Eval / Global, this is not valid)
-        assert(frame->lexical_env() == frame->variable_env());
-
-        frame = stack_.Unwind(frame);
-        strict = frame->code()->strict();
-
-        ctx()->RAX()  = src;
-        DISPATCH_WITH_NO_INCREMENT();
+        FAST_PATH_RETURN();
       }
 
       DEFINE_OPCODE(BUILD_ENV) {
@@ -493,6 +593,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         // opcode | (dst | base | name) | nop | nop | nop
         const Symbol name = frame->GetName(instr[1].ssw.u32);
         const JSVal base = REG(instr[1].ssw.i16[1]);
+        PROFILE_LOAD_PROP(IC_MISS)
         const JSVal res =
             LoadProp<
               OP::LOAD_PROP_OWN,
@@ -513,6 +614,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
           JSVal res;
           const Symbol name = frame->GetName(instr[1].ssw.u32);
           if (GetPrimitiveOwnProperty(base, name, &res)) {
+            PROFILE_LOAD_PROP(IC_HIT)
             REG(instr[1].ssw.i16[0]) = res;
             DISPATCH(LOAD_PROP_OWN);
           } else {
@@ -524,20 +626,19 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         assert(obj);
         if (instr[2].map == obj->map()) {
           // cache hit
+          PROFILE_LOAD_PROP(IC_HIT)
           REG(instr[1].ssw.i16[0]) = obj->Direct(instr[3].u32[0]);
           DISPATCH(LOAD_PROP_OWN);
         } else {
-          // not found => uncache
-          Slot slot;
+          // miss => polymorphic
+          PROFILE_LOAD_PROP(IC_MISS)
           const Symbol name = frame->GetName(instr[1].ssw.u32);
-          if (obj->GetPropertySlot(ctx(), name, &slot)) {
-            instr[0] = Instruction::GetOPInstruction(OP::LOAD_PROP);
-            const JSVal ret = slot.Get(ctx(), obj, ERR);
-            REG(instr[1].ssw.i16[0]) = ret;
-          } else {
-            instr[0] = Instruction::GetOPInstruction(OP::LOAD_PROP);
-            REG(instr[1].ssw.i16[0]) = JSUndefined;
-          }
+          PolyIC* ic = new PolyIC();
+          ic->Store(instr[2].map, nullptr, instr[3].u32[0]);
+          instr[0] = Instruction::GetOPInstruction(OP::LOAD_PROP_POLY);
+          instr[2].poly_ic = ic;
+          const JSVal res = LoadPropPolymorphic(instr, base, name, ERR);
+          REG(instr[1].ssw.i16[0]) = res;
         }
         DISPATCH(LOAD_PROP_OWN);
       }
@@ -552,6 +653,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
           JSVal res;
           const Symbol name = frame->GetName(instr[1].ssw.u32);
           if (GetPrimitiveOwnProperty(base, name, &res)) {
+            PROFILE_LOAD_PROP(IC_HIT)
             REG(instr[1].ssw.i16[0]) = res;
             DISPATCH(LOAD_PROP_PROTO);
           } else {
@@ -563,12 +665,17 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         JSObject* proto = obj->prototype();
         if (instr[2].map == obj->map() && proto->map() == instr[3].map) {
           // cache hit
+          PROFILE_LOAD_PROP(IC_HIT)
           REG(instr[1].ssw.i16[0]) = proto->Direct(instr[4].u32[0]);
         } else {
-          // uncache
+          // miss => polymorphic
+          PROFILE_LOAD_PROP(IC_MISS)
           const Symbol name = frame->GetName(instr[1].ssw.u32);
-          instr[0] = Instruction::GetOPInstruction(OP::LOAD_PROP);
-          const JSVal res = LoadProp(base, name, strict, ERR);
+          PolyIC* ic = new PolyIC();
+          ic->Store(instr[2].map, instr[3].map, instr[4].u32[0]);
+          instr[0] = Instruction::GetOPInstruction(OP::LOAD_PROP_POLY);
+          instr[2].poly_ic = ic;
+          const JSVal res = LoadPropPolymorphic(instr, base, name, ERR);
           REG(instr[1].ssw.i16[0]) = res;
         }
         DISPATCH(LOAD_PROP_PROTO);
@@ -584,6 +691,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
           JSVal res;
           const Symbol name = frame->GetName(instr[1].ssw.u32);
           if (GetPrimitiveOwnProperty(base, name, &res)) {
+            PROFILE_LOAD_PROP(IC_HIT)
             REG(instr[1].ssw.i16[0]) = res;
             DISPATCH(LOAD_PROP_CHAIN);
           } else {
@@ -594,9 +702,11 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         }
         if (JSObject* cached = instr[2].chain->Validate(obj, instr[3].map)) {
           // cache hit
+          PROFILE_LOAD_PROP(IC_HIT)
           REG(instr[1].ssw.i16[0]) = cached->Direct(instr[4].u32[0]);
         } else {
           // uncache
+          PROFILE_LOAD_PROP(IC_MISS)
           const Symbol name = frame->GetName(instr[1].ssw.u32);
           instr[0] = Instruction::GetOPInstruction(OP::LOAD_PROP);
           const JSVal res = LoadProp(base, name, strict, ERR);
@@ -605,10 +715,80 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         DISPATCH(LOAD_PROP_CHAIN);
       }
 
+      DEFINE_OPCODE(LOAD_PROP_POLY) {
+        // opcode | (dst | base | name) | ic | nop | nop
+        const JSVal base = REG(instr[1].ssw.i16[1]);
+        base.CheckObjectCoercible(ERR);
+        JSObject* obj = nullptr;
+        if (base.IsPrimitive()) {
+          // primitive prototype cache
+          JSVal res;
+          const Symbol name = frame->GetName(instr[1].ssw.u32);
+          if (GetPrimitiveOwnProperty(base, name, &res)) {
+            PROFILE_LOAD_PROP(IC_HIT)
+            REG(instr[1].ssw.i16[0]) = res;
+            DISPATCH(LOAD_PROP_POLY);
+          } else {
+            obj = base.GetPrimitiveProto(ctx());
+          }
+        } else {
+          obj = base.object();
+        }
+        JSVal res;
+        if (instr[2].poly_ic->Load(obj, &res)) {
+          // cache hit
+          PROFILE_LOAD_PROP(IC_HIT)
+          REG(instr[1].ssw.i16[0]) = res;
+        } else {
+          PROFILE_LOAD_PROP(IC_MISS)
+          const Symbol name = frame->GetName(instr[1].ssw.u32);
+          res = LoadPropPolymorphic(instr, base, name, ERR);
+          REG(instr[1].ssw.i16[0]) = res;
+        }
+        DISPATCH(LOAD_PROP_POLY);
+      }
+
+      DEFINE_OPCODE(LOAD_PROP_MEGAMORPHIC) {
+        // opcode | (dst | base | name) | nop | nop | nop
+        const JSVal base = REG(instr[1].ssw.i16[1]);
+        const Symbol name = frame->GetName(instr[1].ssw.u32);
+        base.CheckObjectCoercible(ERR);
+        JSObject* obj = nullptr;
+        JSVal res;
+        if (base.IsPrimitive()) {
+          // primitive prototype cache
+          if (GetPrimitiveOwnProperty(base, name, &res)) {
+            PROFILE_LOAD_PROP(IC_HIT)
+            REG(instr[1].ssw.i16[0]) = res;
+            DISPATCH(LOAD_PROP_MEGAMORPHIC);
+          } else {
+            obj = base.GetPrimitiveProto(ctx());
+          }
+        } else {
+          obj = base.object();
+        }
+        if (megamorphic_cache_.Load(obj, name, &res)) {
+          // cache hit
+          PROFILE_LOAD_PROP(IC_HIT)
+          REG(instr[1].ssw.i16[0]) = res;
+        } else {
+          PROFILE_LOAD_PROP(IC_MISS)
+          PolyIC::Entry entry;
+          res = LoadProp(base, name, &entry, ERR);
+          if (entry.map) {
+            megamorphic_cache_.Store(
+                entry.map, name, entry.prototype, entry.offset);
+          }
+          REG(instr[1].ssw.i16[0]) = res;
+        }
+        DISPATCH(LOAD_PROP_MEGAMORPHIC);
+      }
+
       DEFINE_OPCODE(LOAD_PROP_GENERIC) {
         // opcode | (dst | base | name) | nop | nop | nop
         const JSVal base = REG(instr[1].ssw.i16[1]);
         const Symbol name = frame->GetName(instr[1].ssw.u32);
+        PROFILE_LOAD_PROP(IC_GENERIC)
         const JSVal res = LoadProp(base, name, strict, ERR);
         REG(instr[1].ssw.i16[0]) = res;
         DISPATCH(LOAD_PROP_GENERIC);
@@ -683,6 +863,11 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         const JSVal base = REG(instr[1].ssw.i16[0]);
         const Symbol name = frame->GetName(instr[1].ssw.u32);
         const JSVal src = REG(instr[1].ssw.i16[1]);
+        if (profiler_.enabled()) {
+          profiler_.RecordStoreProp(
+              (base.IsObject() && instr[2].map == base.object()->map()) ?
+              Profiler::IC_HIT : Profiler::IC_MISS);
+        }
         StoreProp(base, instr, OP::STORE_PROP_GENERIC, name, src, strict, ERR);
         DISPATCH(STORE_PROP);
       }
@@ -692,6 +877,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         const JSVal base = REG(instr[1].ssw.i16[0]);
         const Symbol name = frame->GetName(instr[1].ssw.u32);
         const JSVal src = REG(instr[1].ssw.i16[1]);
+        PROFILE_STORE_PROP(IC_GENERIC)
         StoreProp(base, name, src, strict, ERR);
         DISPATCH(STORE_PROP_GENERIC);
       }
@@ -780,21 +966,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
 
       DEFINE_OPCODE(IF_FALSE_BINARY_LT) {
         // opcode | (jmp | lhs | rhs)
-        const JSVal lhs = REG(instr[1].jump.i16[0]);
-        const JSVal rhs = REG(instr[1].jump.i16[1]);
-        if (lhs.IsInt32() && rhs.IsInt32()) {
-          if (lhs.int32() >= rhs.int32()) {
-            JUMPBY(instr[1].jump.to);
-            DISPATCH_WITH_NO_INCREMENT();
-          }
-        } else {
-          const bool res = BinaryCompareLT(lhs, rhs, ERR);
-          if (!res) {
-            JUMPBY(instr[1].jump.to);
-            DISPATCH_WITH_NO_INCREMENT();
-          }
-        }
-        DISPATCH(IF_FALSE_BINARY_LT);
+        FAST_PATH_IF_FALSE_BINARY_LT();
       }
 
       DEFINE_OPCODE(IF_TRUE_BINARY_LT) {
@@ -1483,22 +1655,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
 
       DEFINE_OPCODE(BINARY_SUBTRACT) {
         // opcode | (dst | lhs | rhs)
-        const JSVal lhs = REG(instr[1].i16[1]);
-        const JSVal rhs = REG(instr[1].i16[2]);
-        if (lhs.IsInt32() && rhs.IsInt32()) {
-          int32_t dif;
-          if (!core::math::IsSubtractOverflow(lhs.int32(), rhs.int32(), &dif)) {
-            REG(instr[1].i16[0]) = JSVal::Int32(dif);
-          } else {
-            REG(instr[1].i16[0]) =
-                JSVal(static_cast<double>(lhs.int32()) -
-                      static_cast<double>(rhs.int32()));
-          }
-        } else {
-          const JSVal res = BinarySub(lhs, rhs, ERR);
-          REG(instr[1].i16[0]) = res;
-        }
-        DISPATCH(BINARY_SUBTRACT);
+        FAST_PATH_BINARY_SUBTRACT();
       }
 
       DEFINE_OPCODE(BINARY_MULTIPLY) {
@@ -1920,7 +2077,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         // opcode | (dst | code)
         Code* target = frame->code()->codes()[instr[1].ssw.u32];
         REG(instr[1].ssw.i16[0]) =
-            JSVMFunction::New(ctx(), target, frame->lexical_env());
+            ctx()->NewFunction(target, frame->lexical_env());
         DISPATCH(LOAD_FUNCTION);
       }
 
@@ -2009,7 +2166,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
       }
 
       DEFINE_OPCODE(CALL) {
-        // opcode | (callee | offset | argc_with_this)
+        // opcode | (callee | offset | argc_with_this) | feedback
         const JSVal callee = REG(instr[1].ssw.i16[0]);
         JSVal* offset = &REG(instr[1].ssw.i16[1]);
         const uint32_t argc_with_this = instr[1].ssw.u32;
@@ -2019,14 +2176,23 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         }
         JSFunction* func =
             static_cast<JSFunction*>(callee.object());
+        RecordCallee(instr, func);
         if (func->function_type() == JSFunction::FUNCTION_USER) {
           // inline call
           JSVMFunction* vm_func = static_cast<JSVMFunction*>(func);
           Code* code = vm_func->code();
+          if (code->lazy()) {
+            CompileLazyCode(ctx(), code);
+          }
           if (code->empty()) {
             ctx()->RAX() = JSUndefined;
             DISPATCH(CALL);
           }
+          if (tiered && CountHotCode(code)) {
+            // compiled to native code in tiered execution
+            ctx()->RAX() = Invoke(func, offset, argc_with_this, ERR);
+            DISPATCH(CALL);
+          }
           Frame* new_frame = stack_.NewCodeFrame(
               ctx(),
               offset,
@@ -2064,6 +2230,14 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
           // inline call
           JSVMFunction* vm_func = static_cast<JSVMFunction*>(func);
           Code* code = vm_func->code();
+          if (code->lazy()) {
+            CompileLazyCode(ctx(), code);
+          }
+          if (tiered && CountHotCode(code)) {
+            // compiled to native code in tiered execution
+            ctx()->RAX() = Construct(func, offset, argc_with_this, ERR);
+            DISPATCH(CONSTRUCT);
+          }
           Frame* new_frame = stack_.NewCodeFrame(
               ctx(),
               offset,
@@ -2079,8 +2253,7 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
           frame = new_frame;
           instr = frame->data();
           strict = code->strict();
-          Map* map = func->construct_map(ctx(), ERR);
-          JSObject* const obj = JSObject::New(ctx(), map);
+          JSObject* const obj = func->NewConstructObject(ctx(), ERR);
           frame->set_this_binding(obj);
           DISPATCH_WITH_NO_INCREMENT();
         }
@@ -2106,10 +2279,18 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
           // inline call
           JSVMFunction* vm_func = static_cast<JSVMFunction*>(func);
           Code* code = vm_func->code();
+          if (code->lazy()) {
+            CompileLazyCode(ctx(), code);
+          }
           if (code->empty()) {
             ctx()->RAX() = JSUndefined;
             DISPATCH(EVAL);
           }
+          if (tiered && CountHotCode(code)) {
+            // compiled to native code in tiered execution
+            ctx()->RAX() = InvokeMaybeEval(func, offset, argc_with_this, frame, ERR);
+            DISPATCH(EVAL);
+          }
           Frame* new_frame = stack_.NewCodeFrame(
               ctx(),
               offset,
@@ -2158,6 +2339,74 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
         DISPATCH(PREPARE_DYNAMIC_CALL);
       }
 
+      // superinstructions
+      // execute first opcode, step to second opcode and execute it inline.
+      // second opcode is left in instruction stream, so jumps to it and
+      // errors raised from it work as is
+
+      DEFINE_OPCODE(LOAD_CONST_BINARY_ADD) {
+        // opcode | (dst | offset)
+        REG(instr[1].ssw.i16[0]) = frame->GetConstant(instr[1].ssw.u32);
+        INCREMENT_NEXT(LOAD_CONST_BINARY_ADD);
+        FAST_PATH_BINARY_ADD();
+      }
+
+      DEFINE_OPCODE(LOAD_CONST_BINARY_SUBTRACT) {
+        // opcode | (dst | offset)
+        REG(instr[1].ssw.i16[0]) = frame->GetConstant(instr[1].ssw.u32);
+        INCREMENT_NEXT(LOAD_CONST_BINARY_SUBTRACT);
+        FAST_PATH_BINARY_SUBTRACT();
+      }
+
+      DEFINE_OPCODE(LOAD_CONST_IF_FALSE_BINARY_LT) {
+        // opcode | (dst | offset)
+        REG(instr[1].ssw.i16[0]) = frame->GetConstant(instr[1].ssw.u32);
+        INCREMENT_NEXT(LOAD_CONST_IF_FALSE_BINARY_LT);
+        FAST_PATH_IF_FALSE_BINARY_LT();
+      }
+
+      DEFINE_OPCODE(BINARY_ADD_RETURN) {
+        // opcode | (dst | lhs | rhs)
+        const JSVal lhs = REG(instr[1].i16[1]);
+        const JSVal rhs = REG(instr[1].i16[2]);
+        if (lhs.IsInt32() && rhs.IsInt32()) {
+          int32_t sum;
+          if (!core::math::IsAdditionOverflow(lhs.int32(), rhs.int32(), &sum)) {
+            REG(instr[1].i16[0]) = JSVal::Int32(sum);
+          } else {
+            REG(instr[1].i16[0]) =
+                JSVal(static_cast<double>(lhs.int32()) +
+                      static_cast<double>(rhs.int32()));
+          }
+        } else {
+          const JSVal res = BinaryAdd(lhs, rhs, ERR);
+          REG(instr[1].i16[0]) = res;
+        }
+        INCREMENT_NEXT(BINARY_ADD_RETURN);
+        FAST_PATH_RETURN();
+      }
+
+      DEFINE_OPCODE(MV_RETURN) {
+        // opcode | (dst | src)
+        REG(instr[1].i16[0]) = REG(instr[1].i16[1]);
+        INCREMENT_NEXT(MV_RETURN);
+        FAST_PATH_RETURN();
+      }
+
+      ON_STACK_REPLACEMENT: {
+        // instr is loop header of compiled code.
+        // if native code has entry of this loop header,
+        // rest of this frame is executed by native code
+        JSVal res;
+        if (!ctx()->OnStackReplace(frame, instr, &res, e)) {
+          GO_MAIN_LOOP();
+        }
+        if (*e) {
+          DISPATCH_ERROR();
+        }
+        FAST_PATH_RETURN_VALUE(res);
+      }
+
       default: {
         std::printf("%s\n", OP::String(instr->u32[0]));
         UNREACHABLE();
@@ -2239,6 +2488,9 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
   assert(*e);
   return JSEmpty;
 #undef INCREMENT_NEXT
+#undef PROFILE_OPCODE
+#undef PROFILE_LOAD_PROP
+#undef PROFILE_STORE_PROP
 #undef DISPATCH_ERROR
 #undef DISPATCH
 #undef DISPATCH_WITH_NO_INCREMENT
@@ -2253,6 +2505,10 @@ inline JSVal VM::Execute(Frame* start, Error* e) {
 #undef FAST_PATH_BINARY_LT
 #undef FAST_PATH_BINARY_ADD
 #undef FAST_PATH_JUMP_BY
+#undef FAST_PATH_BINARY_SUBTRACT
+#undef FAST_PATH_IF_FALSE_BINARY_LT
+#undef FAST_PATH_RETURN
+#undef FAST_PATH_RETURN_VALUE
 
 }  // NOLINT
 
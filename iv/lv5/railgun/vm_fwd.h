@@ -8,6 +8,7 @@
 #include <iv/lv5/railgun/stack.h>
 #include <iv/lv5/railgun/direct_threading.h>
 #include <iv/lv5/railgun/statistics.h>
+#include <iv/lv5/railgun/profiler.h>
 #include <iv/lv5/breaker/fwd.h>
 namespace iv {
 namespace lv5 {
@@ -30,11 +31,23 @@ class VM : private Operation {
 
   JSVal Execute(Arguments* args, JSVMFunction* func, Error* e);
 
+  // count invocation or backward jump of code for tiered execution,
+  // and tier up code when it becomes hot.
+  // returns true if code is compiled to native code
+  bool CountHotCode(Code* code);
+
   // normal pass
   explicit VM(lv5::Context* ctx)
     : Operation(ctx),
       stack_(),
-      statistics_() {
+      statistics_(),
+      profiler_(),
+      megamorphic_cache_() {
+#if defined(IV_LV5_RAILGUN_USE_DIRECT_THREADED_CODE)
+    // label table is used while marking CoreData, so create it before GC.
+    // creating it in GC allocates memory and reenters GC
+    LabelTable();
+#endif
   }
 
   template<OP::Type op>
@@ -58,6 +71,14 @@ class VM : private Operation {
     statistics_.Dump();
   }
 
+  Profiler* profiler() {
+    return &profiler_;
+  }
+
+  const Profiler* profiler() const {
+    return &profiler_;
+  }
+
   static std::size_t StackOffset() {
     return IV_OFFSETOF(VM, stack_);
   }
@@ -68,6 +89,7 @@ class VM : private Operation {
   explicit VM(DispatchTableTag tag)
     : Operation(nullptr),
       stack_(tag),
+      megamorphic_cache_(),
       direct_threading_dispatch_table_(nullptr) {
     Execute(nullptr, nullptr);
   }
@@ -109,6 +131,14 @@ class VM : private Operation {
   // VM main routine
   JSVal Execute(Frame* frame, Error* e);
 
+  // load property through polymorphic caches of LOAD_PROP_POLY site,
+  // and make site megamorphic if PolyIC is full
+  JSVal LoadPropPolymorphic(Instruction* instr,
+                            JSVal base, Symbol name, Error* e);
+
+  // record callee of CALL site, which is used by breaker inlining
+  static void RecordCallee(Instruction* instr, JSFunction* func);
+
   static void VerifyDynamicEnvironment(Frame* frame) {
     JSEnv* env = frame->lexical_env()->outer();
     for (; env; env = env->outer()) {
@@ -121,6 +151,8 @@ class VM : private Operation {
 
   Stack stack_;
   Statistics statistics_;
+  Profiler profiler_;
+  MegamorphicCache megamorphic_cache_;
 
 #if defined(IV_LV5_RAILGUN_USE_DIRECT_THREADED_CODE)
   const DirectThreadingDispatchTable* direct_threading_dispatch_table_;
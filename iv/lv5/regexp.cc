@@ -1,38 +1,40 @@
 #include <cstdlib>
 #include <cstring>
+#include <string>
 #include <iv/ustring.h>
 #include <iv/string_view.h>
 #include <iv/space.h>
 #include <iv/aero/aero.h>
 #include <iv/lv5/context.h>
 #include <iv/lv5/regexp.h>
+#include <iv/lv5/regexp_code_cache.h>
 #include <iv/lv5/property.h>
 namespace iv {
 namespace lv5 {
 
 static const std::u16string kEmptyPattern = core::ToU16String("(?:)");
 
-RegExp::RegExp(core::Space* allocator,
+RegExp::RegExp(Context* ctx,
                const core::u16string_view& value, int flags)
   : flags_(flags),
     error_(0),
     code_() {
-  Initialize(allocator, value);
+  Initialize(ctx, value);
 }
 
-RegExp::RegExp(core::Space* allocator,
+RegExp::RegExp(Context* ctx,
                const core::string_view& value, int flags)
   : flags_(flags),
     error_(0),
     code_() {
-  Initialize(allocator, value);
+  Initialize(ctx, value);
 }
 
-RegExp::RegExp(core::Space* allocator)
+RegExp::RegExp(Context* ctx)
   : flags_(NONE),
     error_(0),
     code_() {
-  Initialize(allocator, kEmptyPattern);
+  Initialize(ctx, kEmptyPattern);
 }
 
 RegExp::~RegExp() { }
@@ -57,12 +59,23 @@ int RegExp::Execute(Context* ctx,
 }
 
 template<typename Source>
-void RegExp::Initialize(core::Space* allocator, const Source& value) {
+void RegExp::Initialize(Context* ctx, const Source& value) {
   if (flags_ != -1) {
     const int f =
         ((flags_ & MULTILINE) ? aero::MULTILINE : aero::NONE) |
         ((flags_ & IGNORE_CASE) ? aero::IGNORE_CASE : aero::NONE);
-    code_.reset(aero::Compile(allocator, value, f, &error_));
+    // global flag does not affect code, so it is not a part of the key
+    RegExpCodeCache* cache = ctx->global_data()->regexp_code_cache();
+    const RegExpCodeCache::Key key(
+        std::u16string(value.begin(), value.end()), f);
+    code_ = cache->Lookup(key);
+    if (code_) {
+      return;
+    }
+    code_.reset(aero::Compile(ctx->regexp_allocator(), value, f, &error_));
+    if (code_) {
+      cache->Insert(key, code_);
+    }
   }
 }
 
@@ -26,13 +26,13 @@ class RegExp : public gc_cleanup {
     STICKY = 8
   };
 
-  explicit RegExp(core::Space* allocator);
+  explicit RegExp(Context* ctx);
 
   ~RegExp();
 
-  RegExp(core::Space* allocator, const core::u16string_view& value, int flags);
+  RegExp(Context* ctx, const core::u16string_view& value, int flags);
 
-  RegExp(core::Space* allocator, const core::string_view& value, int flags);
+  RegExp(Context* ctx, const core::string_view& value, int flags);
 
   bool IsValid() const { return !!code_; }
 
@@ -92,11 +92,12 @@ class RegExp : public gc_cleanup {
 
  private:
   template<typename Source>
-  void Initialize(core::Space* allocator, const Source& value);
+  void Initialize(Context* ctx, const Source& value);
 
   int flags_;
   int error_;
-  std::unique_ptr<aero::Code> code_;
+  // shared with other RegExp instances through RegExpCodeCache
+  std::shared_ptr<aero::Code> code_;
 };
 
 } }  // namespace iv::lv5
@@ -0,0 +1,104 @@
+// RegExpCodeCache
+//
+// compiled aero::Code is shared between RegExp instances which have the
+// same pattern and flags. entries are evicted in least recently used order.
+#ifndef IV_LV5_REGEXP_CODE_CACHE_H_
+#define IV_LV5_REGEXP_CODE_CACHE_H_
+#include <cassert>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <iv/detail/cstdint.h>
+#include <iv/detail/unordered_map.h>
+#include <iv/noncopyable.h>
+#include <iv/conversions.h>
+#include <iv/string_view.h>
+namespace iv {
+
+namespace aero {
+class Code;
+}  // namespace aero
+
+namespace lv5 {
+
+class RegExpCodeCache : private core::Noncopyable<RegExpCodeCache> {
+ public:
+  // pattern and aero flags
+  typedef std::pair<std::u16string, int> Key;
+
+  struct KeyHasher {
+    std::size_t operator()(const Key& key) const {
+      return core::Hash::StringToHash(core::u16string_view(key.first)) ^
+          static_cast<std::size_t>(key.second);
+    }
+  };
+
+  typedef std::list<Key> HistoryList;
+  typedef std::pair<std::shared_ptr<aero::Code>,
+                    HistoryList::iterator> Entry;
+  typedef std::unordered_map<Key, Entry, KeyHasher> CodeMap;
+
+  static const std::size_t kDefaultMaxSize = 64;
+
+  explicit RegExpCodeCache(std::size_t max = kDefaultMaxSize)
+    : max_(max),
+      list_(),
+      map_(),
+      hits_(0),
+      misses_(0) {
+  }
+
+  std::shared_ptr<aero::Code> Lookup(const Key& key) {
+    const CodeMap::iterator it = map_.find(key);
+    if (it == map_.end()) {
+      ++misses_;
+      return std::shared_ptr<aero::Code>();
+    }
+    ++hits_;
+    list_.splice(list_.end(), list_, it->second.second);
+    return it->second.first;
+  }
+
+  void Insert(const Key& key, std::shared_ptr<aero::Code> code) {
+    assert(code);
+    assert(map_.find(key) == map_.end());
+    if (max_ == 0) {
+      return;
+    }
+
+    if (list_.size() == max_) {
+      // remove LRU entry
+      const CodeMap::iterator it = map_.find(list_.front());
+      assert(it != map_.end());
+      map_.erase(it);
+      list_.pop_front();
+    }
+
+    const HistoryList::iterator it = list_.insert(list_.end(), key);
+    map_.insert(std::make_pair(key, Entry(code, it)));
+  }
+
+  void Clear() {
+    map_.clear();
+    list_.clear();
+  }
+
+  std::size_t size() const { return list_.size(); }
+
+  std::size_t max_size() const { return max_; }
+
+  uint64_t hits() const { return hits_; }
+
+  uint64_t misses() const { return misses_; }
+
+ private:
+  std::size_t max_;
+  HistoryList list_;
+  CodeMap map_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+} }  // namespace iv::lv5
+#endif  // IV_LV5_REGEXP_CODE_CACHE_H_
@@ -35,53 +35,6 @@ static inline bool IsTrimmed(char16_t c) {
          core::character::IsLineTerminator(c);
 }
 
-inline int64_t SplitMatch(JSString* str, uint32_t q, JSString* rhs) {
-  const std::size_t rs = rhs->size();
-  const std::size_t s = str->size();
-  if (q + rs > s) {
-    return -1;
-  }
-  if (str->Is8Bit() == rhs->Is8Bit()) {
-    // same type
-    if (str->Is8Bit()) {
-      if (std::char_traits<char>::compare(
-              rhs->Flatten8()->data(),
-              str->Flatten8()->data() + q, rs) != 0) {
-        return -1;
-      }
-    } else {
-      if (std::char_traits<char16_t>::compare(
-              rhs->Flatten16()->data(),
-              str->Flatten16()->data() + q, rs) != 0) {
-        return -1;
-      }
-    }
-  } else {
-    if (str->Is8Bit()) {
-      const JSAsciiFlatString* left = str->Flatten8();
-      const JSUTF16FlatString* right = rhs->Flatten16();
-      if (core::CompareIterators(
-              right->begin(),
-              right->begin() + rs,
-              left->begin() + q,
-              left->begin() + q + rs) != 0) {
-        return -1;
-      }
-    } else {
-      const JSUTF16FlatString* left = str->Flatten16();
-      const JSAsciiFlatString* right = rhs->Flatten8();
-      if (core::CompareIterators(
-              right->begin(),
-              right->begin() + rs,
-              left->begin() + q,
-              left->begin() + q + rs) != 0) {
-        return -1;
-      }
-    }
-  }
-  return q + rs;
-}
-
 inline JSVal StringSplit(Context* ctx,
                          JSString* target,
                          JSString* rhs, uint32_t lim, Error* e) {
@@ -98,25 +51,18 @@ inline JSVal StringSplit(Context* ctx,
   }
   const uint32_t size = target->size();
   uint32_t p = 0;
-  uint32_t q = p;
   JSVector* vec = JSVector::New(ctx);
   vec->reserve(16);
-  while (q != size) {
-    const int64_t rs = detail::SplitMatch(target, q, rhs);
-    if (rs == -1) {
-      ++q;
-    } else {
-      const uint32_t end = static_cast<uint32_t>(rs);
-      if (end == p) {
-        ++q;
-      } else {
-        vec->push_back(target->Substring(ctx, p, q));
-        if (vec->size() == lim) {
-          return vec->ToJSArray();
-        }
-        q = p = end;
-      }
+  while (true) {
+    const JSString::size_type q = target->find(*rhs, p);
+    if (q == JSString::npos) {
+      break;
     }
+    vec->push_back(target->Substring(ctx, p, q));
+    if (vec->size() == lim) {
+      return vec->ToJSArray();
+    }
+    p = q + rsize;
   }
   vec->push_back(target->Substring(ctx, p, size));
   return vec->ToJSArray();
@@ -1281,10 +1227,7 @@ JSVal StringStartsWith(const Arguments& args, Error* e) {
   if (search_string->size() + start > static_cast<uint32_t>(str->size())) {
     return JSFalse;
   }
-  const JSFlatString* flat = str->Flatten();
-  JSFlatString::const_iterator it = flat->begin() + start;
-  const JSFlatString* search = search_string->Flatten();
-  return JSVal::Bool(std::equal(search->begin(), search->end(), it));
+  return JSVal::Bool(str->StartsWith(*search_string, start));
 }
 
 // section 15.5.4.23 String.prototype.endsWith(searchString, [endPosition])
@@ -1319,10 +1262,7 @@ JSVal StringEndsWith(const Arguments& args, Error* e) {
     return JSFalse;
   }
   const std::size_t start = end - search_string->size();
-  const JSFlatString* flat = str->Flatten();
-  const JSFlatString::const_iterator it = flat->begin() + start;
-  const JSFlatString* search = search_string->Flatten();
-  return JSVal::Bool(std::equal(search->begin(), search->end(), it));
+  return JSVal::Bool(str->StartsWith(*search_string, start));
 }
 
 // section 15.5.4.24 String.prototype.contains(searchString, [position])
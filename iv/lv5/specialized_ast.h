@@ -28,9 +28,7 @@ class RegExpLiteralBase<iv::lv5::AstFactory>
     const int flags = iv::lv5::RegExp::ComputeFlags(
         Derived()->flags().begin(),
         Derived()->flags().end());
-    regexp_ = new iv::lv5::RegExp(
-        ctx->regexp_allocator(),
-        Derived()->value(), flags);
+    regexp_ = new iv::lv5::RegExp(ctx, Derived()->value(), flags);
     ctx->global_data()->RegisterLiteralRegExp(regexp_);
   }
   const iv::lv5::RegExp* regexp() const {
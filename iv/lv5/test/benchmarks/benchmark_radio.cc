@@ -0,0 +1,32 @@
+#include <memory>
+#include <iv/lv5/radio/core.h>
+#include <iv/lv5/radio/scope.h>
+#include "benchmark/benchmark.h"
+#include "../test_radio.h"
+namespace {
+
+static const int kTreeDepth = 18;
+
+}  // namespace anonymous
+
+// mark time vs. marker threads
+static void BM_RadioMarkTest(benchmark::State& state) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  const iv::lv5::radio::Scope scope(core.get());
+  core->ChainToScope(Node::Tree(core.get(), kTreeDepth));
+  core->set_marker_threads(state.range_x());
+  while (state.KeepRunning()) {
+    core->Mark(nullptr);
+    state.PauseTiming();
+    core->Collect(nullptr);
+    core->CompleteSweep();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_RadioMarkTest)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+int main(int argc, const char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include <memory>
+#include <numeric>
+#include <string>
+#include <iv/lv5/lv5.h>
+#include <iv/lv5/railgun/railgun.h>
+#include "benchmark/benchmark.h"
+namespace {
+
+static const char* kSource =
+    "function fib(n) { if (n < 2) { return n; } "
+    "return fib(n - 1) + fib(n - 2); }\n"
+    "function sum(n) { var s = 0; "
+    "for (var i = 0; i < n; i = i + 1) { s = s + 1; } return s; }\n"
+    "fib(20);\n"
+    "sum(100000);\n";
+
+}  // namespace anonymous
+
+// interpreter time and dispatch count vs. superinstructions (0: off, 1: on)
+static void BM_RailgunSuperinstructionTest(benchmark::State& state) {
+  iv::lv5::railgun::Context ctx;
+  ctx.set_superinstruction_enabled(state.range_x());
+  std::shared_ptr<iv::core::FileSource>
+      src(new iv::core::FileSource(iv::core::string_view(kSource), "bench"));
+  uint64_t dispatches = 0;
+  while (state.KeepRunning()) {
+    iv::lv5::Error::Standard e;
+    iv::lv5::railgun::ExecuteInGlobal(&ctx, src, &e);
+  }
+  // count dispatches separately, profiling slows down interpreter
+  {
+    iv::lv5::railgun::Profiler* profiler = ctx.vm()->profiler();
+    profiler->Clear();
+    profiler->Enable();
+    iv::lv5::Error::Standard e;
+    iv::lv5::railgun::ExecuteInGlobal(&ctx, src, &e);
+    profiler->Disable();
+    const iv::lv5::railgun::Profiler::Counts& counts = profiler->counts();
+    dispatches = std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+  }
+  state.SetLabel("dispatches:" + std::to_string(dispatches));
+}
+BENCHMARK(BM_RailgunSuperinstructionTest)->Arg(0)->Arg(1);
+
+int main(int argc, const char** argv) {
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
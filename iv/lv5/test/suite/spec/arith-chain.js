@@ -0,0 +1,64 @@
+describe("arithmetic", function() {
+  describe("chained operations", function() {
+    function dot(a, b, c, d) {
+      return a * b + c * d;
+    }
+
+    function poly(x) {
+      return (x * x - x) / 2 + x * 0.5;
+    }
+
+    function lerp(a, b, t) {
+      return a + (b - a) * t < b;
+    }
+
+    it("should chain int32 results", function() {
+      expect(dot(2, 3, 4, 5)).toBe(26);
+      expect(poly(4)).toBe(8);
+      expect(lerp(1, 3, 0)).toBe(true);
+    });
+
+    it("should chain double results", function() {
+      expect(dot(0.5, 3, 0.25, 4)).toBe(2.5);
+      expect(poly(0.5)).toBe(0.125);
+      expect(lerp(0.5, 1.5, 0.75)).toBe(true);
+      expect(lerp(0.5, 1.5, 1)).toBe(false);
+    });
+
+    it("should chain overflowed results", function() {
+      expect(dot(65536, 65536, 1, 1)).toBe(4294967297);
+      expect(poly(65536)).toBe(2147483648);
+      expect(dot(2147483647, 1, -2147483648, 1)).toBe(-1);
+      var big = 2147483647;
+      expect((big + big) * 0.5).toBe(big);
+    });
+
+    it("should chain -0, NaN and Infinity", function() {
+      expect(1 / dot(-0.5, 0, -0.5, 0)).toBe(-Infinity);
+      expect(isNaN(dot(NaN, 1, 1, 1))).toBe(true);
+      expect(isNaN(dot(Infinity, 1, -Infinity, 1))).toBe(true);
+      expect(isNaN(poly(Infinity))).toBe(true);
+      expect(lerp(0, Infinity, 0)).toBe(false);
+    });
+
+    it("should chain results of generic operations", function() {
+      var two = { valueOf: function() { return 2; } };
+      var half = { valueOf: function() { return 0.5; } };
+      expect(dot(two, 3, half, 4)).toBe(8);
+      expect(poly('3')).toBe(4.5);
+      expect(isNaN(dot('a', 1, 1, 1))).toBe(true);
+      expect(lerp(two, 4, half)).toBe(true);
+    });
+
+    it("should chain in loops", function() {
+      var sum = 0;
+      var acc = 0.5;
+      for (var i = 0; i < 1000; ++i) {
+        sum = sum + i * 0.5 - i / 4;
+        acc = acc * 1.5 - acc * 0.5;
+      }
+      expect(sum).toBe(124875);
+      expect(acc).toBe(0.5);
+    });
+  });
+});
@@ -0,0 +1,117 @@
+describe("Function", function() {
+  describe("inlined call", function() {
+    // caller becomes hot and is compiled with its call site inlined,
+    // subsequent calls run inlined callee
+    function hot(caller) {
+      var res;
+      for (var n = 0; n < 3; ++n) {
+        res = caller();
+      }
+      return res;
+    }
+
+    it("should fall back to generic call for non int32 values", function() {
+      function add(a, b) { return a + b; }
+      var lhs = 1, rhs = 2;
+      function caller() {
+        var res;
+        for (var i = 0; i < 2000; ++i) {
+          res = add(lhs, rhs);
+        }
+        return res;
+      }
+      expect(hot(caller)).toBe(3);
+      lhs = 2147483647; rhs = 1;
+      expect(caller()).toBe(2147483648);
+      lhs = 'a';
+      expect(caller()).toBe('a1');
+      lhs = 0.5; rhs = 0.25;
+      expect(caller()).toBe(0.75);
+    });
+
+    it("should overflow by generic call", function() {
+      function mul(a, b) { var c = a * b; return c; }
+      var lhs = 2, rhs = 3;
+      function caller() {
+        var res;
+        for (var i = 0; i < 2000; ++i) {
+          res = mul(lhs, rhs);
+        }
+        return res;
+      }
+      expect(hot(caller)).toBe(6);
+      lhs = 0; rhs = 5;
+      expect(caller()).toBe(0);
+      lhs = 65536; rhs = 65536;
+      expect(caller()).toBe(4294967296);
+    });
+
+    it("should compare values", function() {
+      function lt(a, b) { return a < b; }
+      function isUndefined(a) { return a === undefined; }
+      var lhs = 1, rhs = 2;
+      function caller() {
+        var res;
+        for (var i = 0; i < 2000; ++i) {
+          res = lt(lhs, rhs) + ':' + isUndefined(lhs);
+        }
+        return res;
+      }
+      expect(hot(caller)).toBe('true:false');
+      lhs = 3;
+      expect(caller()).toBe('false:false');
+      lhs = 'a'; rhs = 'b';
+      expect(caller()).toBe('true:false');
+      lhs = undefined;
+      expect(caller()).toBe('false:true');
+    });
+
+    it("should check callee, missing arguments and map", function() {
+      function getX(o) { return o.x; }
+      function getY(o) { return o.y; }
+      function second(a, b) { return b; }
+      var target = getX;
+      var obj = { x: 1, y: 2 };
+      function caller() {
+        var res;
+        for (var i = 0; i < 2000; ++i) {
+          res = target(obj) + ':' + second(obj.x);
+        }
+        return res;
+      }
+      expect(hot(caller)).toBe('1:undefined');
+      target = getY;
+      expect(caller()).toBe('2:undefined');
+      target = getX;
+      obj = { y: 3, x: 4 };
+      expect(caller()).toBe('4:undefined');
+      obj = 'str';
+      String.prototype.x = 5;
+      expect(caller()).toBe('5:undefined');
+      delete String.prototype.x;
+    });
+
+    it("should bind this", function() {
+      var x = 10;
+      function getThis() { return this.x; }
+      function getStrictThis() { 'use strict'; return this; }
+      var obj = { x: 1, getThis: getThis };
+      function caller() {
+        var res;
+        for (var i = 0; i < 2000; ++i) {
+          res = obj.getThis() + ':' + getStrictThis();
+        }
+        return res;
+      }
+      expect(hot(caller)).toBe('1:undefined');
+      obj = { x: 2, getThis: getThis };
+      expect(caller()).toBe('2:undefined');
+      Number.prototype.x = 3;
+      obj = 20;
+      Number.prototype.getThis = getThis;
+      expect(caller()).toBe('3:undefined');
+      delete Number.prototype.x;
+      delete Number.prototype.getThis;
+    });
+  });
+});
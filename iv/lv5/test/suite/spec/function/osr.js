@@ -0,0 +1,101 @@
+describe("Function", function() {
+  describe("on-stack replacement", function() {
+    // each function is called once, so its loop becomes hot while the frame
+    // is interpreted and the rest of the frame is executed by compiled code
+    it("should continue loop in compiled code", function() {
+      function sum(n) {
+        var res = 0;
+        for (var i = 0; i < n; ++i) {
+          res += i;
+        }
+        return res;
+      }
+      expect(sum(10000)).toBe(49995000);
+    });
+
+    it("should enter nested loops", function() {
+      function count(n) {
+        var res = 0;
+        for (var i = 0; i < n; ++i) {
+          var j = 0;
+          while (j < i) {
+            ++j;
+          }
+          res += j;
+        }
+        return res + ':' + i;
+      }
+      expect(count(200)).toBe('19900:200');
+    });
+
+    it("should return from loop", function() {
+      function find(array, value) {
+        for (var i = 0; i < array.length; ++i) {
+          if (array[i] === value) {
+            return i;
+          }
+        }
+        return -1;
+      }
+      var array = [];
+      for (var i = 0; i < 5000; ++i) {
+        array.push(i * 2);
+      }
+      expect(find(array, 8000)).toBe(4000);
+    });
+
+    it("should construct object", function() {
+      function Counter(n) {
+        this.count = 0;
+        do {
+          this.count++;
+        } while (this.count < n);
+      }
+      expect(new Counter(3000).count).toBe(3000);
+    });
+
+    it("should access heap variables", function() {
+      function closure(n) {
+        var res = 0;
+        function add(v) { res += v; }
+        for (var i = 0; i < n; ++i) {
+          add(i);
+        }
+        return res + arguments.length;
+      }
+      expect(closure(3000)).toBe(4498501);
+    });
+
+    it("should throw error to caller", function() {
+      function thrower(n) {
+        for (var i = 0; ; ++i) {
+          if (i === n) {
+            throw new Error(String(i));
+          }
+        }
+      }
+      var message;
+      try {
+        thrower(3000);
+      } catch (e) {
+        message = e.message;
+      }
+      expect(message).toBe('3000');
+    });
+
+    it("should interpret loop in code having handlers", function() {
+      function guarded(n) {
+        var res = 0;
+        for (var i = 0; i < n; ++i) {
+          try {
+            res += i;
+          } finally {
+            res += 1;
+          }
+        }
+        return res;
+      }
+      expect(guarded(3000)).toBe(4501500);
+    });
+  });
+});
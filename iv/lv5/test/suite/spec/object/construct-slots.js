@@ -0,0 +1,66 @@
+describe("Object", function() {
+  describe("constructed slots", function() {
+    function Record(n) {
+      for (var i = 0; i < n; ++i) {
+        this['p' + i] = i;
+      }
+    }
+
+    it("should not expose presized slots", function() {
+      for (var n = 0; n < 20; ++n) {
+        var obj = new Record(n);
+        expect(Object.keys(obj).length).toBe(n);
+        expect(obj['p' + n]).toBe(undefined);
+        expect(('p' + n) in obj).toBe(false);
+      }
+      for (var n = 20; n >= 0; --n) {
+        var obj = new Record(n);
+        expect(Object.keys(obj).length).toBe(n);
+        for (var i = 0; i < n; ++i) {
+          expect(obj['p' + i]).toBe(i);
+        }
+      }
+    });
+
+    it("should grow beyond predicted slots", function() {
+      function Point(x, y) {
+        this.x = x;
+        this.y = y;
+      }
+      var points = [];
+      for (var i = 0; i < 100; ++i) {
+        var p = new Point(i, i);
+        for (var j = 0; j < i % 10; ++j) {
+          p['q' + j] = j;
+        }
+        points.push(p);
+      }
+      for (var i = 0; i < 100; ++i) {
+        expect(points[i].x + points[i].y).toBe(i * 2);
+        expect(Object.keys(points[i]).length).toBe(2 + i % 10);
+      }
+    });
+
+    it("should use prototype and returned object", function() {
+      function Shape() {
+        this.a = 1; this.b = 2; this.c = 3; this.d = 4; this.e = 5;
+      }
+      Shape.prototype.sum = function() {
+        return this.a + this.b + this.c + this.d + this.e;
+      };
+      for (var i = 0; i < 10; ++i) {
+        expect(new Shape().sum()).toBe(15);
+      }
+      Shape.prototype = { sum: function() { return 0; } };
+      expect(new Shape().sum()).toBe(0);
+      function Factory() {
+        this.a = 1; this.b = 2; this.c = 3; this.d = 4; this.e = 5;
+        return { a: 10 };
+      }
+      for (var i = 0; i < 10; ++i) {
+        expect(new Factory().a).toBe(10);
+        expect(new Factory().e).toBe(undefined);
+      }
+    });
+  });
+});
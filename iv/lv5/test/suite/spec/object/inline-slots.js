@@ -0,0 +1,96 @@
+describe("Object", function() {
+  describe("slots", function() {
+    function make(n) {
+      var obj = {};
+      for (var i = 0; i < n; ++i) {
+        obj['p' + i] = i;
+      }
+      return obj;
+    }
+
+    it("should hold properties in inline and out-of-line slots", function() {
+      for (var n = 0; n < 12; ++n) {
+        var obj = make(n);
+        for (var i = 0; i < n; ++i) {
+          expect(obj['p' + i]).toBe(i);
+        }
+        expect(Object.keys(obj).length).toBe(n);
+      }
+    });
+
+    it("should be cached across inline boundary", function() {
+      function Point(x, y, z, w, v, u) {
+        this.x = x;
+        this.y = y;
+        this.z = z;
+        this.w = w;
+        this.v = v;
+        this.u = u;
+      }
+      function sum(p) {
+        return p.x + p.y + p.z + p.w + p.v + p.u;
+      }
+      function update(p) {
+        p.x = 1;
+        p.u = 6;
+      }
+      var result = 0;
+      for (var i = 0; i < 1000; ++i) {
+        var p = new Point(i, 0, 0, 0, 0, i);
+        result += sum(p);
+        update(p);
+        result += sum(p);
+      }
+      expect(result).toBe(1000 * 999 + 7 * 1000);
+    });
+
+    it("should keep values after deletion", function() {
+      var obj = make(8);
+      delete obj.p1;
+      delete obj.p6;
+      obj.q = 'q';
+      expect(obj.p0).toBe(0);
+      expect(obj.p1).toBe(undefined);
+      expect(obj.p5).toBe(5);
+      expect(obj.p7).toBe(7);
+      expect(obj.q).toBe('q');
+    });
+
+    it("should handle accessors in object literal", function() {
+      var obj = {
+        a: 1, b: 2, c: 3, d: 4, e: 5,
+        get f() { return this.a + this.e; },
+        set g(v) { this.a = v; }
+      };
+      expect(obj.f).toBe(6);
+      obj.g = 10;
+      expect(obj.f).toBe(15);
+    });
+
+    it("should load and store global properties", function() {
+      var global = Function('return this;')();
+      var names = Object.getOwnPropertyNames(global).filter(function(name) {
+        return name !== 'NaN' && /^[A-Za-z_$][\w$]*$/.test(name);
+      });
+      var load = Function('return [' + names.join(',') + '];');
+      for (var n = 0; n < 10; ++n) {
+        var values = load();
+        for (var i = 0; i < names.length; ++i) {
+          expect(values[i]).toBe(global[names[i]]);
+        }
+      }
+      // store the same values, so this does not break environment
+      var store = Function('v', names.map(function(name, i) {
+        return name + ' = v[' + i + '];';
+      }).join(''));
+      var saved = load();
+      for (var n = 0; n < 10; ++n) {
+        store(saved);
+      }
+      var values = load();
+      for (var i = 0; i < names.length; ++i) {
+        expect(values[i]).toBe(saved[i]);
+      }
+    });
+  });
+});
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iv/lv5/lv5.h>
+#include <iv/lv5/heap_snapshot.h>
+#include <iv/lv5/railgun/railgun.h>
+#include "test_radio.h"
+#include "test_railgun.h"
+namespace {
+
+std::vector<std::string> ReadLines(std::FILE* file) {
+  std::vector<std::string> lines;
+  std::string line;
+  const std::string contents = ReadAll(file);
+  for (std::string::const_iterator it = contents.begin(),
+       last = contents.end(); it != last; ++it) {
+    if (*it == '\n') {
+      lines.push_back(line);
+      line.clear();
+    } else {
+      line.push_back(*it);
+    }
+  }
+  return lines;
+}
+
+bool Contains(const std::vector<std::string>& lines, const std::string& str) {
+  for (std::vector<std::string>::const_iterator it = lines.begin(),
+       last = lines.end(); it != last; ++it) {
+    if (it->find(str) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace anonymous
+
+TEST(HeapSnapshotCase, RadioCoreTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  const iv::lv5::radio::Scope scope(core.get());
+  Node* parent = new(core->Allocate<Node>())Node;
+  Node* child = new(core->Allocate<Node>())Node;
+  parent->set_child(child);
+  child->set_child(parent);
+  core->ChainToScope(parent);
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_TRUE(file);
+  iv::lv5::HeapSnapshot snapshot(nullptr, file);
+  snapshot.WriteCoreRoots(core.get());
+  EXPECT_EQ(2u, snapshot.nodes());
+  EXPECT_EQ(2u, snapshot.edges());
+
+  const std::vector<std::string> lines = ReadLines(file);
+  std::fclose(file);
+  ASSERT_FALSE(lines.empty());
+  EXPECT_EQ("lv5-heap-snapshot 1", lines.front());
+  EXPECT_TRUE(Contains(lines, "R handle "));
+  EXPECT_TRUE(Contains(lines, " internal 0 "));
+}
+
+TEST(HeapSnapshotCase, ContextTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::Error::Standard e;
+  iv::lv5::JSObject* obj = iv::lv5::JSObject::New(&ctx);
+  iv::lv5::JSString* str =
+      iv::lv5::JSString::New(&ctx, iv::core::string_view("leak"), &e);
+  ASSERT_FALSE(e);
+  obj->DefineOwnProperty(
+      &ctx, ctx.Intern("target"),
+      iv::lv5::DataDescriptor(str, iv::lv5::ATTR::W), false, &e);
+  iv::lv5::JSArray* ary = iv::lv5::JSArray::New(&ctx);
+  ary->DefineOwnProperty(
+      &ctx, iv::lv5::symbol::MakeSymbolFromIndex(0),
+      iv::lv5::DataDescriptor(obj, iv::lv5::ATTR::W), false, &e);
+  ASSERT_FALSE(e);
+  ctx.Import("snapshotTarget", ary);
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_TRUE(file);
+  iv::lv5::HeapSnapshot snapshot(&ctx, file);
+  snapshot.WriteContextRoots();
+  const std::vector<std::string> lines = ReadLines(file);
+  std::fclose(file);
+  EXPECT_TRUE(Contains(lines, "R global "));
+  EXPECT_TRUE(Contains(lines, " property \"snapshotTarget\" "));
+  EXPECT_TRUE(Contains(lines, " element 0 "));
+  EXPECT_TRUE(Contains(lines, " property \"target\" "));
+  EXPECT_TRUE(Contains(lines, " object Array "));
+  EXPECT_TRUE(Contains(lines, "\"leak\""));
+}
+
+TEST(HeapSnapshotCase, ConsStringTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::Error::Standard e;
+  const std::string lhs(200, 'a');
+  const std::u16string rhs(100, 0x3042);
+  iv::lv5::JSString* str = iv::lv5::JSString::NewCons(
+      &ctx,
+      iv::lv5::JSString::New(&ctx, iv::core::string_view(lhs), &e),
+      iv::lv5::JSString::New(&ctx, iv::core::u16string_view(rhs), &e), &e);
+  ASSERT_FALSE(e);
+  ASSERT_FALSE(str->IsFlat());
+  iv::lv5::JSObject* obj = iv::lv5::JSObject::New(&ctx);
+  obj->DefineOwnProperty(
+      &ctx, ctx.Intern("target"),
+      iv::lv5::DataDescriptor(str, iv::lv5::ATTR::W), false, &e);
+  ASSERT_FALSE(e);
+  ctx.Import("snapshotTarget", obj);
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_TRUE(file);
+  iv::lv5::HeapSnapshot snapshot(&ctx, file);
+  snapshot.WriteContextRoots();
+  const std::vector<std::string> lines = ReadLines(file);
+  std::fclose(file);
+  // contents are truncated, and cons string is not flattened
+  std::string expected = "\"" + lhs;
+  for (std::size_t i = lhs.size();
+       i < iv::lv5::HeapSnapshot::kMaxStringLength; ++i) {
+    expected.append("\xE3\x81\x82");
+  }
+  expected.append("\"");
+  EXPECT_TRUE(Contains(lines, expected));
+  EXPECT_FALSE(str->IsFlat());
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <iv/lv5/lv5.h>
+#include <iv/lv5/railgun/railgun.h>
+#include <iv/lv5/jsstring_builder.h>
+namespace {
+
+// builds left deep rope by repeated concatenation, like `str += piece`
+iv::lv5::JSString* BuildRope(iv::lv5::Context* ctx,
+                             const std::vector<std::u16string>& pieces) {
+  iv::lv5::Error::Dummy e;
+  iv::lv5::JSString* str = iv::lv5::JSString::NewEmpty(ctx);
+  for (const std::u16string& piece : pieces) {
+    iv::lv5::JSString* rhs =
+        iv::lv5::JSString::New(ctx, iv::core::u16string_view(piece), &e);
+    str = iv::lv5::JSString::NewCons(ctx, str, rhs, &e);
+  }
+  return str;
+}
+
+std::u16string Join(const std::vector<std::u16string>& pieces) {
+  std::u16string result;
+  for (const std::u16string& piece : pieces) {
+    result.append(piece);
+  }
+  return result;
+}
+
+}  // namespace anonymous
+
+TEST(JSStringCase, RopeAtTest) {
+  iv::lv5::railgun::Context ctx;
+  const std::vector<std::u16string> pieces = {
+    u"hello", u" ", u"world", u"あい", u"!!"
+  };
+  const std::u16string expected = Join(pieces);
+  iv::lv5::JSString* rope = BuildRope(&ctx, pieces);
+  ASSERT_FALSE(rope->IsFlat());
+  ASSERT_EQ(static_cast<int32_t>(expected.size()), rope->size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], rope->At(i));
+  }
+  EXPECT_FALSE(rope->IsFlat());
+}
+
+TEST(JSStringCase, RopeDeepAtTest) {
+  iv::lv5::railgun::Context ctx;
+  std::vector<std::u16string> pieces;
+  for (int i = 0; i < 100; ++i) {
+    pieces.push_back(u"ab");
+  }
+  iv::lv5::JSString* rope = BuildRope(&ctx, pieces);
+  // last character is found without walking deep
+  EXPECT_EQ(u'b', rope->At(rope->size() - 1));
+  EXPECT_FALSE(rope->IsFlat());
+  // hash is computed without flattening
+  iv::lv5::Error::Dummy e;
+  iv::lv5::JSString* flat =
+      iv::lv5::JSString::New(&ctx, iv::core::u16string_view(Join(pieces)), &e);
+  EXPECT_EQ(iv::lv5::JSString::Hasher()(flat),
+            iv::lv5::JSString::Hasher()(rope));
+  EXPECT_FALSE(rope->IsFlat());
+  // deep access flattens rope
+  EXPECT_EQ(u'a', rope->At(0));
+  EXPECT_TRUE(rope->IsFlat());
+  EXPECT_EQ(u'b', rope->At(1));
+}
+
+TEST(JSStringCase, RopeCompareTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::Error::Dummy e;
+  iv::lv5::JSString* rope = BuildRope(&ctx, { u"abc", u"def", u"ghi" });
+  iv::lv5::JSString* other = BuildRope(&ctx, { u"ab", u"cdefg", u"hi" });
+  iv::lv5::JSString* flat = iv::lv5::JSString::New(&ctx, "abcdefghi", &e);
+  iv::lv5::JSString* less = iv::lv5::JSString::New(&ctx, "abcdefgha", &e);
+  iv::lv5::JSString* prefix = BuildRope(&ctx, { u"abc", u"def" });
+  iv::lv5::JSString* wide = BuildRope(&ctx, { u"abc", u"あ" });
+  EXPECT_TRUE(*rope == *other);
+  EXPECT_TRUE(*rope == *flat);
+  EXPECT_TRUE(*flat == *rope);
+  EXPECT_FALSE(*rope == *less);
+  EXPECT_TRUE(*less < *rope);
+  EXPECT_TRUE(*rope > *less);
+  EXPECT_TRUE(*prefix < *rope);
+  EXPECT_TRUE(*rope < *wide);
+  EXPECT_EQ(0, rope->compare(*other));
+  EXPECT_FALSE(rope->IsFlat());
+  EXPECT_FALSE(other->IsFlat());
+  EXPECT_EQ(iv::lv5::JSString::Hasher()(flat),
+            iv::lv5::JSString::Hasher()(rope));
+}
+
+TEST(JSStringCase, RopeStartsWithTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::Error::Dummy e;
+  iv::lv5::JSString* rope = BuildRope(&ctx, { u"abc", u"def", u"ghi" });
+  iv::lv5::JSString* cde = iv::lv5::JSString::New(&ctx, "cde", &e);
+  iv::lv5::JSString* hi = BuildRope(&ctx, { u"h", u"i" });
+  EXPECT_TRUE(rope->StartsWith(*cde, 2));
+  EXPECT_FALSE(rope->StartsWith(*cde, 3));
+  EXPECT_TRUE(rope->StartsWith(*hi, 7));
+  EXPECT_FALSE(rope->StartsWith(*hi, 8));
+  EXPECT_TRUE(rope->StartsWith(*iv::lv5::JSString::NewEmpty(&ctx), 9));
+  EXPECT_FALSE(rope->IsFlat());
+}
+
+TEST(JSStringCase, RopeSubstringTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::JSString* rope = BuildRope(&ctx, { u"abc", u"def", u"ghi" });
+  iv::lv5::JSString* sub = rope->Substring(&ctx, 4, 6);
+  EXPECT_EQ(u"ef", sub->GetUTF16());
+  EXPECT_FALSE(rope->IsFlat());
+  sub = rope->Substring(&ctx, 2, 7);
+  EXPECT_EQ(u"cdefg", sub->GetUTF16());
+}
+
+TEST(JSStringCase, RopeBuilderTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::Error::Dummy e;
+  iv::lv5::JSString* rope = BuildRope(&ctx, { u"abc", u"あ", u"ghi" });
+  iv::lv5::JSStringBuilder builder;
+  builder.AppendJSString(*rope);
+  builder.AppendJSString(*rope, 2, 5);
+  EXPECT_EQ(u"abcあghicあg",
+            builder.Build(&ctx, false, &e)->GetUTF16());
+  EXPECT_FALSE(rope->IsFlat());
+}
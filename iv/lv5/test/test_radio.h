@@ -0,0 +1,45 @@
+#ifndef IV_LV5_TEST_RADIO_H_
+#define IV_LV5_TEST_RADIO_H_
+#include <iv/lv5/radio/core.h>
+
+// cell which has up to 2 children, shared by radio tests and benchmarks
+class Node : public iv::lv5::radio::Cell {
+ public:
+  Node() : Cell(iv::lv5::radio::POINTER), left_(nullptr), right_(nullptr) { }
+
+  void MarkChildren(iv::lv5::radio::Core* core) {
+    if (left_) {
+      core->MarkCell(left_);
+    }
+    if (right_) {
+      core->MarkCell(right_);
+    }
+  }
+
+  Node* child() const { return left_; }
+
+  void set_child(Node* child) { left_ = child; }
+
+  // allocated node is chained to the current scope
+  static Node* New(iv::lv5::radio::Core* core) {
+    Node* node = new(core->Allocate<Node>())Node;
+    core->ChainToScope(node);
+    return node;
+  }
+
+  // complete binary tree, only the root should be chained by the caller
+  static Node* Tree(iv::lv5::radio::Core* core, int depth) {
+    Node* node = new(core->Allocate<Node>())Node;
+    if (depth) {
+      node->left_ = Tree(core, depth - 1);
+      node->right_ = Tree(core, depth - 1);
+    }
+    return node;
+  }
+
+ private:
+  Node* left_;
+  Node* right_;
+};
+
+#endif  // IV_LV5_TEST_RADIO_H_
@@ -1,8 +1,14 @@
 #include <gtest/gtest.h>
 #include <memory>
+#include <vector>
+#include <thread>
 #include <iv/lv5/radio/core.h>
 #include <iv/lv5/radio/scope.h>
+#include <iv/lv5/radio/allocation_buffer.h>
 #include <iv/lv5/jsstring.h>
+#include <iv/lv5/jsval.h>
+#include <iv/lv5/error.h>
+#include "test_radio.h"
 
 TEST(RadioCoreCase, MainTest) {
   std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
@@ -84,3 +90,323 @@ TEST(RadioCoreCase, ColoringScopedEscapeTest) {
   core->Collect(nullptr);
   EXPECT_EQ(iv::lv5::radio::Color::WHITE, cell->color());
 }
+
+TEST(RadioCoreCase, NurseryBumpAllocationTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  iv::lv5::radio::Cell* cell1 = core->Allocate<iv::lv5::JSString>();
+  iv::lv5::radio::Cell* cell2 = core->Allocate<iv::lv5::JSString>();
+  EXPECT_FALSE(cell1->block()->IsOld());
+  EXPECT_EQ(cell1->block()->cell_size(),
+            static_cast<std::size_t>(
+                reinterpret_cast<uintptr_t>(cell2) -
+                reinterpret_cast<uintptr_t>(cell1)));
+  EXPECT_EQ(1u, core->nursery_blocks());
+}
+
+TEST(RadioCoreCase, MinorGCPromotionTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  iv::lv5::radio::Cell* cell = nullptr;
+  iv::lv5::radio::Cell* dead = nullptr;
+  {
+    iv::lv5::radio::Scope scope(core.get());
+    cell = core->Allocate<iv::lv5::JSString>();
+    cell->Coloring(iv::lv5::radio::Color::WHITE);
+    core->ChainToScope(cell);
+    dead = core->Allocate<iv::lv5::JSString>();
+    dead->Coloring(iv::lv5::radio::Color::WHITE);
+    core->CollectNursery(nullptr);
+    EXPECT_EQ(iv::lv5::radio::Color::WHITE, cell->color());
+    EXPECT_EQ(iv::lv5::radio::Color::CLEAR, dead->color());
+    EXPECT_TRUE(cell->block()->IsOld());
+    EXPECT_EQ(0u, core->nursery_blocks());
+    EXPECT_EQ(1u, core->old_blocks());
+  }
+  core->CollectNursery(nullptr);
+  // old cell is not collected in minor GC
+  EXPECT_EQ(iv::lv5::radio::Color::WHITE, cell->color());
+  core->CollectAll(nullptr);
+  core->CompleteSweep();
+  EXPECT_EQ(iv::lv5::radio::Color::CLEAR, cell->color());
+  EXPECT_EQ(0u, core->old_blocks());
+}
+
+TEST(RadioCoreCase, WriteBarrierTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  iv::lv5::radio::Cell* old = nullptr;
+  {
+    iv::lv5::radio::Scope scope(core.get());
+    old = core->Allocate<iv::lv5::JSString>();
+    old->Coloring(iv::lv5::radio::Color::WHITE);
+    core->ChainToScope(old);
+    core->CollectNursery(nullptr);
+    EXPECT_TRUE(old->block()->IsOld());
+
+    iv::lv5::radio::Cell* young = core->Allocate<iv::lv5::JSString>();
+    EXPECT_FALSE(young->block()->IsOld());
+    core->WriteBarrier(old, young);
+    EXPECT_TRUE(old->IsRemembered());
+    core->WriteBarrier(young, old);
+    EXPECT_FALSE(young->IsRemembered());
+    core->CollectNursery(nullptr);
+    EXPECT_FALSE(old->IsRemembered());
+  }
+}
+
+TEST(RadioCoreCase, IncrementalMarkingTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  const iv::lv5::radio::Scope scope(core.get());
+  Node* root = Node::New(core.get());
+  Node* node = root;
+  for (std::size_t i = 0; i < 10; ++i) {
+    Node* child = new(core->Allocate<Node>())Node;
+    node->set_child(child);
+    node = child;
+  }
+  core->set_marking_step_budget(1);
+  core->StartIncrementalMarking(nullptr);
+  EXPECT_TRUE(core->IsMarking());
+  EXPECT_FALSE(core->IncrementalMarkingStep(nullptr));
+  EXPECT_EQ(iv::lv5::radio::Color::BLACK, root->color());
+  EXPECT_EQ(iv::lv5::radio::Color::WHITE, node->color());
+  while (!core->IncrementalMarkingStep(nullptr)) { }
+  EXPECT_EQ(iv::lv5::radio::Color::BLACK, node->color());
+  core->FinishIncrementalMarking(nullptr);
+  EXPECT_FALSE(core->IsMarking());
+  EXPECT_EQ(iv::lv5::radio::Color::WHITE, root->color());
+  EXPECT_EQ(iv::lv5::radio::Color::WHITE, node->color());
+  EXPECT_LT(3u, core->slice_statistics().count);
+}
+
+TEST(RadioCoreCase, IncrementalMarkingWriteBarrierTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  const iv::lv5::radio::Scope scope(core.get());
+  Node* root = Node::New(core.get());
+  Node* moved = nullptr;
+  {
+    const iv::lv5::radio::Scope inner(core.get());
+    Node* holder = Node::New(core.get());
+    moved = new(core->Allocate<Node>())Node;
+    holder->set_child(moved);
+    core->StartIncrementalMarking(nullptr);
+    EXPECT_TRUE(core->IncrementalMarkingStep(nullptr));
+    EXPECT_EQ(iv::lv5::radio::Color::BLACK, root->color());
+    EXPECT_EQ(iv::lv5::radio::Color::BLACK, moved->color());
+  }
+  Node* created = new(core->Allocate<Node>())Node;
+  EXPECT_EQ(iv::lv5::radio::Color::WHITE, created->color());
+  // store white cell to black cell
+  root->set_child(created);
+  core->WriteBarrier(root, created);
+  EXPECT_EQ(iv::lv5::radio::Color::GRAY, created->color());
+  core->FinishIncrementalMarking(nullptr);
+  EXPECT_EQ(iv::lv5::radio::Color::WHITE, created->color());
+}
+
+TEST(RadioCoreCase, ParallelMarkingTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  const iv::lv5::radio::Scope scope(core.get());
+  std::vector<Node*> nodes;
+  for (std::size_t i = 0; i < 16; ++i) {
+    Node* node = Node::New(core.get());
+    nodes.push_back(node);
+    for (std::size_t j = 0; j < 500; ++j) {
+      Node* child = new(core->Allocate<Node>())Node;
+      node->set_child(child);
+      node = child;
+      nodes.push_back(node);
+    }
+  }
+  core->set_marker_threads(4);
+  core->Mark(nullptr);
+  for (std::vector<Node*>::const_iterator it = nodes.begin(),
+       last = nodes.end(); it != last; ++it) {
+    EXPECT_EQ(iv::lv5::radio::Color::BLACK, (*it)->color());
+  }
+  core->Collect(nullptr);
+  core->CompleteSweep();
+  for (std::vector<Node*>::const_iterator it = nodes.begin(),
+       last = nodes.end(); it != last; ++it) {
+    EXPECT_EQ(iv::lv5::radio::Color::WHITE, (*it)->color());
+  }
+}
+
+TEST(RadioCoreCase, LazySweepTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  Node* cell = nullptr;
+  {
+    const iv::lv5::radio::Scope scope(core.get());
+    cell = Node::New(core.get());
+    core->CollectNursery(nullptr);
+    EXPECT_TRUE(cell->block()->IsOld());
+  }
+  core->CollectAll(nullptr);
+  // old block is not swept yet
+  EXPECT_EQ(iv::lv5::radio::Color::WHITE, cell->color());
+  EXPECT_EQ(1u, core->old_blocks());
+  core->CompleteSweep();
+  EXPECT_EQ(iv::lv5::radio::Color::CLEAR, cell->color());
+  EXPECT_EQ(0u, core->old_blocks());
+}
+
+TEST(RadioCoreCase, ConcurrentSweepTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  core->set_concurrent_sweep(true);
+  {
+    const iv::lv5::radio::Scope scope(core.get());
+    for (std::size_t i = 0; i < 1000; ++i) {
+      Node::New(core.get());
+    }
+    core->CollectNursery(nullptr);
+  }
+  core->CollectAll(nullptr);
+  // allocation runs with background sweeper
+  for (std::size_t i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(core->Allocate<Node>());
+  }
+  core->CompleteSweep();
+  EXPECT_EQ(0u, core->old_blocks());
+}
+
+TEST(RadioCoreCase, PauseHistogramTest) {
+  iv::lv5::radio::PauseHistogram histogram;
+  histogram.Record(0.5);
+  histogram.Record(3.0);
+  histogram.Record(1e9);
+  EXPECT_EQ(3u, histogram.count());
+  EXPECT_EQ(1u, histogram.buckets()[0]);
+  EXPECT_EQ(1u, histogram.buckets()[2]);
+  EXPECT_EQ(1u, histogram.buckets().back());
+  EXPECT_EQ(1e9, histogram.max());
+  EXPECT_EQ(1e9, histogram.last());
+  EXPECT_EQ(4.0, iv::lv5::radio::PauseHistogram::BucketLimit(2));
+}
+
+TEST(RadioCoreCase, StatisticsTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  iv::lv5::radio::HeapStatistics stats;
+  {
+    const iv::lv5::radio::Scope scope(core.get());
+    Node::New(core.get());
+    Node::New(core.get());
+    core->GetStatistics(&stats);
+    EXPECT_EQ(1u, stats.arenas);
+    EXPECT_EQ(iv::lv5::radio::kBlocks, stats.blocks);
+    EXPECT_EQ(1u, stats.nursery_blocks);
+    EXPECT_EQ(stats.blocks - 1, stats.free_blocks);
+    std::size_t used_cells = 0;
+    for (iv::lv5::radio::HeapStatistics::Controls::const_iterator
+         it = stats.controls.begin(),
+         last = stats.controls.end(); it != last; ++it) {
+      used_cells += it->used_cells;
+    }
+    EXPECT_EQ(2u, used_cells);
+    EXPECT_EQ(stats.used_bytes, stats.bytes_allocated_since_gc);
+    EXPECT_LT(0.0, stats.fragmentation());
+
+    core->CollectNursery(nullptr);
+    core->GetStatistics(&stats);
+    EXPECT_EQ(0u, stats.bytes_allocated_since_gc);
+    EXPECT_EQ(1u, stats.minor_collections);
+    EXPECT_EQ(1u, stats.old_blocks);
+    EXPECT_EQ(1u, stats.pauses.count());
+  }
+  core->CollectAll(nullptr);
+  core->CompleteSweep();
+  core->GetStatistics(&stats);
+  EXPECT_EQ(0u, stats.used_bytes);
+  EXPECT_EQ(0u, stats.old_blocks);
+  EXPECT_EQ(stats.blocks, stats.free_blocks);
+  EXPECT_EQ(1u, stats.major_collections);
+  EXPECT_EQ(2u, stats.pauses.count());
+  EXPECT_EQ(0.0, stats.fragmentation());
+}
+
+TEST(RadioCoreCase, ReleaseEmptyArenasTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  {
+    const iv::lv5::radio::Scope scope(core.get());
+    for (std::size_t i = 0; i < 30000; ++i) {
+      Node::New(core.get());
+    }
+    EXPECT_LT(2u, core->arenas());
+  }
+  core->CollectNursery(nullptr);
+  core->CollectAll(nullptr);
+  core->CompleteSweep();
+  EXPECT_EQ(iv::lv5::radio::kRetainedEmptyArenas, core->arenas());
+  iv::lv5::radio::HeapStatistics stats;
+  core->GetStatistics(&stats);
+  EXPECT_LT(0u, stats.released_arenas);
+  EXPECT_EQ(stats.blocks, stats.free_blocks);
+
+  // heap grows again
+  const iv::lv5::radio::Scope scope(core.get());
+  EXPECT_TRUE(Node::New(core.get()));
+}
+
+TEST(RadioCoreCase, HeapLimitTest) {
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  core->set_heap_limit(iv::lv5::radio::kArenaSize * 2);
+  iv::lv5::Error::Standard e;
+  {
+    const iv::lv5::radio::Scope scope(core.get());
+    while (iv::lv5::radio::Cell* cell = core->Allocate<Node>(nullptr, &e)) {
+      core->ChainToScope(new(cell)Node);
+    }
+    EXPECT_EQ(iv::lv5::Error::Range, e.code());
+    EXPECT_EQ(2u, core->arenas());
+  }
+  e.Clear();
+  // unreachable cells are collected when heap limit is reached
+  iv::lv5::radio::Cell* cell = core->Allocate<Node>(nullptr, &e);
+  ASSERT_TRUE(cell);
+  new(cell)Node;
+  EXPECT_FALSE(e);
+  EXPECT_GE(2u, core->arenas());
+}
+
+TEST(RadioCoreCase, ThreadLocalAllocationTest) {
+  static const std::size_t kThreads = 4;
+  static const std::size_t kNodes = 20000;
+  std::unique_ptr<iv::lv5::radio::Core> core(new iv::lv5::radio::Core);
+  std::vector<Node*> heads(kThreads, nullptr);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < kThreads; ++i) {
+    threads.push_back(std::thread([&core, &heads, i] {
+      iv::lv5::radio::AllocationBuffer buffer(core.get());
+      Node* head = nullptr;
+      for (std::size_t j = 0; j < kNodes; ++j) {
+        Node* node = new(core->Allocate<Node>())Node;
+        node->set_child(head);
+        head = node;
+      }
+      heads[i] = head;
+    }));
+  }
+  for (std::size_t i = 0; i < kThreads; ++i) {
+    threads[i].join();
+  }
+
+  const iv::lv5::radio::Scope scope(core.get());
+  for (std::size_t i = 0; i < kThreads; ++i) {
+    core->ChainToScope(heads[i]);
+  }
+  iv::lv5::radio::HeapStatistics stats;
+  core->GetStatistics(&stats);
+  const std::size_t allocated = stats.bytes_allocated_since_gc;
+  EXPECT_EQ(allocated, stats.used_bytes);
+  EXPECT_EQ(0u, allocated % (kThreads * kNodes));
+
+  core->CollectNursery(nullptr);
+  core->CollectAll(nullptr);
+  core->CompleteSweep();
+  for (std::size_t i = 0; i < kThreads; ++i) {
+    std::size_t count = 0;
+    for (Node* node = heads[i]; node; node = node->child()) {
+      ++count;
+    }
+    EXPECT_EQ(kNodes, count);
+  }
+  core->GetStatistics(&stats);
+  EXPECT_EQ(allocated, stats.used_bytes);
+}
@@ -0,0 +1,41 @@
+#ifndef IV_LV5_TEST_RAILGUN_H_
+#define IV_LV5_TEST_RAILGUN_H_
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <iv/lv5/lv5.h>
+#include <iv/lv5/railgun/railgun.h>
+
+// assert function used by test scripts, throws if condition is false
+static const std::string kAssertFunction =
+    "function assert(cond) { if (!cond) throw new Error('failed'); }\n";
+
+// executes source as global code after assert function is defined.
+// error is dumped and reported as test failure
+inline bool Execute(iv::lv5::railgun::Context* ctx,
+                    const char* source, const char* name) {
+  iv::lv5::Error::Standard e;
+  const std::string script = kAssertFunction + source;
+  std::shared_ptr<iv::core::FileSource>
+      src(new iv::core::FileSource(iv::core::string_view(script), name));
+  iv::lv5::railgun::ExecuteInGlobal(ctx, src, &e);
+  if (e) {
+    e.Dump(ctx, stderr);
+    ADD_FAILURE() << name << ": " << source;
+    return false;
+  }
+  return true;
+}
+
+// reads whole contents of file from the beginning
+inline std::string ReadAll(std::FILE* file) {
+  std::string result;
+  std::rewind(file);
+  for (int ch = std::fgetc(file); ch != EOF; ch = std::fgetc(file)) {
+    result.push_back(static_cast<char>(ch));
+  }
+  return result;
+}
+
+#endif  // IV_LV5_TEST_RAILGUN_H_
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iv/platform_io.h>
+#include <iv/lv5/lv5.h>
+#include <iv/lv5/railgun/railgun.h>
+#include "test_railgun.h"
+namespace {
+
+static const std::string kSource = kAssertFunction +
+    "function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }\n"
+    "var counter = 0;\n"
+    "function increment() { counter = counter + 1; return counter; }\n"
+    "var obj = { x: 1, get y() { return this.x + 1; } };\n"
+    "var ary = [1, 'two', 3.5, null];\n"
+    "var re = /a+b/gi;\n"
+    "assert(fib(15) === 610);\n"
+    "assert(increment() === 1 && increment() === 2);\n"
+    "assert(obj.x === 1 && obj.y === 2);\n"
+    "assert(ary.length === 4 && ary[1] === 'two' && ary[2] === 3.5);\n"
+    "assert(re.test('xAAB') && re.global && re.ignoreCase);\n"
+    "try { null.x; } catch (e) { counter = 10; }\n"
+    "assert(counter === 10);\n"
+    "for (var i = 0, sum = 0; i < 100; ++i) { sum += i; }\n"
+    "assert(sum === 4950);\n";
+
+std::shared_ptr<iv::core::FileSource> Source(const std::string& source) {
+  return std::shared_ptr<iv::core::FileSource>(
+      new iv::core::FileSource(iv::core::string_view(source), "code_cache"));
+}
+
+std::shared_ptr<iv::core::FileSource> Source() {
+  return Source(kSource);
+}
+
+// cache files are stored in unique temporary directory,
+// which is removed after each test
+class RailgunCodeCacheCase : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    char name[] = "/tmp/lv5_code_cache_XXXXXX";
+    ASSERT_TRUE(mkdtemp(name));
+    directory_ = name;
+  }
+
+  virtual void TearDown() {
+    files_.push_back(CacheFileName());
+    for (std::vector<std::string>::const_iterator it = files_.begin(),
+         last = files_.end(); it != last; ++it) {
+      std::remove(it->c_str());
+      std::remove((*it + ".tmp").c_str());
+    }
+    EXPECT_EQ(0, rmdir(directory_.c_str()));
+  }
+
+  // returns true if code is loaded from cache
+  bool Execute(bool expect_loaded,
+               std::shared_ptr<iv::core::FileSource> src = Source()) {
+    iv::lv5::railgun::Context ctx;
+    ctx.set_code_cache_directory(directory_);
+    iv::lv5::Error::Standard e;
+    iv::lv5::railgun::JSScript* script =
+        iv::lv5::railgun::JSSourceScript<iv::core::FileSource>::New(&ctx, src);
+    const iv::lv5::railgun::CodeCache cache(&ctx, false);
+    iv::lv5::railgun::Code* code = cache.Load(*src, script);
+    const bool loaded = code;
+    if (!code) {
+      code = iv::lv5::railgun::CompileInGlobal(&ctx, src, false, &e);
+    }
+    EXPECT_FALSE(e);
+    EXPECT_TRUE(code);
+    if (code) {
+      ctx.vm()->Run(code, &e);
+      if (e) {
+        e.Dump(&ctx, stderr);
+        ADD_FAILURE() << expect_loaded;
+      }
+    }
+    return loaded;
+  }
+
+  std::string CacheFileName(
+      std::shared_ptr<iv::core::FileSource> src = Source()) {
+    iv::lv5::railgun::Context ctx;
+    ctx.set_code_cache_directory(directory_);
+    const iv::lv5::railgun::CodeCache cache(&ctx, false);
+    const std::string filename = cache.GetFileName(*src);
+    files_.push_back(filename);
+    return filename;
+  }
+
+  std::string directory_;
+  std::vector<std::string> files_;
+};
+
+}  // namespace anonymous
+
+TEST_F(RailgunCodeCacheCase, LoadTest) {
+  // compiled and stored
+  EXPECT_FALSE(Execute(false));
+  // loaded from stored code
+  EXPECT_TRUE(Execute(true));
+  EXPECT_TRUE(Execute(true));
+}
+
+TEST_F(RailgunCodeCacheCase, BrokenFileTest) {
+  const std::string filename = CacheFileName();
+  EXPECT_FALSE(Execute(false));
+  std::vector<char> data;
+  ASSERT_TRUE(iv::core::io::ReadFile(filename, &data));
+  // truncated file is not loaded, and code is compiled again
+  std::FILE* fp = iv::core::io::OpenFile(filename, "wb");
+  ASSERT_TRUE(fp);
+  std::fwrite(data.data(), data.size() / 2, 1, fp);
+  std::fclose(fp);
+  EXPECT_FALSE(Execute(false));
+  EXPECT_TRUE(Execute(true));
+}
+
+TEST_F(RailgunCodeCacheCase, CollisionTest) {
+  // other source which has the same size
+  std::string other(kSource);
+  for (std::size_t pos = other.find("counter");
+       pos != std::string::npos; pos = other.find("counter", pos)) {
+    other.replace(pos, 7, "cnt_var");
+  }
+  std::shared_ptr<iv::core::FileSource> src = Source(other);
+  EXPECT_FALSE(Execute(false));
+
+  // file of kSource is renamed as if its hash collides with other source
+  std::vector<char> data;
+  ASSERT_TRUE(iv::core::io::ReadFile(CacheFileName(), &data));
+  ASSERT_LE(sizeof(iv::lv5::railgun::CodeCache::Header), data.size());
+  iv::lv5::railgun::CodeCache::Header header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  header.source_hash = iv::core::FNVHash::StringToHash(src->GetData());
+  std::memcpy(data.data(), &header, sizeof(header));
+  std::FILE* fp = iv::core::io::OpenFile(CacheFileName(src), "wb");
+  ASSERT_TRUE(fp);
+  std::fwrite(data.data(), data.size(), 1, fp);
+  std::fclose(fp);
+
+  // source is compared, so stored code of kSource is not loaded
+  EXPECT_FALSE(Execute(false, src));
+  EXPECT_TRUE(Execute(true, src));
+}
+
+TEST_F(RailgunCodeCacheCase, ChecksumTest) {
+  const std::string filename = CacheFileName();
+  EXPECT_FALSE(Execute(false));
+  std::vector<char> data;
+  ASSERT_TRUE(iv::core::io::ReadFile(filename, &data));
+  // flip byte of serialized code
+  data[data.size() - 16] ^= 0x10;
+  std::FILE* fp = iv::core::io::OpenFile(filename, "wb");
+  ASSERT_TRUE(fp);
+  std::fwrite(data.data(), data.size(), 1, fp);
+  std::fclose(fp);
+  EXPECT_FALSE(Execute(false));
+  EXPECT_TRUE(Execute(true));
+}
+
+TEST_F(RailgunCodeCacheCase, VerifyTest) {
+  typedef iv::lv5::railgun::CodeCache CodeCache;
+  std::shared_ptr<iv::core::FileSource> src =
+      Source("var i = 0; while (i < 10) { i = i + 1; }");
+  const std::string filename = CacheFileName(src);
+  EXPECT_FALSE(Execute(false, src));
+  std::vector<char> data;
+  ASSERT_TRUE(iv::core::io::ReadFile(filename, &data));
+
+  // backward jump of the loop is rewritten to the middle of instruction,
+  // and checksum is recomputed
+  const uint32_t op = iv::lv5::railgun::OP::IF_TRUE_BINARY_LT;
+  std::size_t found = 0;
+  for (std::size_t i = sizeof(CodeCache::Header);
+       i + sizeof(uint32_t) + sizeof(iv::lv5::railgun::Instruction) <=
+       data.size(); ++i) {
+    iv::lv5::railgun::Instruction operand(0u);
+    std::memcpy(&operand, data.data() + i + sizeof(uint32_t),
+                sizeof(operand));
+    if (std::memcmp(data.data() + i, &op, sizeof(uint32_t)) == 0 &&
+        operand.jump.to < 0 && operand.jump.to > -100) {
+      found = i;
+    }
+  }
+  ASSERT_TRUE(found);
+  iv::lv5::railgun::Instruction operand(0u);
+  std::memcpy(&operand, data.data() + found + sizeof(uint32_t),
+              sizeof(operand));
+  operand.jump.to = 1;
+  std::memcpy(data.data() + found + sizeof(uint32_t),
+              &operand, sizeof(operand));
+  CodeCache::Header header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  header.checksum = CodeCache::Checksum(data.data() + sizeof(header),
+                                        data.size() - sizeof(header));
+  std::memcpy(data.data(), &header, sizeof(header));
+  std::FILE* fp = iv::core::io::OpenFile(filename, "wb");
+  ASSERT_TRUE(fp);
+  std::fwrite(data.data(), data.size(), 1, fp);
+  std::fclose(fp);
+  EXPECT_FALSE(Execute(false, src));
+  EXPECT_TRUE(Execute(true, src));
+}
+
+TEST_F(RailgunCodeCacheCase, GlobalDeclarationTest) {
+  EXPECT_FALSE(Execute(false));
+  iv::lv5::railgun::Context ctx;
+  ctx.set_code_cache_directory(directory_);
+  iv::lv5::Error::Standard e;
+  // non writable global property conflicts with function increment
+  ctx.global_obj()->DefineOwnProperty(
+      &ctx, ctx.Intern("increment"),
+      iv::lv5::DataDescriptor(iv::lv5::JSVal::Int32(1), iv::lv5::ATTR::NONE),
+      false, &e);
+  ASSERT_FALSE(e);
+  std::shared_ptr<iv::core::FileSource> src = Source();
+  iv::lv5::railgun::JSScript* script =
+      iv::lv5::railgun::JSSourceScript<iv::core::FileSource>::New(&ctx, src);
+  const iv::lv5::railgun::CodeCache cache(&ctx, false);
+  EXPECT_FALSE(cache.Load(*src, script));
+  // declarations before increment are not left in global object
+  EXPECT_FALSE(ctx.global_obj()->HasProperty(&ctx, ctx.Intern("fib")));
+  EXPECT_FALSE(ctx.global_obj()->HasProperty(&ctx, ctx.Intern("counter")));
+}
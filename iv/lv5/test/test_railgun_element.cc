@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "test_railgun.h"
+
+TEST(RailgunElementCase, DenseArrayTest) {
+  iv::lv5::railgun::Context ctx;
+  Execute(
+      &ctx,
+      "var ary = [];\n"
+      "for (var i = 0; i < 100; ++i) { ary[i] = i; }\n"
+      "var sum = 0;\n"
+      "for (var i = 0; i < ary.length; ++i) { ary[i] = ary[i] * 2; }\n"
+      "for (var i = 0; i < ary.length; ++i) { sum += ary[i]; }\n"
+      "assert(sum === 9900);\n"
+      "assert(ary[100] === undefined);\n"
+      "assert(ary[-1] === undefined);\n"
+      "ary[-1] = 20;\n"
+      "assert(ary[-1] === 20 && ary.length === 100);\n",
+      "element");
+}
+
+TEST(RailgunElementCase, HoleTest) {
+  iv::lv5::railgun::Context ctx;
+  Execute(
+      &ctx,
+      "Array.prototype[1] = 'proto';\n"
+      "var ary = [0, , 2];\n"
+      "assert(ary[1] === 'proto');\n"
+      "var called = false;\n"
+      "Object.defineProperty(Array.prototype, 3, {\n"
+      "  set: function(v) { called = true; }, configurable: true\n"
+      "});\n"
+      "ary[3] = 10;\n"
+      "assert(called && !ary.hasOwnProperty(3));\n"
+      "delete Array.prototype[1];\n"
+      "delete Array.prototype[3];\n"
+      "var frozen = Object.freeze([1, 2, 3]);\n"
+      "frozen[0] = 10;\n"
+      "assert(frozen[0] === 1);\n"
+      "var args = (function() { return arguments; })(1, 2);\n"
+      "args[0] = 3;\n"
+      "assert(args[0] === 3 && args[1] === 2);\n"
+      "assert('str'[1] === 't');\n",
+      "element");
+}
+
+TEST(RailgunElementCase, TypedArrayTest) {
+  iv::lv5::railgun::Context ctx;
+  Execute(
+      &ctx,
+      "var u8 = new Uint8Array(4);\n"
+      "u8[0] = 256; u8[1] = -1; u8[2] = 1.5;\n"
+      "assert(u8[0] === 0 && u8[1] === 255 && u8[2] === 1);\n"
+      "assert(u8[4] === undefined);\n"
+      "var clamped = new Uint8ClampedArray(2);\n"
+      "clamped[0] = 300; clamped[1] = 20;\n"
+      "assert(clamped[0] === 255 && clamped[1] === 20);\n"
+      "var f64 = new Float64Array(8);\n"
+      "for (var i = 0; i < f64.length; ++i) { f64[i] = i + 0.5; }\n"
+      "var sum = 0;\n"
+      "for (var i = 0; i < f64.length; ++i) { sum += f64[i]; }\n"
+      "assert(sum === 32);\n"
+      "var i32 = new Int32Array(2);\n"
+      "i32[0] = { valueOf: function() { return 42; } };\n"
+      "i32[1] = '7';\n"
+      "assert(i32[0] === 42 && i32[1] === 7);\n"
+      "var view = new Int16Array(new ArrayBuffer(8), 4);\n"
+      "view[1] = -2;\n"
+      "assert(view.length === 2 && view[1] === -2);\n",
+      "element");
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <gc/gc.h>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <iv/lv5/lv5.h>
+#include <iv/lv5/railgun/railgun.h>
+#include "test_railgun.h"
+namespace {
+
+static const std::string kSource = kAssertFunction +
+    "function unused() {\n"
+    "  function nested() { return 1; }\n"
+    "  return nested();\n"
+    "}\n"
+    "function counter() {\n"
+    "  var count = 0;\n"
+    "  return function() { count = count + 1; return count; };\n"
+    "}\n"
+    "function match(str) { return /a+b/i.test(str); }\n"
+    "function caught() {\n"
+    "  try { throw 10; } catch (e) { return function() { return e; }; }\n"
+    "}\n"
+    "function args() { return arguments.length; }\n"
+    "function evaluate(x) { return eval('x + 1'); }\n"
+    "function strict() { 'use strict'; return function() { return this; }; }\n"
+    "var obj = {\n"
+    "  value: 1,\n"
+    "  get getter() { return this.value; },\n"
+    "  set setter(v) { this.value = v; }\n"
+    "};\n"
+    "var fact = function f(n) { return n <= 1 ? 1 : n * f(n - 1); };\n"
+    "var c = counter();\n"
+    "assert(c() === 1 && c() === 2);\n"
+    "assert(match('xAAB') && !match('xyz'));\n"
+    "assert(caught()() === 10);\n"
+    "assert(args(1, 2, 3) === 3);\n"
+    "assert(evaluate(1) === 2);\n"
+    "assert(String(unused).indexOf('nested') !== -1);\n"
+    "assert(strict()() === undefined);\n"
+    "obj.setter = 42;\n"
+    "assert(obj.getter === 42);\n"
+    "assert(fact(5) === 120);\n"
+    "var sum = 0;\n"
+    "[1, 2, 3].forEach(function(v) { sum += v; });\n"
+    "assert(sum === 6);\n";
+
+iv::lv5::railgun::Code* Find(iv::lv5::railgun::Code* global,
+                             const char* name) {
+  for (iv::lv5::railgun::Code* code : global->codes()) {
+    if (code->HasName() &&
+        iv::lv5::symbol::GetSymbolString(code->name()) ==
+        std::u16string(name, name + std::strlen(name))) {
+      return code;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace anonymous
+
+TEST(RailgunLazyCodeCase, CompileAtFirstCallTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::Error::Standard e;
+  std::shared_ptr<iv::core::FileSource>
+      src(new iv::core::FileSource(iv::core::string_view(kSource), "lazy"));
+  iv::lv5::railgun::Code* code =
+      iv::lv5::railgun::CompileInGlobal(&ctx, src, false, &e);
+  ASSERT_FALSE(e);
+  ASSERT_TRUE(code);
+  for (iv::lv5::railgun::Code* sub : code->codes()) {
+    EXPECT_TRUE(sub->lazy());
+  }
+  // functions are reparsed from the source after the AST is released
+  GC_gcollect();
+  ctx.vm()->Run(code, &e);
+  if (e) {
+    e.Dump(&ctx, stderr);
+    FAIL();
+  }
+  EXPECT_TRUE(Find(code, "unused")->lazy());
+  EXPECT_FALSE(Find(code, "counter")->lazy());
+  EXPECT_FALSE(Find(code, "match")->lazy());
+  EXPECT_FALSE(Find(code, "counter")->codes()[0]->lazy());
+  EXPECT_TRUE(Find(code, "unused")->codes().empty());
+}
+
+TEST(RailgunLazyCodeCase, FoldedRegistersTest) {
+  // whole code is compiled at once in folded registers mode
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::Error::Standard e;
+  std::shared_ptr<iv::core::FileSource>
+      src(new iv::core::FileSource(iv::core::string_view(kSource), "lazy"));
+  iv::lv5::railgun::Code* code =
+      iv::lv5::railgun::CompileInGlobal(&ctx, src, true, &e);
+  ASSERT_FALSE(e);
+  ASSERT_TRUE(code);
+  for (iv::lv5::railgun::Code* sub : code->codes()) {
+    EXPECT_FALSE(sub->lazy());
+  }
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "test_railgun.h"
+
+TEST(RailgunPolyICCase, PolymorphicTest) {
+  using iv::lv5::railgun::Profiler;
+  iv::lv5::railgun::Context ctx;
+  Profiler* profiler = ctx.vm()->profiler();
+  profiler->Enable();
+  Execute(&ctx,
+          "function A() { this.x = 1; }\n"
+          "function B() { this.y = 0; this.x = 2; }\n"
+          "function C() { }\n"
+          "C.prototype.x = 3;\n"
+          "var objs = [new A(), new B(), new C(), { x: 4 }];\n"
+          "function get(o) { return o.x; }\n"
+          "var sum = 0;\n"
+          "for (var i = 0; i < 4000; ++i) { sum += get(objs[i % 4]); }\n"
+          "assert(sum === 10000);\n"
+          "C.prototype.x = 5;\n"
+          "assert(get(new C()) === 5);\n"
+          "var c = new C();\n"
+          "c.x = 6;\n"
+          "assert(get(c) === 6);\n"
+          "assert(get('str') === undefined);\n"
+          "String.prototype.x = 7;\n"
+          "assert(get('str') === 7);\n",
+          "poly");
+  profiler->Disable();
+  // polymorphic site hits after its cache is filled
+  EXPECT_GT(profiler->load_prop()[Profiler::IC_HIT],
+            profiler->load_prop()[Profiler::IC_MISS] * 10);
+}
+
+TEST(RailgunPolyICCase, MegamorphicTest) {
+  iv::lv5::railgun::Context ctx;
+  Execute(&ctx,
+          "var objs = [];\n"
+          "for (var i = 0; i < 16; ++i) {\n"
+          "  var o = {};\n"
+          "  o['p' + i] = i;\n"
+          "  o.x = i;\n"
+          "  objs.push(o);\n"
+          "}\n"
+          "function get(o) { return o.x; }\n"
+          "for (var n = 0; n < 10; ++n) {\n"
+          "  for (var i = 0; i < objs.length; ++i) {\n"
+          "    assert(get(objs[i]) === i);\n"
+          "  }\n"
+          "}\n"
+          "objs[3].x = 20;\n"
+          "assert(get(objs[3]) === 20);\n"
+          "delete objs[4].x;\n"
+          "assert(get(objs[4]) === undefined);\n"
+          "Object.prototype.x = 30;\n"
+          "assert(get(objs[4]) === 30);\n"
+          "assert(get(objs[5]) === 5);\n"
+          "Object.defineProperty(objs[6], 'x', {\n"
+          "  get: function() { return 40; }\n"
+          "});\n"
+          "assert(get(objs[6]) === 40);\n",
+          "poly");
+}
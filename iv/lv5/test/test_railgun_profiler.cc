@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include "test_railgun.h"
+
+TEST(RailgunProfilerCase, DisabledTest) {
+  iv::lv5::railgun::Context ctx;
+  Execute(&ctx, "var i = 0; while (i < 100) { i += 1; }", "profile");
+  const iv::lv5::railgun::Profiler* profiler = ctx.vm()->profiler();
+  EXPECT_FALSE(profiler->enabled());
+  EXPECT_EQ(0u, profiler->counts()[iv::lv5::railgun::OP::JUMP_BY]);
+  EXPECT_TRUE(profiler->codes().empty());
+}
+
+TEST(RailgunProfilerCase, RecordTest) {
+  using iv::lv5::railgun::OP;
+  using iv::lv5::railgun::Profiler;
+  iv::lv5::railgun::Context ctx;
+  Profiler* profiler = ctx.vm()->profiler();
+  profiler->Enable();
+  Execute(&ctx,
+          "function Point(x) { this.x = x; }\n"
+          "var sum = 0;\n"
+          "for (var i = 0; i < 5000; ++i) {\n"
+          "  var p = new Point(i);\n"
+          "  p.x = i;\n"
+          "  sum += p.x;\n"
+          "}\n",
+          "profile");
+  profiler->Disable();
+
+  EXPECT_GT(profiler->counts()[OP::RETURN], 5000u);
+  uint64_t pairs = 0;
+  for (std::size_t first = 0; first < OP::NUM_OF_OP; ++first) {
+    for (std::size_t second = 0; second < OP::NUM_OF_OP; ++second) {
+      pairs += profiler->pair(static_cast<OP::Type>(first),
+                              static_cast<OP::Type>(second));
+    }
+  }
+  EXPECT_GT(pairs, 0u);
+  EXPECT_FALSE(profiler->codes().empty());
+
+  // monomorphic accesses hit after cache is filled
+  EXPECT_GT(profiler->load_prop()[Profiler::IC_HIT],
+            profiler->load_prop()[Profiler::IC_MISS]);
+  EXPECT_GT(profiler->store_prop()[Profiler::IC_HIT] +
+            profiler->store_prop()[Profiler::IC_MISS] +
+            profiler->store_prop()[Profiler::IC_GENERIC], 0u);
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_TRUE(file);
+  profiler->DumpJSON(file);
+  const std::string json = ReadAll(file);
+  std::fclose(file);
+  EXPECT_EQ(0u, json.find("{\"sample_interval\":"));
+  EXPECT_NE(std::string::npos, json.find("\"opcodes\":[{\"op\":"));
+  EXPECT_NE(std::string::npos, json.find("\"pairs\":[{\"first\":"));
+  EXPECT_NE(std::string::npos, json.find("\"codes\":[{\"code\":"));
+  EXPECT_NE(std::string::npos, json.find("\"ic\":{\"load_prop\":{\"hit\":"));
+
+  profiler->Clear();
+  EXPECT_EQ(0u, profiler->counts()[OP::RETURN]);
+  EXPECT_TRUE(profiler->codes().empty());
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+#include "test_railgun.h"
+namespace {
+
+static const std::string kSource = kAssertFunction +
+    "function fib(n) { if (n < 2) { return n; } "
+    "return fib(n - 1) + fib(n - 2); }\n"
+    "function add(a, b) { return a + b; }\n"
+    "function id(a) { var b = a; return b; }\n"
+    "var sum = 0;\n"
+    "for (var i = 0; i < 100; ++i) { sum = sum + 1; }\n"
+    "assert(sum === 100);\n"
+    "assert(fib(15) === 610);\n"
+    "assert(add(1, 2) === 3);\n"
+    "assert(add(2147483647, 1) === 2147483648);\n"
+    "assert(add('a', 1) === 'a1');\n"
+    "assert(id('b') === 'b');\n"
+    "var x = -2147483648;\n"
+    "assert(x - 0.5 === -2147483648.5);\n"
+    "assert('3' - 1 === 2);\n"
+    "var count = 0;\n"
+    "while (count < 5) { count = count + 1; }\n"
+    "assert(count === 5);\n"
+    "var caught = false;\n"
+    "try {\n"
+    "  var obj = { valueOf: function() { throw 1; } };\n"
+    "  obj - 1;\n"
+    "} catch (e) {\n"
+    "  caught = (e === 1);\n"
+    "}\n"
+    "assert(caught);\n"
+    "function Point(x) { this.x = x; return x + 1; }\n"
+    "assert(new Point(2).x === 2);\n";
+
+uint64_t Execute(bool superinstruction) {
+  iv::lv5::railgun::Context ctx;
+  ctx.set_superinstruction_enabled(superinstruction);
+  iv::lv5::railgun::Profiler* profiler = ctx.vm()->profiler();
+  profiler->Enable();
+  iv::lv5::Error::Standard e;
+  std::shared_ptr<iv::core::FileSource>
+      src(new iv::core::FileSource(iv::core::string_view(kSource),
+                                   "superinstruction"));
+  iv::lv5::railgun::ExecuteInGlobal(&ctx, src, &e);
+  profiler->Disable();
+  if (e) {
+    e.Dump(&ctx, stderr);
+    ADD_FAILURE() << superinstruction;
+    return 0;
+  }
+  const iv::lv5::railgun::Profiler::Counts& counts = profiler->counts();
+  if (superinstruction) {
+    using iv::lv5::railgun::OP;
+    EXPECT_GT(counts[OP::LOAD_CONST_BINARY_ADD], 0u);
+    EXPECT_GT(counts[OP::LOAD_CONST_BINARY_SUBTRACT], 0u);
+    EXPECT_GT(counts[OP::LOAD_CONST_IF_FALSE_BINARY_LT], 0u);
+    EXPECT_GT(counts[OP::BINARY_ADD_RETURN], 0u);
+    EXPECT_GT(counts[OP::MV_RETURN], 0u);
+  }
+  return std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+}
+
+}  // namespace anonymous
+
+TEST(RailgunSuperinstructionCase, DispatchTest) {
+  const uint64_t fused = Execute(true);
+  const uint64_t plain = Execute(false);
+  EXPECT_GT(fused, 0u);
+  EXPECT_LT(fused, plain);
+}
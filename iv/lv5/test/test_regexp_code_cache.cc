@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <iv/space.h>
+#include <iv/aero/aero.h>
+#include <iv/lv5/lv5.h>
+#include <iv/lv5/railgun/railgun.h>
+#include <iv/lv5/regexp_code_cache.h>
+namespace {
+
+std::shared_ptr<iv::aero::Code> Compile(iv::core::Space* space,
+                                        const char* pattern) {
+  int error = 0;
+  std::shared_ptr<iv::aero::Code> code(
+      iv::aero::Compile(space, iv::core::string_view(pattern), 0, &error));
+  EXPECT_FALSE(error);
+  return code;
+}
+
+iv::lv5::RegExpCodeCache::Key Key(const char* pattern, int flags) {
+  const iv::core::string_view view(pattern);
+  return iv::lv5::RegExpCodeCache::Key(
+      std::u16string(view.begin(), view.end()), flags);
+}
+
+}  // namespace anonymous
+
+TEST(RegExpCodeCacheCase, LRUTest) {
+  iv::core::Space space;
+  iv::lv5::RegExpCodeCache cache(2);
+  std::shared_ptr<iv::aero::Code> a = Compile(&space, "a");
+  std::shared_ptr<iv::aero::Code> b = Compile(&space, "b");
+  std::shared_ptr<iv::aero::Code> c = Compile(&space, "c");
+  EXPECT_FALSE(cache.Lookup(Key("a", 0)));
+  cache.Insert(Key("a", 0), a);
+  cache.Insert(Key("b", 0), b);
+  EXPECT_EQ(a, cache.Lookup(Key("a", 0)));
+  // flags are a part of the key
+  EXPECT_FALSE(cache.Lookup(Key("a", iv::aero::IGNORE_CASE)));
+  // b is least recently used
+  cache.Insert(Key("c", 0), c);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_FALSE(cache.Lookup(Key("b", 0)));
+  EXPECT_EQ(a, cache.Lookup(Key("a", 0)));
+  EXPECT_EQ(c, cache.Lookup(Key("c", 0)));
+  EXPECT_EQ(3u, cache.hits());
+  EXPECT_EQ(3u, cache.misses());
+}
+
+TEST(RegExpCodeCacheCase, SharedByRegExpTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::RegExpCodeCache* cache = ctx.global_data()->regexp_code_cache();
+  const uint64_t hits = cache->hits();
+  const uint64_t misses = cache->misses();
+  iv::lv5::RegExp* first = new iv::lv5::RegExp(
+      &ctx, iv::core::string_view("(a+)b"), iv::lv5::RegExp::GLOBAL);
+  iv::lv5::RegExp* second = new iv::lv5::RegExp(
+      &ctx, iv::core::u16string_view(u"(a+)b"), iv::lv5::RegExp::NONE);
+  ASSERT_TRUE(first->IsValid());
+  ASSERT_TRUE(second->IsValid());
+  EXPECT_EQ(misses + 1, cache->misses());
+  EXPECT_EQ(hits + 1, cache->hits());
+  EXPECT_EQ(2, second->number_of_captures());
+  int offset_vector[4] = { };
+  EXPECT_EQ(iv::aero::AERO_SUCCESS,
+            second->Execute(&ctx, iv::core::string_view("xaab"),
+                            0, offset_vector));
+  EXPECT_EQ(1, offset_vector[0]);
+  EXPECT_EQ(4, offset_vector[1]);
+
+  // ignore case is compiled separately
+  iv::lv5::RegExp* third = new iv::lv5::RegExp(
+      &ctx, iv::core::string_view("(a+)b"), iv::lv5::RegExp::IGNORE_CASE);
+  ASSERT_TRUE(third->IsValid());
+  EXPECT_EQ(misses + 2, cache->misses());
+
+  // failed compilation is not cached
+  const std::size_t size = cache->size();
+  iv::lv5::RegExp* invalid = new iv::lv5::RegExp(
+      &ctx, iv::core::string_view("(a+"), iv::lv5::RegExp::NONE);
+  EXPECT_FALSE(invalid->IsValid());
+  EXPECT_EQ(size, cache->size());
+}
+
+TEST(RegExpCodeCacheCase, ScriptTest) {
+  iv::lv5::railgun::Context ctx;
+  iv::lv5::Error::Standard e;
+  std::shared_ptr<iv::core::FileSource> src(new iv::core::FileSource(
+      iv::core::string_view(
+          "function match(str) { return new RegExp('k(e)y', 'g').test(str); }\n"
+          "for (var i = 0; i < 10; ++i) {\n"
+          "  if (!match('key')) throw new Error('failed');\n"
+          "}\n"),
+      "regexp_code_cache"));
+  iv::lv5::railgun::Code* code =
+      iv::lv5::railgun::CompileInGlobal(&ctx, src, false, &e);
+  ASSERT_FALSE(e);
+  ASSERT_TRUE(code);
+  const uint64_t hits = ctx.global_data()->regexp_code_cache()->hits();
+  ctx.vm()->Run(code, &e);
+  if (e) {
+    e.Dump(&ctx, stderr);
+    FAIL();
+  }
+  EXPECT_LE(hits + 9, ctx.global_data()->regexp_code_cache()->hits());
+}
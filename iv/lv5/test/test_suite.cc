@@ -51,9 +51,11 @@ static void ExecuteInBreakerContext(lv5::breaker::Context* ctx,
   ASSERT_TRUE(core::io::ReadFile(filename, &res)) << filename;
   std::shared_ptr<core::FileSource> src(
       new core::FileSource(core::string_view(res.data(), res.size()), filename));
-  lv5::railgun::Code* code = Compile(ctx, src, true);
+  lv5::railgun::Code* code = Compile(ctx, src, !ctx->IsTiered());
   ASSERT_TRUE(code) << filename;
-  iv::lv5::breaker::Compile(ctx, code);
+  if (!ctx->IsTiered()) {
+    iv::lv5::breaker::Compile(ctx, code);
+  }
   iv::lv5::breaker::Run(ctx, code, e);
 }
 
@@ -81,6 +83,33 @@ TEST(SuiteCase, BreakerPassTest) {
   ExecuteInBreakerContext(&ctx, "iv/lv5/test/suite/resources/driver.js", &e);
   EXPECT_FALSE(e);
 }
+
+TEST(SuiteCase, BreakerTieredPassTest) {
+  lv5::Init();
+  lv5::Error::Standard e;
+  lv5::breaker::Context ctx;
+  // small threshold, so both interpreted and compiled code are executed
+  ctx.set_tier_up_threshold(2);
+  ctx.DefineFunction<&lv5::Print, 1>("print");
+  ctx.DefineFunction<&lv5::Log, 1>("log");
+  ctx.DefineFunction<&lv5::Quit, 1>("quit");
+  ctx.DefineFunction<&lv5::HiResTime, 0>("HiResTime");
+  ctx.DefineFunction<&lv5::breaker::Run, 0>("run");
+  ctx.DefineFunction<&lv5::railgun::Dis, 1>("dis");
+
+  ExecuteInBreakerContext(&ctx, "iv/lv5/test/suite/resources/jasmine.js", &e);
+  ASSERT_FALSE(e);
+  ExecuteInBreakerContext(&ctx, "iv/lv5/test/suite/resources/ConsoleReporter.js", &e);
+  ASSERT_FALSE(e);
+  const std::vector<std::string> files = GetTests();
+  for (std::vector<std::string>::const_iterator it = files.begin(),
+       last = files.end(); it != last; ++it) {
+    ExecuteInBreakerContext(&ctx, *it, &e);
+    ASSERT_FALSE(e);
+  }
+  ExecuteInBreakerContext(&ctx, "iv/lv5/test/suite/resources/driver.js", &e);
+  EXPECT_FALSE(e);
+}
 #endif
 
 static void ExecuteInRailgunContext(lv5::railgun::Context* ctx,
@@ -229,6 +229,26 @@ class Parser : private Noncopyable<> {
                                      1) : nullptr;
   }
 
+// FunctionLiteral which begins at the position of the source.
+// used for reparsing a function of the program parsed before,
+// so strict mode of enclosing code should be given by set_strict.
+// references to the variables of enclosing code are left unresolved
+  FunctionLiteral* ParseFunctionLiteralAt(
+      std::size_t begin_position,
+      std::size_t line_number,
+      typename FunctionLiteral::DeclType decl_type,
+      typename FunctionLiteral::ArgType arg_type) {
+    assert(target_ == nullptr);
+    assert(environment_ == nullptr);
+    bool error_flag = true;
+    bool *res = &error_flag;
+    lexer_.Seek(begin_position, line_number);
+    Next();
+    FunctionLiteral* const literal =
+        ParseFunctionLiteral(decl_type, arg_type, IV_CHECK);
+    return (error_flag) ? literal : nullptr;
+  }
+
 // SourceElements
 //   : SourceElement
 //   | SourceElement SourceElements
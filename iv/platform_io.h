@@ -2,8 +2,15 @@
 #define IV_PLATFORM_IO_H_
 #include <iv/utils.h>
 #include <iv/string_view.h>
+#include <iv/noncopyable.h>
 #include <vector>
 #include <string>
+#if !defined(IV_OS_WIN)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 namespace iv {
 namespace core {
 namespace io {
@@ -50,5 +57,67 @@ inline bool ReadFile(const std::string& filename,
   }
 }
 
+// read only file mapped to memory.
+// if mmap is not available, file is read to buffer
+class MappedFile : private Noncopyable<MappedFile> {
+ public:
+  MappedFile()
+    : data_(nullptr),
+      size_(0),
+      buffer_() {
+  }
+
+  ~MappedFile() {
+#if !defined(IV_OS_WIN)
+    if (data_ && buffer_.empty()) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+  }
+
+  bool Open(const std::string& filename, bool output_error = true) {
+    assert(!data_);
+#if defined(IV_OS_WIN)
+    if (!ReadFile(filename, &buffer_, output_error) || buffer_.empty()) {
+      return false;
+    }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+      if (output_error) {
+        const std::string err = "lv5 can't open \"" + filename + "\"";
+        std::perror(err.c_str());
+      }
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+      close(fd);
+      return false;
+    }
+    void* mem = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+      return false;
+    }
+    data_ = static_cast<const char*>(mem);
+    size_ = st.st_size;
+    return true;
+#endif
+  }
+
+  const char* data() const { return data_; }
+
+  std::size_t size() const { return size_; }
+
+ private:
+  const char* data_;
+  std::size_t size_;
+  std::vector<char> buffer_;
+};
+
 } } }  // namespace iv::core::io
 #endif  // IV_PLATFORM_IO_H_
@@ -0,0 +1,348 @@
+// vectorized UTF-16 search kernels
+//
+// SSE2 kernels are always available on x64, AVX2 kernels are selected at
+// runtime by CPUID. unlike mie string functions, these kernels never read
+// beyond the given range, so they can be applied to any buffer.
+//
+// substring search uses first / last character filter. candidate positions
+// where both the first and last characters of the needle are matched are
+// found by vector comparison and only these are compared precisely.
+// the needle may be an 8bit string, its characters are widened one by one,
+// so the needle is not copied.
+#ifndef IV_STRING_SIMD_H_
+#define IV_STRING_SIMD_H_
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iv/platform.h>
+#if defined(IV_ENABLE_JIT)
+#include <emmintrin.h>
+#include <immintrin.h>
+#include <xbyak/xbyak_util.h>
+namespace iv {
+namespace core {
+namespace simd {
+
+// keys more than this are searched by scalar loop
+static const std::size_t kMaxAnyKeys = 8;
+
+inline bool IsAvailableAVX2() {
+  static const bool enabled =
+      Xbyak::util::Cpu().has(Xbyak::util::Cpu::tAVX2);
+  return enabled;
+}
+
+inline char16_t Widen(char16_t ch) {
+  return ch;
+}
+
+inline char16_t Widen(char ch) {
+  return static_cast<unsigned char>(ch);
+}
+
+struct WidenEqual {
+  template<typename LHS, typename RHS>
+  bool operator()(LHS lhs, RHS rhs) const {
+    return Widen(lhs) == Widen(rhs);
+  }
+};
+
+// index of character from non-zero comparison mask (2 bits per char16_t)
+inline std::size_t FirstIndex(uint32_t mask) {
+  return static_cast<std::size_t>(__builtin_ctz(mask)) >> 1;
+}
+
+inline std::size_t LastIndex(uint32_t mask) {
+  return static_cast<std::size_t>(31 - __builtin_clz(mask)) >> 1;
+}
+
+// SSE2
+
+inline uint32_t Mask(__m128i lhs, __m128i rhs) {
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(lhs, rhs)));
+}
+
+inline __m128i Load128(const char16_t* ptr) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+
+inline const char16_t* FindCharSSE2(const char16_t* it,
+                                    const char16_t* last, char16_t ch) {
+  const __m128i key = _mm_set1_epi16(static_cast<int16_t>(ch));
+  for (; last - it >= 8; it += 8) {
+    if (const uint32_t mask = Mask(Load128(it), key)) {
+      return it + FirstIndex(mask);
+    }
+  }
+  for (; it != last; ++it) {
+    if (*it == ch) {
+      return it;
+    }
+  }
+  return nullptr;
+}
+
+inline const char16_t* FindLastCharSSE2(const char16_t* begin,
+                                        const char16_t* last, char16_t ch) {
+  const __m128i key = _mm_set1_epi16(static_cast<int16_t>(ch));
+  for (; last - begin >= 8; last -= 8) {
+    if (const uint32_t mask = Mask(Load128(last - 8), key)) {
+      return last - 8 + LastIndex(mask);
+    }
+  }
+  while (last != begin) {
+    if (*--last == ch) {
+      return last;
+    }
+  }
+  return nullptr;
+}
+
+inline const char16_t* FindCharAnySSE2(const char16_t* it,
+                                       const char16_t* last,
+                                       const char16_t* key,
+                                       std::size_t key_size) {
+  __m128i keys[kMaxAnyKeys];
+  for (std::size_t i = 0; i < key_size; ++i) {
+    keys[i] = _mm_set1_epi16(static_cast<int16_t>(key[i]));
+  }
+  for (; last - it >= 8; it += 8) {
+    const __m128i chunk = Load128(it);
+    __m128i matched = _mm_setzero_si128();
+    for (std::size_t i = 0; i < key_size; ++i) {
+      matched = _mm_or_si128(matched, _mm_cmpeq_epi16(chunk, keys[i]));
+    }
+    if (const uint32_t mask = _mm_movemask_epi8(matched)) {
+      return it + FirstIndex(mask);
+    }
+  }
+  for (; it != last; ++it) {
+    if (std::find(key, key + key_size, *it) != key + key_size) {
+      return it;
+    }
+  }
+  return last;
+}
+
+// needle size >= 2
+template<typename Needle>
+inline const char16_t* SearchSSE2(const char16_t* i, const char16_t* iz,
+                                  const Needle* j, const Needle* jz) {
+  const std::size_t size = jz - j;
+  const __m128i first = _mm_set1_epi16(static_cast<int16_t>(Widen(j[0])));
+  const __m128i tail =
+      _mm_set1_epi16(static_cast<int16_t>(Widen(j[size - 1])));
+  // candidate positions are [i, stop)
+  const char16_t* const stop = iz - size + 1;
+  for (; stop - i >= 8; i += 8) {
+    uint32_t mask = Mask(Load128(i), first) & Mask(Load128(i + size - 1), tail);
+    while (mask) {
+      const std::size_t index = FirstIndex(mask);
+      if (std::equal(j + 1, jz - 1, i + index + 1, WidenEqual())) {
+        return i + index;
+      }
+      mask &= ~(UINT32_C(3) << (index * 2));
+    }
+  }
+  return std::search(i, iz, j, jz, WidenEqual());
+}
+
+// needle size >= 2
+template<typename Needle>
+inline const char16_t* SearchLastSSE2(const char16_t* i, const char16_t* iz,
+                                      const Needle* j, const Needle* jz) {
+  const std::size_t size = jz - j;
+  const __m128i first = _mm_set1_epi16(static_cast<int16_t>(Widen(j[0])));
+  const __m128i tail =
+      _mm_set1_epi16(static_cast<int16_t>(Widen(j[size - 1])));
+  const char16_t* stop = iz - size + 1;
+  for (; stop - i >= 8; stop -= 8) {
+    const char16_t* const block = stop - 8;
+    uint32_t mask =
+        Mask(Load128(block), first) & Mask(Load128(block + size - 1), tail);
+    while (mask) {
+      const std::size_t index = LastIndex(mask);
+      if (std::equal(j + 1, jz - 1, block + index + 1, WidenEqual())) {
+        return block + index;
+      }
+      mask &= ~(UINT32_C(3) << (index * 2));
+    }
+  }
+  const char16_t* const last = stop + size - 1;
+  const char16_t* const result = std::find_end(i, last, j, jz, WidenEqual());
+  return (result == last) ? iz : result;
+}
+
+// AVX2
+
+#define IV_STRING_SIMD_AVX2 __attribute__((target("avx2")))
+
+IV_STRING_SIMD_AVX2
+inline uint32_t Mask(__m256i lhs, __m256i rhs) {
+  return static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi16(lhs, rhs)));
+}
+
+IV_STRING_SIMD_AVX2
+inline __m256i Load256(const char16_t* ptr) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+IV_STRING_SIMD_AVX2
+inline const char16_t* FindCharAVX2(const char16_t* it,
+                                    const char16_t* last, char16_t ch) {
+  const __m256i key = _mm256_set1_epi16(static_cast<int16_t>(ch));
+  for (; last - it >= 16; it += 16) {
+    if (const uint32_t mask = Mask(Load256(it), key)) {
+      return it + FirstIndex(mask);
+    }
+  }
+  return FindCharSSE2(it, last, ch);
+}
+
+IV_STRING_SIMD_AVX2
+inline const char16_t* FindLastCharAVX2(const char16_t* begin,
+                                        const char16_t* last, char16_t ch) {
+  const __m256i key = _mm256_set1_epi16(static_cast<int16_t>(ch));
+  for (; last - begin >= 16; last -= 16) {
+    if (const uint32_t mask = Mask(Load256(last - 16), key)) {
+      return last - 16 + LastIndex(mask);
+    }
+  }
+  return FindLastCharSSE2(begin, last, ch);
+}
+
+IV_STRING_SIMD_AVX2
+inline const char16_t* FindCharAnyAVX2(const char16_t* it,
+                                       const char16_t* last,
+                                       const char16_t* key,
+                                       std::size_t key_size) {
+  __m256i keys[kMaxAnyKeys];
+  for (std::size_t i = 0; i < key_size; ++i) {
+    keys[i] = _mm256_set1_epi16(static_cast<int16_t>(key[i]));
+  }
+  for (; last - it >= 16; it += 16) {
+    const __m256i chunk = Load256(it);
+    __m256i matched = _mm256_setzero_si256();
+    for (std::size_t i = 0; i < key_size; ++i) {
+      matched = _mm256_or_si256(matched, _mm256_cmpeq_epi16(chunk, keys[i]));
+    }
+    if (const uint32_t mask = _mm256_movemask_epi8(matched)) {
+      return it + FirstIndex(mask);
+    }
+  }
+  return FindCharAnySSE2(it, last, key, key_size);
+}
+
+template<typename Needle>
+IV_STRING_SIMD_AVX2
+inline const char16_t* SearchAVX2(const char16_t* i, const char16_t* iz,
+                                  const Needle* j, const Needle* jz) {
+  const std::size_t size = jz - j;
+  const __m256i first = _mm256_set1_epi16(static_cast<int16_t>(Widen(j[0])));
+  const __m256i tail =
+      _mm256_set1_epi16(static_cast<int16_t>(Widen(j[size - 1])));
+  const char16_t* const stop = iz - size + 1;
+  for (; stop - i >= 16; i += 16) {
+    uint32_t mask = Mask(Load256(i), first) & Mask(Load256(i + size - 1), tail);
+    while (mask) {
+      const std::size_t index = FirstIndex(mask);
+      if (std::equal(j + 1, jz - 1, i + index + 1, WidenEqual())) {
+        return i + index;
+      }
+      mask &= ~(UINT32_C(3) << (index * 2));
+    }
+  }
+  return SearchSSE2(i, iz, j, jz);
+}
+
+template<typename Needle>
+IV_STRING_SIMD_AVX2
+inline const char16_t* SearchLastAVX2(const char16_t* i, const char16_t* iz,
+                                      const Needle* j, const Needle* jz) {
+  const std::size_t size = jz - j;
+  const __m256i first = _mm256_set1_epi16(static_cast<int16_t>(Widen(j[0])));
+  const __m256i tail =
+      _mm256_set1_epi16(static_cast<int16_t>(Widen(j[size - 1])));
+  const char16_t* stop = iz - size + 1;
+  for (; stop - i >= 16; stop -= 16) {
+    const char16_t* const block = stop - 16;
+    uint32_t mask =
+        Mask(Load256(block), first) & Mask(Load256(block + size - 1), tail);
+    while (mask) {
+      const std::size_t index = LastIndex(mask);
+      if (std::equal(j + 1, jz - 1, block + index + 1, WidenEqual())) {
+        return block + index;
+      }
+      mask &= ~(UINT32_C(3) << (index * 2));
+    }
+  }
+  const char16_t* const last = stop + size - 1;
+  const char16_t* const result = SearchLastSSE2(i, last, j, jz);
+  return (result == last) ? iz : result;
+}
+
+#undef IV_STRING_SIMD_AVX2
+
+// dispatchers
+
+inline const char16_t* FindChar(const char16_t* it,
+                                const char16_t* last, char16_t ch) {
+  return IsAvailableAVX2() ?
+      FindCharAVX2(it, last, ch) : FindCharSSE2(it, last, ch);
+}
+
+inline const char16_t* FindLastChar(const char16_t* begin,
+                                    const char16_t* last, char16_t ch) {
+  return IsAvailableAVX2() ?
+      FindLastCharAVX2(begin, last, ch) : FindLastCharSSE2(begin, last, ch);
+}
+
+inline const char16_t* FindCharAny(const char16_t* it,
+                                   const char16_t* last,
+                                   const char16_t* key,
+                                   std::size_t key_size) {
+  assert(key_size <= kMaxAnyKeys);
+  return IsAvailableAVX2() ?
+      FindCharAnyAVX2(it, last, key, key_size) :
+      FindCharAnySSE2(it, last, key, key_size);
+}
+
+template<typename Needle>
+inline const char16_t* Search(const char16_t* i, const char16_t* iz,
+                              const Needle* j, const Needle* jz) {
+  const std::ptrdiff_t size = jz - j;
+  if (size == 0) {
+    return i;
+  }
+  if (iz - i < size) {
+    return iz;
+  }
+  if (size == 1) {
+    const char16_t* const result = FindChar(i, iz, Widen(*j));
+    return (result) ? result : iz;
+  }
+  return IsAvailableAVX2() ?
+      SearchAVX2(i, iz, j, jz) : SearchSSE2(i, iz, j, jz);
+}
+
+// same as std::find_end
+template<typename Needle>
+inline const char16_t* SearchLast(const char16_t* i, const char16_t* iz,
+                                  const Needle* j, const Needle* jz) {
+  const std::ptrdiff_t size = jz - j;
+  if (size == 0 || iz - i < size) {
+    return iz;
+  }
+  if (size == 1) {
+    const char16_t* const result = FindLastChar(i, iz, Widen(*j));
+    return (result) ? result : iz;
+  }
+  return IsAvailableAVX2() ?
+      SearchLastAVX2(i, iz, j, jz) : SearchLastSSE2(i, iz, j, jz);
+}
+
+} } }  // namespace iv::core::simd
+#endif  // defined(IV_ENABLE_JIT)
+#endif  // IV_STRING_SIMD_H_
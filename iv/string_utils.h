@@ -5,6 +5,7 @@
 #include <iv/platform.h>
 #if defined(IV_ENABLE_JIT)
 #include <iv/third_party/mie/string.hpp>
+#include <iv/string_simd.h>
 #endif
 namespace iv {
 namespace core {
@@ -25,6 +26,42 @@ inline const char* Search<const char*, const char*>(
   }
   return mie::findStr(i, iz, j, jz - j);
 }
+
+template<>
+inline const char16_t* Search<const char16_t*, const char16_t*>(
+    const char16_t* i, const char16_t* iz,
+    const char16_t* j, const char16_t* jz) {
+  return simd::Search(i, iz, j, jz);
+}
+
+template<>
+inline const char16_t* Search<const char16_t*, const char*>(
+    const char16_t* i, const char16_t* iz,
+    const char* j, const char* jz) {
+  return simd::Search(i, iz, j, jz);
+}
+#endif
+
+// same as std::find_end
+template<typename Iter, typename Iter2>
+inline Iter SearchLast(Iter i, Iter iz, Iter2 j, Iter2 jz) {
+  return std::find_end(i, iz, j, jz);
+}
+
+#if defined(IV_ENABLE_JIT)
+template<>
+inline const char16_t* SearchLast<const char16_t*, const char16_t*>(
+    const char16_t* i, const char16_t* iz,
+    const char16_t* j, const char16_t* jz) {
+  return simd::SearchLast(i, iz, j, jz);
+}
+
+template<>
+inline const char16_t* SearchLast<const char16_t*, const char*>(
+    const char16_t* i, const char16_t* iz,
+    const char* j, const char* jz) {
+  return simd::SearchLast(i, iz, j, jz);
+}
 #endif
 
 template<typename char_type>
@@ -56,6 +93,34 @@ inline const char* FindChar<char>(const char* begin,
   }
   return result;
 }
+
+template<>
+inline const char16_t* FindChar<char16_t>(const char16_t* begin,
+                                          const char16_t* end,
+                                          char16_t ch) {
+  return simd::FindChar(begin, end, ch);
+}
+#endif
+
+template<typename char_type>
+inline const char_type* FindLastChar(const char_type* begin,
+                                     const char_type* end,
+                                     char_type ch) {
+  while (begin != end) {
+    if (*--end == ch) {
+      return end;
+    }
+  }
+  return nullptr;
+}
+
+#if defined(IV_ENABLE_JIT)
+template<>
+inline const char16_t* FindLastChar<char16_t>(const char16_t* begin,
+                                              const char16_t* end,
+                                              char16_t ch) {
+  return simd::FindLastChar(begin, end, ch);
+}
 #endif
 
 template<typename char_type>
@@ -90,14 +155,21 @@ inline const char* FindCharAny<char>(const char* begin,
                                      const char* key,
                                      size_t key_size) {
   static const bool enabled = mie::isAvailableSSE42();
-  if (!enabled) {
+  if (!enabled || key_size == 0 || key_size > 16) {
     return FindCharAnyFallback(begin, end, key, key_size);
   }
-  const char* result = mie::findChar_any(begin, end, key, key_size);
-  if (result == end) {
-    return nullptr;
+  return mie::findChar_any(begin, end, key, key_size);
+}
+
+template<>
+inline const char16_t* FindCharAny<char16_t>(const char16_t* begin,
+                                             const char16_t* end,
+                                             const char16_t* key,
+                                             size_t key_size) {
+  if (key_size > simd::kMaxAnyKeys) {
+    return FindCharAnyFallback(begin, end, key, key_size);
   }
-  return result;
+  return simd::FindCharAny(begin, end, key, key_size);
 }
 #endif
 
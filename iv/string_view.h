@@ -162,6 +162,21 @@ struct string_viewFindOf<char, Piece> {
   }
 };
 
+// char is searched by Traits::find (memchr), it is already vectorized and
+// never reads beyond the range. char16_t is searched by SIMD kernel.
+template<class CharT, class Traits>
+inline const CharT* string_viewFindChar(const CharT* begin,
+                                        const CharT* end, CharT c) {
+  return Traits::find(begin, end - begin, c);
+}
+
+template<>
+inline const char16_t* string_viewFindChar<char16_t,
+                                           std::char_traits<char16_t> >(
+    const char16_t* begin, const char16_t* end, char16_t c) {
+  return FindChar(begin, end, c);
+}
+
 }  // namespace detail
 
 template<class CharT, class Traits = std::char_traits<CharT> >
@@ -385,7 +400,9 @@ class basic_string_view {
     if (pos >= length_) {
       return npos;
     }
-    const const_pointer result = Traits::find(ptr_ + pos, length_ - pos, c);
+    const const_pointer result =
+        detail::string_viewFindChar<CharT, Traits>(ptr_ + pos,
+                                                   ptr_ + length_, c);
     return (result) ? static_cast<size_type>(result - ptr_) : npos;
   }
 
@@ -402,7 +419,8 @@ class basic_string_view {
 
     const const_pointer this_last =
         ptr_ + std::min(length_ - dis, pos) + dis;
-    const const_pointer result = std::find_end(ptr_, this_last, it, last);
+    const const_pointer result =
+        SearchLast<const CharT*, Iter>(ptr_, this_last, it, last);
     return result != this_last ? static_cast<size_type>(result - ptr_) : npos;
   }
 
@@ -417,8 +435,8 @@ class basic_string_view {
 
     const const_pointer last =
         ptr_ + std::min(length_ - s.length_, pos) + s.length_;
-    const const_pointer result = std::find_end(ptr_, last,
-                                               s.ptr_, s.ptr_ + s.length_);
+    const const_pointer result = SearchLast<const CharT*, const CharT*>(
+        ptr_, last, s.ptr_, s.ptr_ + s.length_);
     return result != last ? static_cast<size_type>(result - ptr_) : npos;
   }
 
@@ -427,11 +445,8 @@ class basic_string_view {
       return npos;
     }
     const size_type index = std::min(pos, length_ - 1);
-    const const_reverse_iterator last = rend();
-    const const_reverse_iterator start = rbegin();
-    const const_reverse_iterator it =
-        std::find(start + ((length_ - 1) - index), last, c);
-    return (it == last) ? npos : ((length_ - 1) - (std::distance(start, it)));
+    const const_pointer result = FindLastChar(ptr_, ptr_ + index + 1, c);
+    return (result) ? static_cast<size_type>(result - ptr_) : npos;
   }
 
   size_type find_first_of(const this_type& s, size_type pos = 0) const {
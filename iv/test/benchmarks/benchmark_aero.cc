@@ -1742,6 +1742,85 @@ static void BM_AeroSunSpiderTest(benchmark::State& state) {
 }
 BENCHMARK(BM_AeroSunSpiderTest);
 
+// (a|aa)*b against a sequence of 'a' takes exponential time in backtracking
+static void BM_AeroAutomatonTest(benchmark::State& state) {
+  const std::string target(state.range_x(), 'a');
+  iv::core::Space space;
+  iv::aero::VM vm;
+  std::vector<int> vec(1000);
+  iv::aero::Parser<iv::core::string_view> parser(&space,
+                                                 "(a|aa)*b",
+                                                 iv::aero::NONE);
+  int error = 0;
+  iv::aero::ParsedData data = parser.ParsePattern(&error);
+  CHECK(!error);
+  iv::aero::Compiler compiler(iv::aero::NONE);
+  std::unique_ptr<iv::aero::Code> code(compiler.Compile(data));
+  CHECK(code->automaton());
+  while (state.KeepRunning()) {
+    CHECK(vm.Execute(code.get(), target, vec.data(), 0) ==
+          iv::aero::AERO_FAILURE);
+  }
+}
+BENCHMARK(BM_AeroAutomatonTest)->Arg(8)->Arg(16)->Arg(24)->Arg(1 << 10);
+
+#if defined(IV_ENABLE_JIT)
+static void BM_AeroBacktrackTest(benchmark::State& state) {
+  const std::string target(state.range_x(), 'a');
+  iv::core::Space space;
+  iv::aero::VM vm;
+  std::vector<int> vec(1000);
+  iv::aero::Parser<iv::core::string_view> parser(&space,
+                                                 "(a|aa)*b",
+                                                 iv::aero::NONE);
+  int error = 0;
+  iv::aero::ParsedData data = parser.ParsePattern(&error);
+  CHECK(!error);
+  iv::aero::Compiler compiler(iv::aero::NONE);
+  std::unique_ptr<iv::aero::Code> code(compiler.Compile(data));
+  while (state.KeepRunning()) {
+    CHECK(code->jit()->Execute(&vm, code.get(), target, vec.data(), 0) ==
+          iv::aero::AERO_FAILURE);
+  }
+}
+BENCHMARK(BM_AeroBacktrackTest)->Arg(8)->Arg(16)->Arg(24);
+#endif
+
+// keyword prefixed pattern against a large subject
+static void BM_AeroLiteralTest(benchmark::State& state) {
+  std::string target;
+  while (target.size() < (4 << 20)) {
+    target.append(DNA);
+  }
+  target.append("function main() { } 12-error-34");
+  const std::vector<std::string> regs = {
+    "function\\s+(\\w+)",
+    "\\d+-error-\\d+",
+    "function main"
+  };
+  iv::core::Space space;
+  iv::aero::VM vm;
+  std::vector<int> vec(1000);
+  std::vector<std::unique_ptr<iv::aero::Code> > codes;
+  for (const auto& str : regs) {
+    iv::aero::Parser<iv::core::string_view> parser(&space,
+                                                   str,
+                                                   iv::aero::NONE);
+    int error = 0;
+    iv::aero::ParsedData data = parser.ParsePattern(&error);
+    CHECK(!error);
+    iv::aero::Compiler compiler(iv::aero::NONE);
+    codes.push_back(std::unique_ptr<iv::aero::Code>(compiler.Compile(data)));
+  }
+  while (state.KeepRunning()) {
+    for (const auto& code : codes) {
+      CHECK(vm.Execute(code.get(), target, vec.data(), 0) ==
+            iv::aero::AERO_SUCCESS);
+    }
+  }
+}
+BENCHMARK(BM_AeroLiteralTest);
+
 int main(int argc, const char** argv) {
   benchmark::Initialize(&argc, argv);
   benchmark::RunSpecifiedBenchmarks();
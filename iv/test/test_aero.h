@@ -1,8 +1,25 @@
 #ifndef IV_TEST_LV5_AERO_H_
 #define IV_TEST_LV5_AERO_H_
+#include <gtest/gtest.h>
 #include <string>
+#include <iv/alloc.h>
+#include <iv/ustring.h>
+#include <iv/aero/aero.h>
 
 // from Regen test file
 static const std::string kURLRegExp = "http://((([a-zA-Z0-9]|[a-zA-Z0-9][-a-zA-Z0-9]*[a-zA-Z0-9])\\.)*([a-zA-Z][-a-zA-Z0-9]*[a-zA-Z0-9]|[a-zA-Z])\\.?|[0-9]+\\.[0-9]+\\.[0-9]+\\.[0-9]+)(:[0-9]*)?(/((?:[-_.!~*'()a-zA-Z0-9:@&=+$,]|%[0-9A-Fa-f][0-9A-Fa-f])*)(;([-_.!~*'()a-zA-Z0-9:@&=+$,]|%[0-9A-Fa-f][0-9A-Fa-f])*)*(/([-_.!~*'()a-zA-Z0-9:@&=+$,]|%[0-9A-Fa-f][0-9A-Fa-f])*(;([-_.!~*'()a-zA-Z0-9:@&=+$,]|%[0-9A-Fa-f][0-9A-Fa-f])*)*)*(\\?([-_.!~*'()a-zA-Z0-9;/?:@&=+$,]|%[0-9A-Fa-f][0-9A-Fa-f])*)?)?";
 
+// parses and compiles the pattern. the space is cleared before parsing
+inline iv::aero::Code* Compile(iv::core::Space* space,
+                               const std::string& pattern, int flags) {
+  space->Clear();
+  const std::u16string reg = iv::core::ToU16String(pattern);
+  iv::aero::Parser<iv::core::u16string_view> parser(space, reg, flags);
+  int error = 0;
+  iv::aero::ParsedData data = parser.ParsePattern(&error);
+  EXPECT_FALSE(error) << pattern;
+  iv::aero::Compiler compiler(flags);
+  return compiler.Compile(data);
+}
+
 #endif  // IV_TEST_LV5_AERO_H_
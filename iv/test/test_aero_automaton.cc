@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <memory>
+#include <string>
+#include <iv/alloc.h>
+#include <iv/ustring.h>
+#include <iv/unicode.h>
+#include <iv/aero/aero.h>
+#include "test_aero.h"
+namespace {
+
+bool IsAutomaton(const std::string& pattern) {
+  iv::core::Space space;
+  std::unique_ptr<iv::aero::Code> code(
+      Compile(&space, pattern, iv::aero::NONE));
+  return code->automaton();
+}
+
+}  // namespace anonymous
+
+TEST(AeroAutomatonCase, SelectionTest) {
+  // exponentially ambiguous
+  EXPECT_TRUE(IsAutomaton("(a+)+b"));
+  EXPECT_TRUE(IsAutomaton("(a|aa)*b"));
+  EXPECT_TRUE(IsAutomaton("(a|a)*"));
+  EXPECT_TRUE(IsAutomaton("^(\\w+\\s?)+$"));
+  EXPECT_TRUE(IsAutomaton("(?:(\\d{1,3})\\.?){3,}"));
+  EXPECT_TRUE(IsAutomaton("(?:ab|a)(?:bc|c|b)+"));
+  // backtracking is not exponential
+  EXPECT_FALSE(IsAutomaton("abc"));
+  EXPECT_FALSE(IsAutomaton("a*b+c?"));
+  EXPECT_FALSE(IsAutomaton("(a|b)c"));
+  EXPECT_FALSE(IsAutomaton("(a|b)*c"));
+  EXPECT_FALSE(IsAutomaton("(?:a|b){2,4}c"));
+  EXPECT_FALSE(IsAutomaton("(\\d{1,3}\\.){3}\\d{1,3}"));
+  EXPECT_FALSE(IsAutomaton("([^,]*,)+x"));
+  EXPECT_FALSE(IsAutomaton(kURLRegExp));
+  // not supported by automaton
+  EXPECT_FALSE(IsAutomaton("(a|aa)*\\1"));
+  EXPECT_FALSE(IsAutomaton("(?=a)(a|aa)*"));
+  EXPECT_FALSE(IsAutomaton("(?!a)(a|aa)*"));
+  EXPECT_FALSE(IsAutomaton("(a?)*"));
+  EXPECT_FALSE(IsAutomaton("(a|b?)+c"));
+  EXPECT_FALSE(IsAutomaton("(?:(a|aa)+b){1000}"));
+}
+
+#if defined(IV_ENABLE_JIT)
+// PikeVM and the backtracking JIT produce the same captures
+TEST(AeroAutomatonCase, CapturesTest) {
+  struct Case {
+    const char* pattern;
+    int flags;
+    std::vector<std::string> inputs;
+  };
+  const std::vector<Case> cases = {
+    { "(a+)+b", iv::aero::NONE, { "aaab", "xaab", "aaaa", "", "b" } },
+    { "(?:(a|ab)(c|bc|bcd))+(d*)", iv::aero::NONE,
+      { "abcd", "xabcdd", "abc", "abcdabc" } },
+    { "((a)|b|ab)*c", iv::aero::NONE, { "abac", "bac", "aabbc", "c" } },
+    { "(?:(a)|(b)|(ab))+", iv::aero::NONE, { "ab", "ba", "abab", "cab" } },
+    { "(a|b|ab)*?b", iv::aero::NONE, { "aab", "bbb", "aaa" } },
+    { "(?:(\\d{1,3})\\.?){3,}", iv::aero::NONE,
+      { "ip 192.168.0.1 end", "1.2.3", "1234.1.1.1", "99.999.9.99999" } },
+    { "^(\\w+\\s?)+$", iv::aero::NONE,
+      { "hello world", "hello world!", "a b c", "" } },
+    { "(?:x|xy|y){2,}?(z)", iv::aero::NONE, { "xyxyz", "xz", "yyyyyyz" } },
+    { "\\b(?:(foo|foobar|bar)\\s?)+\\b", iv::aero::NONE,
+      { "a foobar b", "foox foo", "foo foobar!" } },
+    { "^(?:(A)|b)+$", iv::aero::MULTILINE | iv::aero::IGNORE_CASE,
+      { "x\naBab\ny", "AB", "c" } },
+    { "([^,]+,?)+x", iv::aero::NONE, { "a,b,c,x", "a,b,c", ",,x" } },
+    { "(?:ab|a)(?:bc|c|b)+", iv::aero::NONE, { "abcbc", "abc", "acc" } },
+    { "(?:\\u3042|\\u3044|\\u3042\\u3044)+(\\u3046)", iv::aero::NONE,
+      { "\xE3\x81\x82\xE3\x81\x84\xE3\x81\x86" } }
+  };
+  iv::core::Space space;
+  iv::aero::VM vm;
+  for (const Case& c : cases) {
+    std::unique_ptr<iv::aero::Code> code(Compile(&space, c.pattern, c.flags));
+    ASSERT_TRUE(code->automaton()) << c.pattern;
+    const std::size_t size = code->captures() * 2;
+    for (const std::string& input : c.inputs) {
+      std::u16string str;
+      iv::core::unicode::UTF8ToUTF16(input.begin(), input.end(),
+                                     std::back_inserter(str));
+      for (int offset = 0; offset <= static_cast<int>(str.size()); ++offset) {
+        std::vector<int> expected(size, -1);
+        std::vector<int> result(size, -1);
+        const int expected_res = code->jit()->Execute(
+            &vm, code.get(), str, expected.data(), offset);
+        const int res = vm.Execute(code.get(), str, result.data(), offset);
+        EXPECT_EQ(expected_res, res) << c.pattern << " " << input;
+        if (expected_res == iv::aero::AERO_SUCCESS) {
+          EXPECT_EQ(expected, result) << c.pattern << " " << input;
+        }
+        if (str.size() < 128 && offset == 0) {
+          // 8bit subject
+          bool ascii = true;
+          for (char16_t ch : str) {
+            ascii = ascii && ch < 128;
+          }
+          if (ascii) {
+            std::vector<int> result8(size, -1);
+            EXPECT_EQ(res, vm.Execute(code.get(), input,
+                                      result8.data(), offset));
+            if (res == iv::aero::AERO_SUCCESS) {
+              EXPECT_EQ(result, result8) << c.pattern << " " << input;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+#endif
+
+TEST(AeroAutomatonCase, LinearTimeTest) {
+  iv::core::Space space;
+  iv::aero::VM vm;
+  std::vector<int> vec(100);
+  // exponential in backtracking engines
+  std::unique_ptr<iv::aero::Code> code(
+      Compile(&space, "^(a+)+$", iv::aero::NONE));
+  ASSERT_TRUE(code->automaton());
+  const std::string str = std::string(10000, 'a') + "!";
+  EXPECT_EQ(iv::aero::AERO_FAILURE,
+            vm.Execute(code.get(), str, vec.data(), 0));
+  EXPECT_EQ(iv::aero::AERO_SUCCESS,
+            vm.Execute(code.get(), std::string(10000, 'a'), vec.data(), 0));
+  EXPECT_EQ(0, vec[0]);
+  EXPECT_EQ(10000, vec[1]);
+  EXPECT_EQ(0, vec[2]);
+  EXPECT_EQ(10000, vec[3]);
+}
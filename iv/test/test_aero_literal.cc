@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <memory>
+#include <string>
+#include <iv/alloc.h>
+#include <iv/ustring.h>
+#include <iv/unicode.h>
+#include <iv/aero/aero.h>
+#include "test_aero.h"
+namespace {
+
+struct Literal {
+  std::string literal;
+  bool prefix;
+  bool pure;
+};
+
+Literal Check(const std::string& pattern, int flags = iv::aero::NONE) {
+  iv::core::Space space;
+  const std::u16string reg = iv::core::ToU16String(pattern);
+  iv::aero::Parser<iv::core::u16string_view> parser(&space, reg, flags);
+  int error = 0;
+  iv::aero::ParsedData data = parser.ParsePattern(&error);
+  EXPECT_FALSE(error) << pattern;
+  iv::aero::LiteralCheck check(flags & iv::aero::IGNORE_CASE);
+  check.Check(data.pattern());
+  const Literal result = {
+    std::string(check.literal().begin(), check.literal().end()),
+    check.IsPrefix(),
+    check.IsPure()
+  };
+  return result;
+}
+
+}  // namespace anonymous
+
+TEST(AeroLiteralCase, CheckTest) {
+  {
+    const Literal lit = Check("keyword");
+    EXPECT_EQ("keyword", lit.literal);
+    EXPECT_TRUE(lit.prefix);
+    EXPECT_TRUE(lit.pure);
+  }
+  {
+    const Literal lit = Check("(?:ab){3}");
+    EXPECT_EQ("ababab", lit.literal);
+    EXPECT_TRUE(lit.pure);
+  }
+  {
+    const Literal lit = Check("GET /(\\w+) HTTP");
+    EXPECT_EQ("GET /", lit.literal);
+    EXPECT_TRUE(lit.prefix);
+    EXPECT_FALSE(lit.pure);
+  }
+  {
+    const Literal lit = Check("^function\\s+(\\w+)");
+    EXPECT_EQ("function", lit.literal);
+    EXPECT_TRUE(lit.prefix);
+    EXPECT_FALSE(lit.pure);
+  }
+  {
+    // mandatory factor
+    const Literal lit = Check("\\d+-error-\\d+");
+    EXPECT_EQ("-error-", lit.literal);
+    EXPECT_FALSE(lit.prefix);
+  }
+  {
+    // longest factor
+    const Literal lit = Check("ab[0-9]+abcdef");
+    EXPECT_EQ("abcdef", lit.literal);
+    EXPECT_FALSE(lit.prefix);
+  }
+  {
+    // common prefix and suffix of alternatives
+    EXPECT_EQ("foo", Check("foobar|foobaz|foox").literal);
+    EXPECT_TRUE(Check("foobar|foobaz|foox").prefix);
+    EXPECT_EQ("tion", Check("(?:ac|mo)tion").literal);
+    EXPECT_EQ("abc", Check("abc(?:x|y)").literal);
+    EXPECT_EQ("", Check("abc|def").literal);
+  }
+  {
+    // optional terms are not required
+    EXPECT_EQ("ab", Check("ab(?:cd)?").literal);
+    EXPECT_EQ("ab", Check("ab(?:cd)*").literal);
+    EXPECT_EQ("abcd", Check("ab(?:cd)+").literal);
+    EXPECT_FALSE(Check("ab(?:cd)+").pure);
+  }
+  {
+    // lookahead is not a part of the match
+    EXPECT_EQ("ab", Check("(?=xyz)ab").literal);
+    EXPECT_EQ("ab", Check("a(?!x)b").literal);
+    EXPECT_FALSE(Check("a(?!x)b").pure);
+  }
+  EXPECT_EQ("", Check("([ab])\\1").literal);
+  EXPECT_EQ("", Check("keyword", iv::aero::IGNORE_CASE).literal);
+  EXPECT_FALSE(Check("keyword", iv::aero::IGNORE_CASE).pure);
+  EXPECT_FALSE(Check("(keyword)").pure);
+  EXPECT_EQ("", Check("").literal);
+}
+
+TEST(AeroLiteralCase, SelectionTest) {
+  iv::core::Space space;
+  {
+    std::unique_ptr<iv::aero::Code> code(
+        Compile(&space, "keyword", iv::aero::NONE));
+    EXPECT_TRUE(code->simple());
+  }
+  {
+    std::unique_ptr<iv::aero::Code> code(
+        Compile(&space, "keyword(\\d+)", iv::aero::NONE));
+    EXPECT_FALSE(code->simple());
+    ASSERT_TRUE(code->literal());
+    EXPECT_TRUE(code->literal()->IsPrefix());
+  }
+  {
+    // 1 char literal is handled by quick check
+    std::unique_ptr<iv::aero::Code> code(
+        Compile(&space, "a\\d+", iv::aero::NONE));
+    EXPECT_FALSE(code->literal());
+  }
+  {
+    // empty pattern
+    std::unique_ptr<iv::aero::Code> code(Compile(&space, "", iv::aero::NONE));
+    EXPECT_FALSE(code->simple());
+    EXPECT_FALSE(code->literal());
+  }
+}
+
+// VM with literal prefilter produces the same results to the matcher
+TEST(AeroLiteralCase, ExecuteTest) {
+  struct Case {
+    const char* pattern;
+    std::vector<std::string> inputs;
+  };
+  const std::vector<Case> cases = {
+    { "keyword",
+      { "keyword", "a keyword b keyword", "keywor", "", "kkeyword" } },
+    { "\\u3042\\u3044", {
+        "\xE3\x81\x82\xE3\x81\x84", "x\xE3\x81\x82\xE3\x81\x82\xE3\x81\x84" } },
+    { "\\xe9t\\xe9", { "\xC3\xA9t\xC3\xA9", "ete \xC3\xA9t\xC3\xA9" } },
+    { "GET /(\\w+) HTTP", {
+        "GET /index HTTP", "GET / HTTP GET /a HTTP", "GET /x" } },
+    { "\\d+-error-\\d+", { "12-error-34", "-error-1", "1-error-", "x" } },
+    { "(?:foo|bar)baz", { "foobaz", "barbaz", "bazbaz", "fobarbaz" } },
+    { "(a+)+keyword", { "aaakeyword", "keyword", "aaaa" } },
+    { "ab(?:cd)+ef", { "abcdcdef", "abef", "abcd abcdef" } },
+    { "^key(\\d)", { "key1", " key1" } },
+    { "\\bkey\\b", { "a keyk key", "keykey" } }
+  };
+  iv::core::Space space;
+  iv::aero::VM vm;
+  for (const Case& c : cases) {
+    std::unique_ptr<iv::aero::Code> code(
+        Compile(&space, c.pattern, iv::aero::NONE));
+    // same code without literal
+    iv::aero::Code plain(code->bytes(), iv::aero::NONE,
+                         code->captures(), code->counters(),
+                         code->filter(), code->IsQuickCheckOneChar(),
+                         nullptr, code->automaton());
+    const std::size_t size = code->captures() * 2;
+    for (const std::string& input : c.inputs) {
+      std::u16string str;
+      iv::core::unicode::UTF8ToUTF16(input.begin(), input.end(),
+                                     std::back_inserter(str));
+      bool latin1 = true;
+      for (char16_t ch : str) {
+        latin1 = latin1 && ch <= 0xFF;
+      }
+      const std::string str8(str.begin(), str.end());
+      for (int offset = 0; offset <= static_cast<int>(str.size()); ++offset) {
+        std::vector<int> expected(size, -1);
+        std::vector<int> result(size, -1);
+        const int expected_res =
+            vm.Execute(&plain, str, expected.data(), offset);
+        const int res = vm.Execute(code.get(), str, result.data(), offset);
+        EXPECT_EQ(expected_res, res) << c.pattern << " " << input;
+        if (expected_res == iv::aero::AERO_SUCCESS) {
+          EXPECT_EQ(expected, result) << c.pattern << " " << input;
+        }
+        if (latin1) {
+          std::vector<int> result8(size, -1);
+          EXPECT_EQ(res, vm.Execute(code.get(), str8, result8.data(), offset))
+              << c.pattern << " " << input;
+          if (res == iv::aero::AERO_SUCCESS) {
+            EXPECT_EQ(result, result8) << c.pattern << " " << input;
+          }
+        }
+      }
+    }
+  }
+}
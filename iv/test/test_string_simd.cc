@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <iv/platform.h>
+#include <iv/string_utils.h>
+#include <iv/string_view.h>
+#include <iv/xorshift.h>
+
+namespace {
+
+// needle is placed at various positions around vector boundaries
+std::u16string Haystack(std::size_t size, char16_t fill) {
+  std::u16string str(size, fill);
+  for (std::size_t i = 0; i < size; i += 7) {
+    str[i] = u'a' + (i % 3);
+  }
+  return str;
+}
+
+}  // namespace anonymous
+
+TEST(StringSIMDCase, FindCharTest) {
+  for (std::size_t size = 0; size < 80; ++size) {
+    const std::u16string str = Haystack(size, u'x');
+    const char16_t* begin = str.data();
+    const char16_t* end = str.data() + str.size();
+    for (char16_t ch : { u'a', u'b', u'c', u'x', u'z', char16_t(0xFFFF) }) {
+      const char16_t* expected = std::find(begin, end, ch);
+      const char16_t* result = iv::core::FindChar(begin, end, ch);
+      EXPECT_EQ(expected == end ? nullptr : expected, result);
+      const std::u16string::size_type last = str.rfind(ch);
+      const char16_t* rresult = iv::core::FindLastChar(begin, end, ch);
+      EXPECT_EQ(last == std::u16string::npos ? nullptr : begin + last,
+                rresult);
+    }
+  }
+}
+
+TEST(StringSIMDCase, FindCharAnyTest) {
+  static const char16_t kKeys[] = { u'"', u'\\', u'c' };
+  for (std::size_t size = 0; size < 80; ++size) {
+    std::u16string str = Haystack(size, u'x');
+    const char16_t* begin = str.data();
+    const char16_t* end = str.data() + str.size();
+    for (std::size_t keys = 0; keys <= 3; ++keys) {
+      EXPECT_EQ(std::find_first_of(begin, end, kKeys, kKeys + keys),
+                iv::core::FindCharAny(begin, end, kKeys, keys));
+    }
+    if (size) {
+      str[size - 1] = u'\\';
+      EXPECT_EQ(std::find_first_of(begin, end, kKeys, kKeys + 2),
+                iv::core::FindCharAny(begin, end, kKeys, 2));
+    }
+  }
+}
+
+TEST(StringSIMDCase, SearchTest) {
+  iv::core::Xor128 random;
+  for (std::size_t size = 0; size < 100; ++size) {
+    std::u16string str(size, u'a');
+    for (char16_t& ch : str) {
+      ch = u'a' + (random() % 3);
+    }
+    for (std::size_t len = 0; len <= 6 && len <= size + 1; ++len) {
+      for (std::size_t offset = 0; offset + len <= size; offset += 5) {
+        const std::u16string needle = str.substr(offset, len);
+        const char16_t* begin = str.data();
+        const char16_t* end = str.data() + str.size();
+        EXPECT_EQ(std::search(begin, end, needle.begin(), needle.end()),
+                  (iv::core::Search<const char16_t*, const char16_t*>(
+                      begin, end,
+                      needle.data(), needle.data() + needle.size())));
+        EXPECT_EQ(std::find_end(begin, end, needle.begin(), needle.end()),
+                  (iv::core::SearchLast<const char16_t*, const char16_t*>(
+                      begin, end,
+                      needle.data(), needle.data() + needle.size())));
+      }
+    }
+    const std::u16string missing(3, u'd');
+    EXPECT_EQ(str.data() + str.size(),
+              (iv::core::Search<const char16_t*, const char16_t*>(
+                  str.data(), str.data() + str.size(),
+                  missing.data(), missing.data() + missing.size())));
+  }
+}
+
+// 8bit needle in UTF-16 haystack
+TEST(StringSIMDCase, MixedSearchTest) {
+  iv::core::Xor128 random;
+  for (std::size_t size = 0; size < 100; ++size) {
+    std::u16string str(size, u'a');
+    for (char16_t& ch : str) {
+      ch = u'a' + (random() % 3);
+    }
+    if (size > 10) {
+      str[size / 2] = 0x100 + u'a';
+    }
+    for (std::size_t len = 0; len <= 6 && len <= size + 1; ++len) {
+      for (std::size_t offset = 0; offset + len <= size; offset += 5) {
+        const std::u16string wide = str.substr(offset, len);
+        const std::string needle(wide.begin(), wide.end());
+        const std::u16string widened(needle.begin(), needle.end());
+        const char16_t* begin = str.data();
+        const char16_t* end = str.data() + str.size();
+        EXPECT_EQ(std::search(begin, end, widened.begin(), widened.end()),
+                  (iv::core::Search<const char16_t*, const char*>(
+                      begin, end,
+                      needle.data(), needle.data() + needle.size())));
+        EXPECT_EQ(std::find_end(begin, end, widened.begin(), widened.end()),
+                  (iv::core::SearchLast<const char16_t*, const char*>(
+                      begin, end,
+                      needle.data(), needle.data() + needle.size())));
+      }
+    }
+  }
+  const std::u16string str = u"caf\u00E9 and caf\u00E9";
+  const std::string latin1 = "caf\xE9";
+  const char* first = latin1.data();
+  const char* last = latin1.data() + latin1.size();
+  const iv::core::u16string_view view(str);
+  EXPECT_EQ(0u, view.find(first, last));
+  EXPECT_EQ(9u, view.find(first, last, 1));
+  EXPECT_EQ(9u, view.rfind(first, last, str.size()));
+  EXPECT_EQ(0u, view.rfind(first, last, 8));
+}
+
+TEST(StringSIMDCase, StringViewTest) {
+  using iv::core::u16string_view;
+  const std::u16string str =
+      u"the quick brown fox jumps over the lazy dog, the end";
+  const u16string_view view(str);
+  EXPECT_EQ(str.find(u'q'), view.find(u'q'));
+  EXPECT_EQ(str.find(u'e', 3), view.find(u'e', 3));
+  EXPECT_EQ(u16string_view::npos, view.find(u'Z'));
+  EXPECT_EQ(str.rfind(u'o'), view.rfind(u'o'));
+  EXPECT_EQ(str.rfind(u'o', 20), view.rfind(u'o', 20));
+  EXPECT_EQ(str.find(u"the", 1), view.find(u16string_view(u"the"), 1));
+  EXPECT_EQ(str.rfind(u"the"), view.rfind(u16string_view(u"the")));
+  EXPECT_EQ(str.rfind(u"the", 40), view.rfind(u16string_view(u"the"), 40));
+  EXPECT_EQ(u16string_view::npos, view.rfind(u16string_view(u"cat")));
+}
+
+#if defined(IV_ENABLE_JIT)
+TEST(StringSIMDCase, KernelTest) {
+  const std::u16string str = Haystack(200, u'y') + u"needle" + u"yyy";
+  const char16_t* begin = str.data();
+  const char16_t* end = str.data() + str.size();
+  const std::u16string needle = u"needle";
+  const char16_t* expected = begin + 200;
+  EXPECT_EQ(expected, iv::core::simd::SearchSSE2(
+          begin, end, needle.data(), needle.data() + needle.size()));
+  EXPECT_EQ(expected, iv::core::simd::SearchLastSSE2(
+          begin, end, needle.data(), needle.data() + needle.size()));
+  EXPECT_EQ(expected, iv::core::simd::FindCharSSE2(begin, end, u'n'));
+  EXPECT_EQ(expected + 5, iv::core::simd::FindLastCharSSE2(begin, end, u'e'));
+  const std::string narrow = "needle";
+  EXPECT_EQ(expected, iv::core::simd::SearchSSE2(
+          begin, end, narrow.data(), narrow.data() + narrow.size()));
+  EXPECT_EQ(expected, iv::core::simd::SearchLastSSE2(
+          begin, end, narrow.data(), narrow.data() + narrow.size()));
+  if (iv::core::simd::IsAvailableAVX2()) {
+    EXPECT_EQ(expected, iv::core::simd::SearchAVX2(
+            begin, end, needle.data(), needle.data() + needle.size()));
+    EXPECT_EQ(expected, iv::core::simd::SearchLastAVX2(
+            begin, end, needle.data(), needle.data() + needle.size()));
+    EXPECT_EQ(expected, iv::core::simd::FindCharAVX2(begin, end, u'n'));
+    EXPECT_EQ(expected + 5,
+              iv::core::simd::FindLastCharAVX2(begin, end, u'e'));
+    EXPECT_EQ(expected, iv::core::simd::SearchAVX2(
+            begin, end, narrow.data(), narrow.data() + narrow.size()));
+    EXPECT_EQ(expected, iv::core::simd::SearchLastAVX2(
+            begin, end, narrow.data(), narrow.data() + narrow.size()));
+  }
+}
+#endif
@@ -16,7 +16,7 @@ class ThreadLocalPtr {
   }
 
   bool set(T* ptr) {
-    pthread_setspecific(key_, reinterpret_cast<const void*>(ptr));
+    return pthread_setspecific(key_, reinterpret_cast<const void*>(ptr)) == 0;
   }
 
   T* get() const {